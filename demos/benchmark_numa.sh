@@ -0,0 +1,55 @@
+#!/bin/sh
+
+USAGEMSG="usage: $(basename $0) triplexator single-stranded.fasta double-stranded.fasta [threads [repetitions]]
+
+Measures the throughput of the parallel duplex search (runtime mode 2) with
+and without NUMA replicas (-numa). Reports the best wall clock time of the
+given number of repetitions and the duplex nucleotides searched per second.
+Additional triplexator parameters can be passed in TRIPLEXATOR_OPTIONS.
+"
+
+[ $# -lt 3 ] && echo "$USAGEMSG" >&2 && exit 1
+TRIPLEXATOR=$1
+TFOS=$2
+DUPLEXES=$3
+THREADS=${4:-`nproc`}
+REPETITIONS=${5:-3}
+
+[ ! -f ${TRIPLEXATOR} ] && echo "ERROR: Triplexator executable does not exist" >&2 && exit 1
+[ ! -f ${TFOS} ] && echo "ERROR: ${TFOS} does not exist" >&2 && exit 1
+[ ! -f ${DUPLEXES} ] && echo "ERROR: ${DUPLEXES} does not exist" >&2 && exit 1
+
+NODES=`cat /sys/devices/system/node/online 2> /dev/null`
+[ -z "${NODES}" ] && NODES="unknown"
+echo "NUMA nodes: ${NODES}, threads: ${THREADS}, repetitions: ${REPETITIONS}"
+[ "${NODES}" = "0" ] && echo "WARNING: single NUMA node, -numa does not pin threads" >&2
+
+OUTDIR=`mktemp -d`
+NUCLEOTIDES=`grep -v ">" ${DUPLEXES} | tr -d ' \r\n' | wc -c`
+
+echo "mode	seconds	Mb/s"
+for MODE in default numa
+do
+	NUMA=""
+	[ "${MODE}" = "numa" ] && NUMA="--numa-replicas"
+	BEST=""
+	RUN=0
+	while [ ${RUN} -lt ${REPETITIONS} ]
+	do
+		START=`date +%s.%N`
+		$TRIPLEXATOR ${TRIPLEXATOR_OPTIONS} --runtime-mode 2 --processors ${THREADS} ${NUMA} -o benchmark_${MODE}.triplex -od ${OUTDIR} -ss ${TFOS} -ds ${DUPLEXES} > /dev/null 2>&1 || { echo "ERROR: triplexator failed, see ${OUTDIR}/benchmark_${MODE}.triplex.log" >&2; exit 1; }
+		END=`date +%s.%N`
+		BEST=`echo "${START} ${END} ${BEST}" | awk '{t = $2 - $1; if ($3 != "" && $3 < t) t = $3; printf "%.3f", t}'`
+		RUN=`expr ${RUN} + 1`
+	done
+	echo "${MODE}	${BEST}	`echo "${NUCLEOTIDES} ${BEST}" | awk '{printf "%.4g", $1 / $2 / 1000000}'`"
+done
+
+# both modes must report the same triplexes, runtime mode 2 outputs them in the order of completion
+sort ${OUTDIR}/benchmark_default.triplex > ${OUTDIR}/default.sorted
+sort ${OUTDIR}/benchmark_numa.triplex > ${OUTDIR}/numa.sorted
+if [ $(diff ${OUTDIR}/default.sorted ${OUTDIR}/numa.sorted | wc -l) -ne 0 ]
+then
+	echo "WARNING: the triplexes found with -numa differ" >&2
+fi
+rm -rf ${OUTDIR}
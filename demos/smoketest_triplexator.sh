@@ -172,6 +172,121 @@ else
 	echo "Test: minimum size triplex.........................FAILED"
 fi
 
+$TRIPLEXATOR --lower-length-bound 14 --error-rate 10 -o test_binary.tpxb -od ${DEMOS}/tests -of 3 -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+`dirname ${TRIPLEXATOR}`/triplexator-view -o ${DEMOS}/tests/test_binary.triplex ${DEMOS}/tests/test_binary.tpxb
+if [ -f ${DEMOS}/tests/test_binary.triplex ] && [ $(diff ${DEMOS}/reference/test_binary.triplex ${DEMOS}/tests/test_binary.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: binary output via triplexator-view...........OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: binary output via triplexator-view...........FAILED"
+fi
+
+gzip -c ${DEMOS}/single-stranded.fasta > ${DEMOS}/tests/single-stranded.fasta.gz
+gzip -c ${DEMOS}/double-stranded.fasta > ${DEMOS}/tests/double-stranded.fasta.gz
+$TRIPLEXATOR -o test_gzip_input.triplex -od ${DEMOS}/tests -of 1 --pretty-output -ss ${DEMOS}/tests/single-stranded.fasta.gz -ds ${DEMOS}/tests/double-stranded.fasta.gz
+if [ -f ${DEMOS}/tests/test_gzip_input.triplex ] && [ $(diff ${DEMOS}/reference/test_default.triplex ${DEMOS}/tests/test_gzip_input.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: gzip compressed input triplex................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: gzip compressed input triplex................FAILED"
+fi
+
+$TRIPLEXATOR --lower-length-bound 14 --error-rate 10 --top-k 2 -o test_top2.triplex -od ${DEMOS}/tests -of 0 -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+if [ -f ${DEMOS}/tests/test_top2.triplex ] && [ $(diff ${DEMOS}/reference/test_top2.triplex ${DEMOS}/tests/test_top2.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: two best triplexes per TFO...................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: two best triplexes per TFO...................FAILED"
+fi
+
+# interrupt the search once the output file exceeds 7 blocks of 512 bytes (third duplex sequence), then resume it
+rm -f ${DEMOS}/tests/tmp_test_resume.triplex* ${DEMOS}/tests/test_resume.triplex*
+( ulimit -f 7; $TRIPLEXATOR --lower-length-bound 14 --error-rate 20 --checkpoint -o test_resume.triplex -od ${DEMOS}/tests -of 1 --pretty-output -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta; true ) 2> /dev/null
+$TRIPLEXATOR --lower-length-bound 14 --error-rate 20 --resume -o test_resume.triplex -od ${DEMOS}/tests -of 1 --pretty-output -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+if [ -f ${DEMOS}/tests/test_resume.triplex ] && [ $(grep -c "skipping 2 finished duplex sequences" ${DEMOS}/tests/test_resume.triplex.log) -eq 1 ] && [ $(diff ${DEMOS}/reference/test_resume.triplex ${DEMOS}/tests/test_resume.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: resume an interrupted triplex search.........OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: resume an interrupted triplex search.........FAILED"
+fi
+
+# search the first six TFO sequences, then all of them: only the three new ones are searched, the others are taken from the partitions
+rm -rf ${DEMOS}/tests/test_incremental_partitions ${DEMOS}/tests/test_incremental.triplex*
+head -n 14 ${DEMOS}/single-stranded.fasta > ${DEMOS}/tests/single-stranded-first6.fasta
+$TRIPLEXATOR --incremental ${DEMOS}/tests/test_incremental_partitions -o test_incremental.triplex -od ${DEMOS}/tests -of 1 --pretty-output -ss ${DEMOS}/tests/single-stranded-first6.fasta -ds ${DEMOS}/double-stranded.fasta
+$TRIPLEXATOR --incremental ${DEMOS}/tests/test_incremental_partitions -o test_incremental.triplex -od ${DEMOS}/tests -of 1 --pretty-output -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+if [ -f ${DEMOS}/tests/test_incremental.triplex ] && [ $(grep -c "3 of 9 TFO sequences are new or changed" ${DEMOS}/tests/test_incremental.triplex.log) -eq 1 ] && [ $(diff ${DEMOS}/reference/test_incremental.triplex ${DEMOS}/tests/test_incremental.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: incremental triplex search...................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: incremental triplex search...................FAILED"
+fi
+
+$TRIPLEXATOR --lower-length-bound 20 --error-rate 0 --filtering-mode 1 -o test_qgram_dense.triplex -od ${DEMOS}/tests -of 0 -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+if [ -f ${DEMOS}/tests/test_qgram_dense.triplex ] && [ $(diff ${DEMOS}/reference/test_qgram_l20.triplex ${DEMOS}/tests/test_qgram_dense.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: q-gram dense triplex.........................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: q-gram dense triplex.........................FAILED"
+fi
+
+# looking up only the rarest q-gram per window of TTS q-grams must not lose triplexes
+$TRIPLEXATOR --lower-length-bound 20 --error-rate 0 --filtering-mode 1 --minimizer-window 4 -o test_qgram_minimizer.triplex -od ${DEMOS}/tests -of 0 -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+if [ -f ${DEMOS}/tests/test_qgram_minimizer.triplex ] && [ $(diff ${DEMOS}/reference/test_qgram_l20.triplex ${DEMOS}/tests/test_qgram_minimizer.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: q-gram minimizer triplex.....................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: q-gram minimizer triplex.....................FAILED"
+fi
+
+# overlapping windows on a diagonal are merged, each triplex is reported once as with brute force
+$TRIPLEXATOR --error-rate 10 --filtering-mode 1 --filter-repeats off -o test_seed_extension.triplex -od ${DEMOS}/tests -of 0 -ss ${DEMOS}/reference/test_seed_extension_ss.fasta -ds ${DEMOS}/reference/test_seed_extension_ds.fasta
+if [ -f ${DEMOS}/tests/test_seed_extension.triplex ] && [ $(diff ${DEMOS}/reference/test_seed_extension.triplex ${DEMOS}/tests/test_seed_extension.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: q-gram seed extension triplex................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: q-gram seed extension triplex................FAILED"
+fi
+
+# counting q-gram hits in diagonal buckets must find the same triplexes as collecting them per seed
+$TRIPLEXATOR --lower-length-bound 20 --error-rate 10 --filtering-mode 1 --swift-filter -o test_qgram_swift.triplex -od ${DEMOS}/tests -of 0 -ss ${DEMOS}/single-stranded.fasta -ds ${DEMOS}/double-stranded.fasta
+if [ -f ${DEMOS}/tests/test_qgram_swift.triplex ] && [ $(diff ${DEMOS}/reference/test_qgram_l20e10.triplex ${DEMOS}/tests/test_qgram_swift.triplex | wc -l) -eq 0 ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: q-gram SWIFT filter triplex..................OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: q-gram SWIFT filter triplex..................FAILED"
+fi
+
+# the server must refuse a socket path that is taken by a regular file and leave the file untouched
+echo "keep" > ${DEMOS}/tests/test_server_socket.txt
+$TRIPLEXATOR --server ${DEMOS}/tests/test_server_socket.txt -ds ${DEMOS}/double-stranded.fasta > /dev/null 2>&1
+if [ $? -ne 0 ] && [ "$(cat ${DEMOS}/tests/test_server_socket.txt)" = "keep" ]
+then
+	PASSED=`expr ${PASSED} + 1`
+	echo "Test: server refuses a taken socket path...........OK"
+else
+	FAILED=`expr ${FAILED} + 1`
+	echo "Test: server refuses a taken socket path...........FAILED"
+fi
+
 
 
 echo "============== FINISHED TESTING ====================="
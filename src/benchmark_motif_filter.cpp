@@ -0,0 +1,134 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor
+//       the names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+// Microbenchmark of the triplex filter per motif: runs process*Motif and
+// processDuplex on random purine/pyrimidine runs and reports the time and
+// the number of matches for each motif, with and without guanine rate.
+//
+// usage: benchmark_motif_filter [MEGABASES [REPETITIONS]]
+// ==========================================================================
+
+#define SEQAN_PROFILE					// enable time measuring
+
+#include <seqan/platform.h>
+#ifdef PLATFORM_WINDOWS
+	#define SEQAN_DEFAULT_TMPDIR "C:\\TEMP\\"
+#else
+	#define SEQAN_DEFAULT_TMPDIR "./"
+#endif
+
+#include <seqan/sequence.h>
+#include "triplex.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+using namespace seqan;
+
+//////////////////////////////////////////////////////////////////////////////
+// random sequence of purine and pyrimidine runs (1-40 nt) with 10% noise
+void _randomRuns(TTriplex &sequence, unsigned len)
+{
+	static char const purines[] = "GA";
+	static char const pyrimidines[] = "TC";
+	static char const any[] = "ACGT";
+
+	clear(sequence);
+	reserve(sequence, len, Exact());
+	bool purine = true;
+	while (length(sequence) < len){
+		unsigned run = 1 + rand() % 40;
+		for (unsigned i=0; i<run && length(sequence) < len; ++i){
+			if (rand() % 10 == 0)
+				appendValue(sequence, any[rand() % 4]);
+			else
+				appendValue(sequence, purine ? purines[rand() % 2] : pyrimidines[rand() % 2]);
+		}
+		purine = !purine;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// the options of: -l 16 -e 10 -L 30 -g <minGuanine>
+void _benchmarkOptions(Options &options, double minGuanine)
+{
+	options.minLength = 16;
+	options.maxLength = 30;
+	options.applyMaximumLengthConstraint = true;
+	options.errorRate = 0.1;
+	options.minGuanineRate = minGuanine;
+	options.minGuanine = static_cast<unsigned>(ceil(options.minLength * options.minGuanineRate));
+	options.tolError = static_cast<unsigned>(floor(options.errorRate * options.minLength));
+	options.maximalError = static_cast<int>(floor(options.errorRate * options.maxLength));
+}
+
+int main(int argc, char const ** argv)
+{
+	unsigned megabases = (argc > 1) ? atoi(argv[1]) : 4;
+	unsigned repetitions = (argc > 2) ? atoi(argv[2]) : 1;
+
+	srand(42);
+	TTriplex sequence;
+	_randomRuns(sequence, megabases * 1000000);
+
+	::std::cout << "motif\t-g\tseconds\tmatches" << ::std::endl;
+	double const guanineRates[] = {0.1, 0.0};
+	for (unsigned g=0; g<2; ++g){
+		Options options;
+		_benchmarkOptions(options, guanineRates[g]);
+
+		for (unsigned motif=0; motif<4; ++motif){
+			unsigned matches = 0;
+			SEQAN_PROTIMESTART(motif_time);
+			for (unsigned r=0; r<repetitions; ++r){
+				TTriplex tmp = sequence;
+				if (motif == 3){
+					TTargetSet ttsSet;
+					matches = processDuplex(ttsSet, tmp, 0, true, true, options);
+				} else {
+					TMotifSet tfoSet;
+					if (motif == 0)
+						matches = processTCMotif(tfoSet, tmp, 0u, true, options);
+					else if (motif == 1)
+						matches = processGAMotif(tfoSet, tmp, 0u, true, options);
+					else
+						matches = processGTMotif(tfoSet, tmp, 0u, TRIPLEX_ORIENTATION_BOTH, true, options);
+				}
+			}
+			char const *names[] = {"TC", "GA", "GT", "TTS"};
+			::std::cout << names[motif] << "\t" << (int)(100 * guanineRates[g]) << "\t" << ::std::setprecision(3) << SEQAN_PROTIMEDIFF(motif_time) / repetitions << "\t" << matches << ::std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,156 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor
+//       the names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+// Microbenchmark of the triplex output: searches random TFOs in a random 
+// duplex once and then formats the matches repeatedly with printTriplexEntry
+// in output format 0, 1 and for the best triplexes per TFO (-tk 3). The 
+// matches are passed all at once (a long duplex sequence) and one per call 
+// (many short sequences or regions). Reports the time per repetition and 
+// the number of matches formatted per second.
+//
+// usage: benchmark_output_format [REPETITIONS [DUPLEX_KILOBASES]]
+// ==========================================================================
+
+#define SEQAN_PROFILE					// enable time measuring
+
+#include <seqan/platform.h>
+#ifdef PLATFORM_WINDOWS
+	#define SEQAN_DEFAULT_TMPDIR "C:\\TEMP\\"
+#else
+	#define SEQAN_DEFAULT_TMPDIR "./"
+#endif
+
+#include <seqan/sequence.h>
+#include "triplex.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <vector>
+
+using namespace seqan;
+
+//////////////////////////////////////////////////////////////////////////////
+// random sequence of purine and pyrimidine runs (1-40 nt) with 10% noise
+void _randomRuns(TTriplex &sequence, unsigned len)
+{
+	static char const purines[] = "GA";
+	static char const pyrimidines[] = "TC";
+	static char const any[] = "ACGT";
+
+	clear(sequence);
+	reserve(sequence, len, Exact());
+	bool purine = true;
+	while (length(sequence) < len){
+		unsigned run = 1 + rand() % 40;
+		for (unsigned i=0; i<run && length(sequence) < len; ++i){
+			if (rand() % 10 == 0)
+				appendValue(sequence, any[rand() % 4]);
+			else
+				appendValue(sequence, purine ? purines[rand() % 2] : pyrimidines[rand() % 2]);
+		}
+		purine = !purine;
+	}
+}
+
+int main(int argc, char const ** argv)
+{
+	typedef ::std::list<TMatch>							TMatches;
+	typedef Pair<unsigned, unsigned>					TPotKey;
+	typedef TriplexPotential<TPotKey>					TPotPair;
+	typedef PotentialTable<TPotKey, TPotPair>			TPotentials;
+	
+	unsigned repetitions = (argc > 1) ? atoi(argv[1]) : 20;
+	unsigned kilobases = (argc > 2) ? atoi(argv[2]) : 100;
+	unsigned numOligos = 50;
+	
+	// options of: -l 16 -e 10
+	Options options;
+	options.minLength = 16;
+	options.errorRate = 0.1;
+	options.tolError = static_cast<unsigned>(floor(options.errorRate * options.minLength));
+	options.maximalError = -1;
+	
+	// the motifs refer to the oligos, which are not moved once they are created
+	srand(42);
+	TTriplexSet oligos;
+	StringSet<CharString> tfoNames;
+	resize(oligos, numOligos);
+	TMotifSet tfoMotifSet;
+	for (unsigned i=0; i<numOligos; ++i){
+		_randomRuns(oligos[i], 200);
+		::std::ostringstream name;
+		name << "tfo" << i;
+		appendValue(tfoNames, CharString(name.str()));
+		processTCMotif(tfoMotifSet, oligos[i], i, true, options);
+		processGAMotif(tfoMotifSet, oligos[i], i, true, options);
+		processGTMotif(tfoMotifSet, oligos[i], i, TRIPLEX_ORIENTATION_BOTH, true, options);
+	}
+	TDuplex duplex;
+	_randomRuns(duplex, kilobases * 1000);
+	CharString duplexName = "duplex";
+	
+	TMatches matches;
+	TPotentials potentials;
+	_detectTriplex(matches, potentials, tfoMotifSet, duplex, (TId) 0, options, BruteForce());
+	
+	::std::vector<TMatches> singleMatches;
+	for (TMatches::iterator it = matches.begin(); it != matches.end(); ++it)
+		singleMatches.push_back(TMatches(1, *it));
+	
+	::std::ofstream sink("/dev/null");
+	::std::cout << "matches: " << length(matches) << ::std::endl;
+	::std::cout << "output\tper call\tseconds\tmatches/s" << ::std::endl;
+	char const *names[] = {"-of 0", "-of 1", "-tk 3"};
+	for (unsigned mode=0; mode<3; ++mode){
+		options.outputFormat = (mode == 1) ? FORMAT_TRIPLEX : FORMAT_BED;
+		options.topK = (mode == 2) ? 3 : 0;
+		for (unsigned single=0; single<2; ++single){
+			SEQAN_PROTIMESTART(format_time);
+			for (unsigned r=0; r<repetitions; ++r){
+				if (options.topK > 0)
+					resetTopMatches(options.topMatches, numOligos, options.topK);
+				if (single){
+					for (unsigned i=0; i<singleMatches.size(); ++i)
+						printTriplexEntry(singleMatches[i], duplexName, duplex, tfoMotifSet, tfoNames, sink, options);
+				} else
+					printTriplexEntry(matches, duplexName, duplex, tfoMotifSet, tfoNames, sink, options);
+			}
+			double seconds = SEQAN_PROTIMEDIFF(format_time) / repetitions;
+			::std::cout << names[mode] << "\t" << (single ? "1" : "all") << "\t" << ::std::setprecision(3) << seconds << "\t" << (unsigned) (length(matches) / seconds) << ::std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,281 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_BGZF_STREAM_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_BGZF_STREAM_H
+
+#if SEQAN_HAS_ZLIB
+
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <seqan/stream.h>
+
+#include "helper.h"
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// BGZF output
+// ============================================================================
+//
+// Writes blocked gzip (BGZF) compressed output as used by samtools/tabix. 
+// The output is a valid gzip file that can be indexed with tabix when the 
+// records are sorted by position. Uncompressed data is collected in a batch
+// of blocks, the blocks of a batch are compressed in parallel and written in
+// order. Compression of a single block reuses the BGZF code bundled with SeqAn.
+	
+	class BgzfStreamBuf : public ::std::streambuf
+	{
+	public:
+		// uncompressed payload per block, small enough such that even 
+		// incompressible data fits into a single BGZF block
+		static const int BLOCK_SIZE = 0xff00;
+		// number of blocks per thread that make up a batch
+		static const int BLOCKS_PER_THREAD = 4;
+		
+		BgzfStreamBuf():
+		_file(NULL), _ownsFile(false), _threads(1), _blocks(NULL), _compressed(NULL), _numBlocks(0), _current(0), _failed(false) {}
+		
+		~BgzfStreamBuf()
+		{
+			close();
+		}
+		
+		// open file for writing, using the given number of compression threads
+		bool open(char const *fileName, int threads)
+		{
+			close();
+			_file = ::std::fopen(fileName, "wb");
+			if (_file == NULL)
+				return false;
+			_ownsFile = true;
+			_init(threads);
+			return true;
+		}
+		
+		// write to an already open file (e.g. stdout) that is not closed afterwards
+		bool attach(::std::FILE *file, int threads)
+		{
+			close();
+			_file = file;
+			_ownsFile = false;
+			_init(threads);
+			return _file != NULL;
+		}
+		
+		bool is_open() const
+		{
+			return _file != NULL;
+		}
+		
+		// flush all data, append the BGZF end-of-file marker and close the file
+		bool close()
+		{
+			if (_file == NULL)
+				return true;
+			
+			bool ok = _flushBatch();
+			if (ok){
+				// an empty block marks the end of a BGZF file
+				int length = _bgzfDeflateBlock(_blocks[0], 0);
+				ok = length > 0 && ::std::fwrite(&_blocks[0]._compressedBlock[0], 1, length, _file) == (size_t) length;
+			}
+			if (_ownsFile)
+				ok = (::std::fclose(_file) == 0) && ok;
+			else
+				ok = (::std::fflush(_file) == 0) && ok;
+			
+			_file = NULL;
+			delete [] _blocks;
+			delete [] _compressed;
+			_blocks = NULL;
+			_compressed = NULL;
+			setp(NULL, NULL);
+			return ok && !_failed;
+		}
+		
+	protected:
+		// current block is full, move on to the next one
+		virtual int_type overflow(int_type c)
+		{
+			if (_file == NULL || _failed)
+				return traits_type::eof();
+			
+			_blockLength(_current) = BLOCK_SIZE;
+			if (++_current == _numBlocks && !_flushBatch())
+				return traits_type::eof();
+			_setPutArea();
+			
+			if (!traits_type::eq_int_type(c, traits_type::eof())){
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+		
+		// flushing the stream (e.g. by ::std::endl) must not end a block, otherwise
+		// every line would be compressed on its own; data is written once a batch
+		// is complete or the stream is closed
+		virtual int sync()
+		{
+			return _failed ? -1 : 0;
+		}
+		
+	private:
+		typedef Stream<Bgzf>	TBlock;
+		
+		::std::FILE	*_file;			// output file
+		bool		_ownsFile;		// whether the file is closed by this buffer
+		int			_threads;		// number of compression threads
+		TBlock		*_blocks;		// uncompressed/compressed buffers per block of a batch
+		int			*_compressed;	// compressed length per block of a batch
+		int			_numBlocks;		// number of blocks per batch
+		int			_current;		// block currently written to
+		bool		_failed;		// compression or writing failed
+		
+		// not copyable
+		BgzfStreamBuf(BgzfStreamBuf const &);
+		BgzfStreamBuf & operator=(BgzfStreamBuf const &);
+		
+		// the BGZF stream keeps the fill level of its uncompressed buffer in _blockOffset
+		__int32 & _blockLength(int block)
+		{
+			return _blocks[block]._blockOffset;
+		}
+		
+		void _init(int threads)
+		{
+			_threads = (threads < 1) ? 1 : threads;
+			_numBlocks = _threads * BLOCKS_PER_THREAD;
+			_blocks = new TBlock[_numBlocks];
+			_compressed = new int[_numBlocks];
+			for (int i=0; i<_numBlocks; ++i){
+				resize(_blocks[i]._uncompressedBlock, 64 * 1024, Exact());
+				resize(_blocks[i]._compressedBlock, 64 * 1024, Exact());
+				_blockLength(i) = 0;
+			}
+			_current = 0;
+			_failed = false;
+			_setPutArea();
+		}
+		
+		void _setPutArea()
+		{
+			char *block = &_blocks[_current]._uncompressedBlock[0];
+			setp(block, block + BLOCK_SIZE);
+		}
+		
+		// compress all blocks collected so far in parallel and write them in order
+		bool _flushBatch()
+		{
+			if (_failed)
+				return false;
+			
+			int blocks = _current;
+			if (_current < _numBlocks){
+				_blockLength(_current) = pptr() - pbase();
+				if (_blockLength(_current) > 0)
+					++blocks;
+			}
+			
+			SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(static) num_threads(_threads) if(_threads > 1 && blocks > 1))
+			for (int i=0; i<blocks; ++i){
+				_compressed[i] = _bgzfDeflateBlock(_blocks[i], _blockLength(i));
+			}
+			
+			for (int i=0; i<blocks && !_failed; ++i){
+				if (_compressed[i] < 0 || ::std::fwrite(&_blocks[i]._compressedBlock[0], 1, _compressed[i], _file) != (size_t) _compressed[i])
+					_failed = true;
+				// rare case: data that did not fit into the compressed block was moved to the front
+				while (!_failed && _blockLength(i) > 0){
+					int length = _bgzfDeflateBlock(_blocks[i], _blockLength(i));
+					if (length < 0 || ::std::fwrite(&_blocks[i]._compressedBlock[0], 1, length, _file) != (size_t) length)
+						_failed = true;
+				}
+			}
+			
+			for (int i=0; i<_numBlocks; ++i)
+				_blockLength(i) = 0;
+			_current = 0;
+			_setPutArea();
+			return !_failed;
+		}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// output stream writing BGZF compressed data
+	class BgzfOutputStream : public ::std::ostream
+	{
+	public:
+		BgzfOutputStream():
+		::std::ostream(NULL)
+		{
+			rdbuf(&_buffer);
+		}
+		
+		void open(char const *fileName, int threads)
+		{
+			if (!_buffer.open(fileName, threads))
+				setstate(::std::ios_base::failbit);
+		}
+		
+		void attach(::std::FILE *file, int threads)
+		{
+			if (!_buffer.attach(file, threads))
+				setstate(::std::ios_base::failbit);
+		}
+		
+		bool is_open() const
+		{
+			return _buffer.is_open();
+		}
+		
+		void close()
+		{
+			if (!_buffer.close())
+				setstate(::std::ios_base::failbit);
+		}
+		
+	private:
+		BgzfStreamBuf _buffer;
+	};
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif  // #if SEQAN_HAS_ZLIB
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_BGZF_STREAM_H
@@ -0,0 +1,212 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_CHECKPOINT_JOURNAL_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_CHECKPOINT_JOURNAL_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <set>
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+#include <sys/stat.h>
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Checkpoint journal
+// ============================================================================
+//
+// Records the duplex sequences whose results have been written completely.
+// The first line holds a fingerprint of the TFO motifs and search parameters
+// and the size of the output and summary files after their headers. Every
+// finished duplex sequence appends a line with its number, its name, and the
+// size of both files afterwards:
+//
+//   # triplexator journal <TAB> fingerprint <TAB> output size <TAB> summary size
+//   sequence number <TAB> sequence name <TAB> output size <TAB> summary size
+//
+// The results of a sequence are flushed before its line is written, hence 
+// everything beyond the sizes of the last complete line belongs to sequences 
+// in progress and is cut off when resuming. A line that was not terminated 
+// is ignored.
+	
+	struct CheckpointJournal
+	{
+		::std::string		fileName;		// journal file
+		::std::string		fingerprint;	// TFO motifs and search parameters
+		::std::set<__int64>	finished;		// duplex sequences with complete results
+		__int64				outputSize;		// output file size after the last finished sequence
+		__int64				summarySize;	// summary file size after the last finished sequence
+		bool				resumed;		// continue the files of a previous run
+		::std::ofstream		file;
+		
+		CheckpointJournal():
+		outputSize(0), summarySize(0), resumed(false) {}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// 64 bit FNV-1a hash used for the fingerprint
+	inline __uint64
+	_journalHash(::std::string const &text)
+	{
+		__uint64 hash = 14695981039346656037ull;
+		for (unsigned i=0; i<text.size(); ++i){
+			hash ^= (unsigned char) text[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// size and modification time of a file, which identify a version of its content
+	inline ::std::string
+	_fileStamp(char const *fileName)
+	{
+		::std::ostringstream stamp;
+		struct stat status;
+		if (::stat(fileName, &status) == 0)
+			stamp << (__int64) status.st_size << ',' << (__int64) status.st_mtime;
+		return stamp.str();
+	}
+	
+	inline void
+	setJournalFingerprint(CheckpointJournal &journal, ::std::string const &text)
+	{
+		::std::ostringstream fingerprint;
+		fingerprint << ::std::hex << _journalHash(text);
+		journal.fingerprint = fingerprint.str();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the journal of a previous run, fails if it is missing, damaged or 
+	// has been written for other TFO motifs or parameters
+	inline bool
+	readCheckpointJournal(CheckpointJournal &journal)
+	{
+		journal.finished.clear();
+		::std::ifstream file(journal.fileName.c_str());
+		if (!file.is_open())
+			return false;
+		
+		::std::string line;
+		bool header = true;
+		while (::std::getline(file, line) && !file.eof()){
+			::std::istringstream fields(line);
+			__int64 outputSize = -1, summarySize = -1;
+			if (header){
+				::std::string tag, fingerprint;
+				if (!::std::getline(fields, tag, '\t') || tag != "# triplexator journal")
+					return false;
+				if (!(fields >> fingerprint >> outputSize >> summarySize) || fingerprint != journal.fingerprint)
+					return false;
+				header = false;
+			} else {
+				__int64 seqNo = -1;
+				::std::string name;
+				if (!(fields >> seqNo >> name >> outputSize >> summarySize))
+					break;
+				journal.finished.insert(seqNo);
+			}
+			journal.outputSize = outputSize;
+			journal.summarySize = summarySize;
+		}
+		return !header;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// start a new journal or continue the journal of a previous run
+	inline bool
+	openCheckpointJournal(CheckpointJournal &journal, __int64 outputSize, __int64 summarySize)
+	{
+		if (journal.resumed){
+			journal.file.open(journal.fileName.c_str(), ::std::ios_base::out | ::std::ios_base::app);
+		} else {
+			journal.finished.clear();
+			journal.file.open(journal.fileName.c_str(), ::std::ios_base::out | ::std::ios_base::trunc);
+			journal.file << "# triplexator journal\t" << journal.fingerprint << '\t' << outputSize << '\t' << summarySize << ::std::endl;
+		}
+		return journal.file.is_open() && journal.file.good();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// record a duplex sequence whose results have been flushed
+	inline void
+	recordCheckpoint(CheckpointJournal &journal, __int64 seqNo, CharString const &name, __int64 outputSize, __int64 summarySize)
+	{
+		journal.file << seqNo << '\t' << name << '\t' << outputSize << '\t' << summarySize << ::std::endl;
+	}
+	
+	inline bool
+	isCheckpointed(CheckpointJournal const &journal, __int64 seqNo)
+	{
+		return journal.finished.find(seqNo) != journal.finished.end();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// the run is complete, the journal is no longer needed
+	inline void
+	removeCheckpointJournal(CheckpointJournal &journal)
+	{
+		if (journal.file.is_open())
+			journal.file.close();
+		::std::remove(journal.fileName.c_str());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// cut off a file after the given number of bytes
+	inline bool
+	_truncateFile(char const *fileName, __int64 size)
+	{
+#ifndef PLATFORM_WINDOWS
+		return ::truncate(fileName, (off_t) size) == 0;
+#else
+		(void)fileName;
+		(void)size;
+		return false;
+#endif
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_CHECKPOINT_JOURNAL_H
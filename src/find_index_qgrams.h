@@ -35,9 +35,13 @@
 #ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_INDEX_QGRAMS_FIND_H
 #define FBUSKE_APPS_TRIPLEXATOR_HEADER_INDEX_QGRAMS_FIND_H
 
+#include <algorithm>
+#include <vector>
 #include <seqan/find.h>
 #include <seqan/index.h>
 
+#include "helper.h"
+
 namespace SEQAN_NAMESPACE_MAIN
 {
 	
@@ -51,6 +55,116 @@ namespace SEQAN_NAMESPACE_MAIN
 //		unsigned	length;				// length of the hit
 	};
 		
+	//////////////////////////////////////////////////////////////////////////////
+	// Low complexity regions
+	
+	template <typename TRepeat>
+	struct RepeatBeginLess_ : public ::std::binary_function<TRepeat, TRepeat, bool>
+	{
+		inline bool operator() (TRepeat const &a, TRepeat const &b) const {
+			return a.beginPosition < b.beginPosition || (a.beginPosition == b.beginPosition && a.endPosition > b.endPosition);
+		}
+	};
+	
+	/**
+	 * sort repeats by begin position and merge overlapping ones in place,
+	 * such that the finder can skip them in a single left-to-right sweep
+	 */
+	template <typename TRepeatString>
+	inline void _mergeRepeats(TRepeatString &repeats)
+	{
+		typedef typename Value<TRepeatString>::Type					TRepeat;
+		typedef typename Iterator<TRepeatString, Standard>::Type	TIter;
+		
+		if (length(repeats) < 2) return;
+		
+		::std::sort(begin(repeats, Standard()), end(repeats, Standard()), RepeatBeginLess_<TRepeat>());
+		TIter itOut = begin(repeats, Standard());
+		TIter it = itOut;
+		TIter itEnd = end(repeats, Standard());
+		for (++it; it != itEnd; ++it){
+			if ((*it).beginPosition <= (*itOut).endPosition){
+				if ((*it).endPosition > (*itOut).endPosition)
+					(*itOut).endPosition = (*it).endPosition;
+			} else {
+				*(++itOut) = *it;
+			}
+		}
+		resize(repeats, (itOut - begin(repeats, Standard())) + 1);
+	}
+	
+	/**
+	 * find the low complexity regions of a sequence once, such that the same 
+	 * intervals can be used for masking and by the q-gram finder.
+	 * Sequences longer than tileSize are split into overlapping tiles that are 
+	 * searched in parallel (tileSize = 0 searches the sequence as a whole).
+	 */
+	template <typename TRepeatString, typename TSequence, typename TRepeatSize, typename TPeriodSize, typename TTileSize>
+	inline void findLowComplexityRegions(TRepeatString		&repeats, 
+										 TSequence const	&seq, 
+										 TRepeatSize		minRepeatLen, 
+										 TPeriodSize		maxPeriod, 
+										 TTileSize			tileSize
+										 ){
+		typedef typename Value<TRepeatString>::Type			TRepeat;
+		typedef typename Value<TRepeat>::Type				TPos;
+		typedef String<typename Value<TSequence>::Type>		TTile;
+		
+		clear(repeats);
+		__int64 seqLength = length(seq);
+		__int64 tileLength = (__int64) tileSize;
+		if (tileLength <= 0 || seqLength <= tileLength){
+			findRepeats(repeats, seq, minRepeatLen, maxPeriod);
+			_mergeRepeats(repeats);
+			return;
+		}
+		
+		// neighbouring tiles overlap such that a low complexity region spanning 
+		// a tile border is reported by at least one of the adjacent tiles
+		__int64 overlap = (__int64) minRepeatLen + (__int64) maxPeriod;
+		int tiles = (int)((seqLength + tileLength - 1) / tileLength);
+		::std::vector<TRepeatString> tileRepeats(tiles);
+		
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic))
+		for (int t=0; t<tiles; ++t){
+			__int64 tileBegin = t * tileLength;
+			__int64 tileEnd = min(tileBegin + tileLength + overlap, seqLength);
+			TTile tile = infix(seq, tileBegin, tileEnd);
+			findRepeats(tileRepeats[t], tile, minRepeatLen, maxPeriod);
+			for (unsigned i=0; i<length(tileRepeats[t]); ++i){
+				tileRepeats[t][i].beginPosition += (TPos) tileBegin;
+				tileRepeats[t][i].endPosition += (TPos) tileBegin;
+			}
+		}
+		
+		for (int t=0; t<tiles; ++t)
+			append(repeats, tileRepeats[t]);
+		_mergeRepeats(repeats);
+	}
+	
+	/**
+	 * mask low complexity regions in place (no reallocation of the host)
+	 */
+	template <typename TSequence, typename TRepeatString, typename TMaskChar>
+	inline void maskLowComplexityRegions(TSequence				&seq, 
+										 TRepeatString const	&repeats, 
+										 TMaskChar				maskChar
+										 ){
+		typedef typename Iterator<TRepeatString const, Standard>::Type	TRepeatIter;
+		typedef typename Iterator<TSequence, Standard>::Type			TSeqIter;
+		
+		typename Value<TSequence>::Type mask = maskChar;
+		__int64 seqLength = length(seq);
+		TRepeatIter rit = begin(repeats, Standard());
+		TRepeatIter ritEnd = end(repeats, Standard());
+		for (; rit != ritEnd; ++rit){
+			TSeqIter it = begin(seq, Standard()) + (*rit).beginPosition;
+			TSeqIter itEnd = begin(seq, Standard()) + min((__int64)(*rit).endPosition, seqLength);
+			for (; it < itEnd; ++it)
+				*it = mask;
+		}
+	}
+	
 	/**
 	 .Tag.Index Find Algorithm
 	 ..tag.QGram_FIND_Lookup:q-gram search.
@@ -80,6 +194,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef Repeat<TSAValue, unsigned>						TRepeat;
 		typedef String<TRepeat>									TRepeatString;
 		typedef typename Iterator<TRepeatString, Rooted>::Type	TRepeatIterator;
+		typedef Pair<THstkPos, typename Value<TShape>::Type>	TSample;
+		typedef String<TSample>									TSampleString;
 		
 		TIterator		data_iterator;
 		TIterator		haystackEnd;
@@ -91,6 +207,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		TRepeatString	data_repeats;
 		TRepeatIterator	curRepeat, endRepeat;
 		TShape			shape;	// shape needs to be saved in Finder since it contains the next hashvalue and pattern needs to stay const 
+		TSampleString	samples;	// sampled q-gram positions and hash values of the current non-repeat range
+		unsigned		curSample;
 		bool			hasShape;
 		int				maxHitThreshold;
 		
@@ -122,7 +240,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		hasShape(false),
 		maxHitThreshold(0)
 		{
-			findRepeats(data_repeats, haystack, minRepeatLen, maxPeriod);
+			findLowComplexityRegions(data_repeats, haystack, minRepeatLen, maxPeriod, 0);
 		}
 		
 		template <typename TRepeatSize, typename TPeriodSize>
@@ -132,7 +250,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		hasShape(false),
 		maxHitThreshold(_maxHitThreshold)
 		{
-			findRepeats(data_repeats, haystack, minRepeatLen, maxPeriod);
+			findLowComplexityRegions(data_repeats, haystack, minRepeatLen, maxPeriod, 0);
 		}
 		
 		Finder(TIterator &iter):
@@ -156,8 +274,10 @@ namespace SEQAN_NAMESPACE_MAIN
 		dotPos(orig.dotPos),
 		dotPos2(orig.dotPos2),
 		data_repeats(orig.data_repeats),
-		hasShape(orig.hasShape),
 		shape(orig.shape),
+		samples(orig.samples),
+		curSample(orig.curSample),
+		hasShape(orig.hasShape),
 		maxHitThreshold(orig.maxHitThreshold)
 		{
 			curHit = begin(hits, Rooted()) + (orig.curHit - begin(orig.hits, Rooted()));
@@ -192,6 +312,8 @@ namespace SEQAN_NAMESPACE_MAIN
             endRepeat = end(data_repeats, Rooted());
 			hasShape = orig.hasShape;
 			shape = orig.shape;
+			samples = orig.samples;
+			curSample = orig.curSample;
 			maxHitThreshold = orig.maxHitThreshold;
             return *this;
         }
@@ -212,11 +334,12 @@ namespace SEQAN_NAMESPACE_MAIN
 		
 		Holder<TIndex>	data_host;
 		TShape	const	shape;	// cannot be used to compute hash (not thread save) For reference purpose only
+		unsigned		window;	// number of consecutive haystack q-grams sampled by a single lookup (1 = all q-grams)
 
-		Pattern(TIndex &_index, TShape const &shape): data_host(_index), shape(shape) {
+		Pattern(TIndex &_index, TShape const &shape, unsigned _window = 1): data_host(_index), shape(shape), window(_window) {
 			indexRequire(_index, QGramSADir());
 		}
-		Pattern(TIndex const &_index, TShape const &shape): data_host(_index), shape(shape){
+		Pattern(TIndex const &_index, TShape const &shape, unsigned _window = 1): data_host(_index), shape(shape), window(_window){
 			indexRequire(_index, QGramSADir());
 		}
 		
@@ -258,6 +381,36 @@ namespace SEQAN_NAMESPACE_MAIN
 		- errors * weight(indexShape(host(pattern)));
 	}
 	
+	/**
+	 * minimum number of q-gram hits on a diagonal within a window of minLength
+	 * that an ungapped match with errorRate yields (q-gram lemma w+1-(k+1)q).
+	 * If only one q-gram out of every <window> consecutive haystack q-grams is 
+	 * looked up, each of the k+1 error-free blocks of a match of length b 
+	 * contains at least floor((b-q+1)/window) sampled q-grams, which sums up 
+	 * to at least (w-k-(k+1)(q+window-2))/window for the whole match.
+	 */
+	template <typename TIndex, typename TShape, typename TSpec, typename TError, typename TSize>
+	inline __int64
+	_minSeedsThreshold(Pattern<TIndex, QGramsLookup<TShape, TSpec> > const & pattern, 
+					   TError const &errorRate, 
+					   TSize const &minLength
+	){
+		__int64 errors = static_cast<__int64>(ceil(errorRate*minLength));
+		__int64 window = (pattern.window > 1) ? pattern.window : 1;
+		__int64 sampled = (__int64) minLength - errors - (errors + 1) * ((__int64) weight(pattern.shape) + window - 2);
+		if (sampled <= 0)
+			return sampled;
+		return (sampled + window - 1) / window;
+	}
+	
+	template <typename TIndex, typename TShape, typename TSpec>
+	inline void 
+	setMinimizerWindow(Pattern<TIndex, QGramsLookup<TShape, TSpec> > & pattern, 
+					   unsigned window
+	){
+		pattern.window = window;
+	}
+	
 	template <typename TFinder, typename TIndex, typename TSpec>
 	inline bool 
 	_nextNonRepeatRange(TFinder &finder,
@@ -316,6 +469,69 @@ namespace SEQAN_NAMESPACE_MAIN
 		return true;
 	}
 	
+	/**
+	 * sample the q-grams of the current non-repeat range: out of every window 
+	 * of consecutive q-grams only the one with the fewest occurrences in the 
+	 * index is looked up (the rightmost on ties, such that neighbouring windows 
+	 * share their sample). All q-grams of a window within an exact match occur 
+	 * in the needle, hence the sampled one does, too. Q-grams that do not occur 
+	 * in the index at all are not looked up.
+	 */
+	template <typename TFinder, typename TIndex, typename TShape, typename TSpec>
+	inline void 
+	_sampleNonRepeatRange(TFinder &finder,
+						  Pattern<TIndex, QGramsLookup<TShape, TSpec> > const &pattern
+	){
+		typedef typename TFinder::THstkPos						THstkPos;
+		typedef typename TFinder::TSample						TSample;
+		typedef typename Value<TShape>::Type					THashValue;
+		typedef typename Fibre<TIndex, QGramDir>::Type			TDir;
+		typedef typename Value<TDir>::Type						TDirValue;
+		
+		TIndex const &index = host(pattern);
+		TDir const &dir = indexDir(index);
+		
+		clear(finder.samples);
+		finder.curSample = 0;
+		THstkPos qgrams = finder.endPos - length(pattern.shape) + 1 - finder.startPos;
+		THstkPos window = pattern.window;
+		
+		String<THashValue> hashes;
+		String<TDirValue> occurrences;
+		resize(hashes, qgrams, Exact());
+		resize(occurrences, qgrams, Exact());
+		for (THstkPos i = 0; i < qgrams; ++i, ++hostIterator(finder)){
+			if (i == 0)
+				hashes[i] = hash(finder.shape, hostIterator(hostIterator(finder)));
+			else
+				hashes[i] = hashNext(finder.shape, hostIterator(hostIterator(finder)));
+			TDirValue bucket = getBucket(index.bucketMap, hashes[i]);
+			occurrences[i] = dir[bucket + 1] - dir[bucket];
+		}
+		
+		// sliding window minimum, the queue holds positions of increasing occurrences
+		String<THstkPos> queue;
+		resize(queue, qgrams, Exact());
+		THstkPos head = 0, tail = 0;
+		for (THstkPos i = 0; i < qgrams; ++i){
+			while (tail > head && occurrences[queue[tail-1]] >= occurrences[i])
+				--tail;
+			queue[tail++] = i;
+			// a range shorter than the window is sampled once
+			if (i + 1 < window && i + 1 < qgrams)
+				continue;
+			while (queue[head] + window <= i)
+				++head;
+			THstkPos best = queue[head];
+			if (occurrences[best] == 0)
+				continue;
+			if (empty(finder.samples) || back(finder.samples).i1 != finder.startPos + best){
+				TSample sample(finder.startPos + best, hashes[best]);
+				appendValue(finder.samples, sample);
+			}
+		}
+	}
+	
 	//____________________________________________________________________________
 	
 
@@ -335,6 +551,9 @@ namespace SEQAN_NAMESPACE_MAIN
 	){
 		typedef	typename Value<TShape>::Type				THashValue;
 		
+		if (pattern.window > 1)
+			return _findSampled(finder, pattern);
+		
 		if (empty(finder)){
 			// init pattern
 			setPattern(finder, pattern);
@@ -384,6 +603,48 @@ namespace SEQAN_NAMESPACE_MAIN
 		} while (true);
 	}
 	
+	/**
+	 * find q-gram hits looking up the sampled q-grams of each non-repeat range only
+	 */
+	template <typename THaystack, typename TIndex, typename TShape, typename TSpec>
+	inline bool 
+	_findSampled(
+				 Finder<THaystack,  QGramsLookup<TShape, TSpec> >		&finder,
+				 Pattern<TIndex,  QGramsLookup<TShape, TSpec> > const	&pattern
+	){
+		if (empty(finder)){
+			// init pattern
+			setPattern(finder, pattern);
+			
+			// init finder
+			_finderSetNonEmpty(finder);
+			
+			if (!_firstNonRepeatRange(finder, pattern)) return false;
+			_sampleNonRepeatRange(finder, pattern);
+		} else {
+			if (++finder.curHit != finder.endHit) {
+				return true;
+			}
+		}
+		
+		// all previous matches reported -> search new ones
+		clear(finder.hits);
+		
+		do{
+			while (finder.curSample < length(finder.samples)){
+				finder.curPos = finder.samples[finder.curSample].i1;
+				if (_seedMultiProcessQGram(finder, pattern, finder.samples[finder.curSample++].i2)){
+					return true;
+				}
+			}
+			if (!_nextNonRepeatRange(finder, pattern)){
+				finder.curHit = finder.endHit;
+				return false;
+			}
+			_sampleNonRepeatRange(finder, pattern);
+		} while (true);
+	}
+	
 	
 	template <typename TQGramHit, typename TText, typename TShape>
 	inline typename Infix<TText>::Type
@@ -35,9 +35,11 @@
 #ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_GARDENER_H
 #define FBUSKE_APPS_TRIPLEXATOR_HEADER_GARDENER_H
 
+#include <algorithm>
 #include <limits>
 #include "find_index_qgrams.h"
 #include "triplex_alphabet.h"
+#include "triplex_pattern.h"
 #include "helper.h"
 #include <seqan/seeds2.h>  // Include module under test.
 #include <seqan/sequence/adapt_std_list.h>
@@ -49,15 +51,9 @@
 #include <seqan/parallel.h>
 #endif  // #if SEQAN_ENABLE_PARALLELISM
 
-#ifndef SEQAN_PRAGMA_IF_PARALLEL
-#if SEQAN_ENABLE_PARALLELISM
-#define STRINGIFY(a) #a
-#define SEQAN_PRAGMA_IF_PARALLEL(code) \
-_Pragma(STRINGIFY(code))
-#else // SEQAN_ENABLE_PARALLELISM
-#define SEQAN_PRAGMA_IF_PARALLEL(code)
-#endif // SEQAN_ENABLE_PARALLELISM
-#endif // SEQAN_PRAGMA_IF_PARALLEL
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // #if defined(__SSE2__)
 
 using namespace seqan;
 namespace SEQAN_NAMESPACE_MAIN
@@ -168,6 +164,15 @@ namespace SEQAN_NAMESPACE_MAIN
 	struct GardenerUngappedSegmented_;
 	typedef Tag<GardenerUngappedSegmented_> GardenerUngappedSegmented;
 	
+	// ungapped gardener extending seeds blockwise with SIMD compares
+	struct GardenerUngappedSimd_;
+	typedef Tag<GardenerUngappedSimd_> GardenerUngappedSimd;
+	
+	// ungapped gardener counting q-gram hits in diagonal buckets (SWIFT) 
+	// instead of collecting them per diagonal, extends seeds like GardenerUngappedSimd
+	struct GardenerSwift_;
+	typedef Tag<GardenerSwift_> GardenerSwift;
+	
 	//____________________________________________________________________________
 	
 	template <typename TId, typename TGardenerSpec>
@@ -182,13 +187,15 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef typename Iterator<THitSet, Standard>::Type		THitIterator;
 		
 		THitMap hits; // containing for each  duplex sequence (TId) the list of detected
+		bool clipHits; // clip hits to their longest epsilon-match before reporting them
 		
-		Gardener<TId, TGardenerSpec>(){}
+		Gardener<TId, TGardenerSpec>(): clipHits(false) {}
 		
-		Gardener<TId, TGardenerSpec>(Gardener<TId, TGardenerSpec> const &orig): hits(orig.hits) {};
+		Gardener<TId, TGardenerSpec>(Gardener<TId, TGardenerSpec> const &orig): hits(orig.hits), clipHits(orig.clipHits) {};
 		
 		Gardener<TId, TGardenerSpec> & operator = (Gardener<TId, TGardenerSpec> const &orig){
 			hits = orig.hits;
+			clipHits = orig.clipHits;
 			return *this;
 		}
 		
@@ -218,6 +225,13 @@ namespace SEQAN_NAMESPACE_MAIN
 		return false;
 	}
 	
+	// indicates if two windows share at least one position
+	// ATTENTION assumes same diagonal
+	template <typename TSeed>
+	bool isIntersecting(TSeed const & a, TSeed const & b){
+		return getBeginDim0(a) < getEndDim0(b) and getBeginDim0(b) < getEndDim0(a);
+	}
+	
 	
 	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	//											Meta Functions		                                                  //
@@ -230,6 +244,12 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef TGardenerSpec Type;
 	};
 	
+	template <typename TGardenerSpec, typename TPos, typename TId>
+	struct Spec<GardenerHit_<TGardenerSpec, TPos, TId> >
+	{
+		typedef TGardenerSpec Type;
+	};
+	
 	//____________________________________________________________________________
 	
 	template <typename TId, typename TGardenerSpec>
@@ -523,6 +543,14 @@ namespace SEQAN_NAMESPACE_MAIN
 
 	/**
 	 * Identifies the longest epsilon match and adjusts the seed accordingly
+	 * A window between the end of a left and the begin of a right mismatch run
+	 * is an epsilon match iff errors(left) - errorRate * end(left) >= 
+	 * errors(right) - errorRate * begin(right), with errors counted up to 
+	 * the respective position. Only left runs improving this bound on all
+	 * preceding runs can start a longest match. These are kept on a stack, 
+	 * which is matched against the right runs from the back in a single pass,
+	 * such that each run is visited at most twice (O(r) for r mismatch runs).
+	 * Of equally long epsilon matches the leftmost one is chosen.
 	 */
 	template<typename THaystack, typename TNeedle, typename TSeed, typename TPos, typename TError>
 	inline TPos _longestEpsMatch(THaystack const	&haystack,
@@ -535,40 +563,51 @@ namespace SEQAN_NAMESPACE_MAIN
 		// Preprocessing: compute and store mismatch and lengths
 		// A run is a triple of mismatch begin position, mismatch end position, 
 		// and total number of errors in sequence from begin to end position of this mismatch.
-		typedef std::vector<Triple<TPos, TPos, TPos> >	TRuns;
-		typedef typename Iterator<TRuns, Rooted>::Type	TRunsIter;
+		typedef Triple<TPos, TPos, TPos>				TRun;
+		typedef std::vector<TRun>						TRuns;
+		typedef typename TRuns::size_type				TRunNo;
 		
 		TRuns runs;
 		_fillRuns(haystack, needle, seed, runs);
 		
-		// Identify longest eps match by iterating over combinations of left and right positions
-		TRunsIter leftIt = begin(runs, Rooted());
-		TRunsIter rightIt = end(runs, Rooted());
-		--rightIt;
+		// left runs with a strictly increasing bound errors - errorRate * end
+		::std::vector<TRunNo> lefts;
+		double bound = 0;
+		for (TRunNo l = 0; l < runs.size(); ++l){
+			double leftBound = runs[l].i3 - errorRate * (double) runs[l].i2;
+			if (lefts.empty() || leftBound > bound){
+				lefts.push_back(l);
+				bound = leftBound;
+			}
+		}
 		
 		TPos beginOffset = 0;
 		TPos endOffset = 0;
-		TPos minLength = matchMinLength - 1;
 		TPos matches = 0;
+		bool found = false;
 		
-		// border up to which the begin of the seed is able to fulfil the minimum length constraint
-		TPos seedBeginBorder = max(TPos(0),(*rightIt).i1 - matchMinLength);
-		TPos seedEndBorder = (*leftIt).i2 + matchMinLength;
-		
-		while ((*leftIt).i2 + minLength < (*rightIt).i1 && (*leftIt).i2 <= seedBeginBorder) {
-			while ((*leftIt).i2 + minLength < (*rightIt).i1 && (*rightIt).i2 >= seedEndBorder) {
-				if(_isEpsMatch(*leftIt, *rightIt, errorRate)) {
-					beginOffset = (*leftIt).i2;
-					endOffset = (*rightIt).i1; 
-					minLength = endOffset - beginOffset;
-					matches = _countMatches(*leftIt, *rightIt);
+		for (TRunNo r = runs.size(); r > 0 && !lefts.empty(); --r){
+			TRun const &right = runs[r - 1];
+			while (!lefts.empty()){
+				TRun const &left = runs[lefts.back()];
+				// windows of this left run only get shorter with the following right runs
+				if (right.i1 < left.i2 + matchMinLength){
+					lefts.pop_back();
+					continue;
+				}
+				// left runs further down the stack have a smaller bound
+				if (!_isEpsMatch(left, right, errorRate))
 					break;
+				// longest epsilon match starting at this left run
+				TPos windowLength = right.i1 - left.i2;
+				if (!found || windowLength > endOffset - beginOffset || (windowLength == endOffset - beginOffset && left.i2 < beginOffset)){
+					beginOffset = left.i2;
+					endOffset = right.i1;
+					matches = _countMatches(left, right);
+					found = true;
 				}
-				--rightIt;
+				lefts.pop_back();
 			}
-			rightIt = end(runs);
-			--rightIt;
-			++leftIt;
 		}
 		
 		// adjust the seed borders
@@ -712,7 +751,381 @@ namespace SEQAN_NAMESPACE_MAIN
 	//____________________________________________________________________________
 	
 	/**	
-	 * Extends all seeds according to the scoring schema and a X-dropoff 
+	 * Ungapped X-drop extension of a seed to both sides, working directly on the 
+	 * haystack and needle without copying either sequence. 
+	 * Scores are accumulated exactly as in SeqAn's extendSeed(..., UnGappedXDrop())
+	 * such that both extension stages report identical windows.
+	 */
+	template <
+	typename TSeed,
+	typename THaystack,
+	typename TNeedle,
+	typename TScore,
+	typename TGardenerSpec
+	>
+	inline void _extendSeedUngapped(TSeed						&seed,
+									THaystack const				&haystack,
+									TNeedle const				&ndl,
+									Score<TScore, Simple> const &scoreMatrix, 
+									TScore const				&scoreDropOff,
+									TGardenerSpec const &
+									){
+		typedef typename Position<TSeed>::Type				TPos;
+		typedef typename Iterator<THaystack const, Standard>::Type	THayIter;
+		typedef typename Iterator<TNeedle const, Standard>::Type	TNdlIter;
+		
+		TScore const limit = -scoreDropOff;
+		TScore const matchScore = scoreMatch(scoreMatrix);
+		TScore const mismatchScore = scoreMismatch(scoreMatrix);
+		THayIter hay = begin(haystack, Standard());
+		TNdlIter nl = begin(ndl, Standard());
+		
+		// extension to the left
+		{
+			TScore tmpScore = 0;
+			TPos posDim0 = getBeginDim0(seed);
+			TPos posDim1 = getBeginDim1(seed);
+			TPos mismatchingSuffixLength = 0;
+			while (posDim0 >= 1 && posDim1 >= 1 && tmpScore > limit) {
+				tmpScore += (*(hay + posDim0) == *(nl + posDim1)) ? matchScore : mismatchScore;
+				if (*(hay + posDim0 - 1) == *(nl + posDim1 - 1)) {
+					mismatchingSuffixLength = 0;
+					if (tmpScore > 0)
+						tmpScore = 0;
+				} else {
+					++mismatchingSuffixLength;
+				}
+				--posDim0;
+				--posDim1;
+			}
+			setBeginDim0(seed, posDim0 + mismatchingSuffixLength);
+			setBeginDim1(seed, posDim1 + mismatchingSuffixLength);
+		}
+		
+		// extension to the right
+		{
+			TScore tmpScore = 0;
+			TPos lengthDim0 = length(haystack);
+			TPos lengthDim1 = length(ndl);
+			TPos posDim0 = getEndDim0(seed);
+			TPos posDim1 = getEndDim1(seed);
+			TPos mismatchingSuffixLength = 0;
+			while (posDim0 < lengthDim0 && posDim1 < lengthDim1 && tmpScore > limit) {
+				if (*(hay + posDim0) == *(nl + posDim1)) {
+					tmpScore += matchScore;
+					mismatchingSuffixLength = 0;
+					if (tmpScore > 0)
+						tmpScore = 0;
+				} else {
+					tmpScore += mismatchScore;
+					++mismatchingSuffixLength;
+				}
+				++posDim0;
+				++posDim1;
+			}
+			setEndDim0(seed, posDim0 - mismatchingSuffixLength);
+			setEndDim1(seed, posDim1 - mismatchingSuffixLength);
+		}
+	}
+	
+	//____________________________________________________________________________
+	
+	/**	
+	 * Compares 16 consecutive characters of two byte sequences
+	 * bit i of the result is set if a[i] == b[i]
+	 */
+	inline unsigned _matchMask16(unsigned char const *a, 
+								 unsigned char const *b
+								 ){
+#if defined(__SSE2__)
+		__m128i va = _mm_loadu_si128(reinterpret_cast<__m128i const *>(a));
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<__m128i const *>(b));
+		return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+#else
+		unsigned mask = 0;
+		for (unsigned i = 0; i < 16; ++i)
+			mask |= (unsigned)(a[i] == b[i]) << i;
+		return mask;
+#endif
+	}
+	
+	/**	
+	 * Number of consecutive set bits starting at bit 0
+	 */
+	inline unsigned _trailingOnes(unsigned x){
+#if defined(__GNUC__)
+		return (~x == 0u) ? 32u : (unsigned) __builtin_ctz(~x);
+#else
+		unsigned ones = 0;
+		for (; (x & 1u) != 0; x >>= 1)
+			++ones;
+		return ones;
+#endif
+	}
+	
+	/**	
+	 * Number of consecutive set bits starting at bit 15 of a 16 bit mask
+	 */
+	inline unsigned _leadingOnes16(unsigned x){
+#if defined(__GNUC__)
+		return (unsigned) __builtin_clz(~(x << 16));
+#else
+		unsigned ones = 0;
+		for (unsigned bit = 0x8000u; (x & bit) != 0; bit >>= 1)
+			++ones;
+		return ones;
+#endif
+	}
+	
+	//____________________________________________________________________________
+	
+	/**	
+	 * Ungapped X-drop extension of a seed to both sides comparing 16 positions 
+	 * at a time. Blocks without mismatches are consumed at once, blocks with 
+	 * mismatches are resolved from their compare mask, skipping runs of matches.
+	 * Requires match score >= 0 and reports the same windows as the scalar version.
+	 * Triplex motif strings keep their characters in a contiguous mask string 
+	 * of single byte letters, other sequence types use the scalar version.
+	 */
+	template <
+	typename TSeed,
+	typename THost1,
+	typename TString1,
+	typename THost2,
+	typename TString2,
+	typename TScore
+	>
+	inline void _extendSeedUngapped(TSeed								&seed,
+									ModStringTriplex<THost1, TString1> const &haystack,
+									ModStringTriplex<THost2, TString2> const &ndl,
+									Score<TScore, Simple> const			&scoreMatrix, 
+									TScore const						&scoreDropOff,
+									GardenerUngappedSimd const &
+									){
+		typedef typename Position<TSeed>::Type				TPos;
+		SEQAN_ASSERT_EQ(sizeof(typename Value<TString1>::Type), 1u);
+		SEQAN_ASSERT_EQ(sizeof(typename Value<TString2>::Type), 1u);
+		
+		TScore const limit = -scoreDropOff;
+		TScore const matchScore = scoreMatch(scoreMatrix);
+		TScore const mismatchScore = scoreMismatch(scoreMatrix);
+		TPos const lengthDim0 = length(haystack);
+		TPos const lengthDim1 = length(ndl);
+		if (lengthDim0 == 0 || lengthDim1 == 0)
+			return;
+		unsigned char const *hay = reinterpret_cast<unsigned char const *>(&*begin(haystack, Standard()));
+		unsigned char const *nl = reinterpret_cast<unsigned char const *>(&*begin(ndl, Standard()));
+		
+		// extension to the left
+		// the score of a step stems from the current position, the reset from the preceding one
+		{
+			TScore tmpScore = 0;
+			TPos posDim0 = getBeginDim0(seed);
+			TPos posDim1 = getBeginDim1(seed);
+			TPos mismatchingSuffixLength = 0;
+			bool current = (hay[posDim0] == nl[posDim1]);
+			bool dropped = false;
+			while (!dropped && posDim0 >= 16 && posDim1 >= 16 && tmpScore > limit) {
+				// bit i covers positions (posDim0-16+i, posDim1-16+i)
+				unsigned mask = _matchMask16(hay + posDim0 - 16, nl + posDim1 - 16);
+				if (current && mask == 0xffffu){
+					tmpScore += 16 * matchScore;
+					if (tmpScore > 0)
+						tmpScore = 0;
+					mismatchingSuffixLength = 0;
+					posDim0 -= 16;
+					posDim1 -= 16;
+					continue;
+				}
+				for (int i = 15; i >= 0; ){
+					if (!(tmpScore > limit)){
+						dropped = true;
+						break;
+					}
+					if (current){
+						// run of matches continuing from bit i downwards
+						unsigned run = _leadingOnes16((mask << (15 - i)) & 0xffffu);
+						if (run > 0){
+							tmpScore += (TScore) run * matchScore;
+							if (tmpScore > 0)
+								tmpScore = 0;
+							mismatchingSuffixLength = 0;
+							posDim0 -= run;
+							posDim1 -= run;
+							i -= run;
+							continue;
+						}
+					}
+					tmpScore += current ? matchScore : mismatchScore;
+					current = ((mask >> i) & 1u) != 0;
+					if (current) {
+						mismatchingSuffixLength = 0;
+						if (tmpScore > 0)
+							tmpScore = 0;
+					} else {
+						++mismatchingSuffixLength;
+					}
+					--posDim0;
+					--posDim1;
+					--i;
+				}
+			}
+			while (posDim0 >= 1 && posDim1 >= 1 && tmpScore > limit) {
+				tmpScore += (hay[posDim0] == nl[posDim1]) ? matchScore : mismatchScore;
+				if (hay[posDim0 - 1] == nl[posDim1 - 1]) {
+					mismatchingSuffixLength = 0;
+					if (tmpScore > 0)
+						tmpScore = 0;
+				} else {
+					++mismatchingSuffixLength;
+				}
+				--posDim0;
+				--posDim1;
+			}
+			setBeginDim0(seed, posDim0 + mismatchingSuffixLength);
+			setBeginDim1(seed, posDim1 + mismatchingSuffixLength);
+		}
+		
+		// extension to the right
+		{
+			TScore tmpScore = 0;
+			TPos posDim0 = getEndDim0(seed);
+			TPos posDim1 = getEndDim1(seed);
+			TPos mismatchingSuffixLength = 0;
+			bool dropped = false;
+			while (!dropped && posDim0 + 16 <= lengthDim0 && posDim1 + 16 <= lengthDim1 && tmpScore > limit) {
+				// bit i covers positions (posDim0+i, posDim1+i)
+				unsigned mask = _matchMask16(hay + posDim0, nl + posDim1);
+				if (mask == 0xffffu){
+					tmpScore += 16 * matchScore;
+					if (tmpScore > 0)
+						tmpScore = 0;
+					mismatchingSuffixLength = 0;
+					posDim0 += 16;
+					posDim1 += 16;
+					continue;
+				}
+				for (unsigned i = 0; i < 16; ){
+					if (!(tmpScore > limit)){
+						dropped = true;
+						break;
+					}
+					// run of matches starting at bit i
+					unsigned run = _trailingOnes(mask >> i);
+					if (run > 0) {
+						tmpScore += (TScore) run * matchScore;
+						mismatchingSuffixLength = 0;
+						if (tmpScore > 0)
+							tmpScore = 0;
+					} else {
+						tmpScore += mismatchScore;
+						++mismatchingSuffixLength;
+						run = 1;
+					}
+					posDim0 += run;
+					posDim1 += run;
+					i += run;
+				}
+			}
+			while (posDim0 < lengthDim0 && posDim1 < lengthDim1 && tmpScore > limit) {
+				if (hay[posDim0] == nl[posDim1]) {
+					tmpScore += matchScore;
+					mismatchingSuffixLength = 0;
+					if (tmpScore > 0)
+						tmpScore = 0;
+				} else {
+					tmpScore += mismatchScore;
+					++mismatchingSuffixLength;
+				}
+				++posDim0;
+				++posDim1;
+			}
+			setEndDim0(seed, posDim0 - mismatchingSuffixLength);
+			setEndDim1(seed, posDim1 - mismatchingSuffixLength);
+		}
+	}
+
+	/**
+	 * The SWIFT gardener extends its seeds like the ungapped SIMD gardener
+	 */
+	template <
+	typename TSeed,
+	typename THost1,
+	typename TString1,
+	typename THost2,
+	typename TString2,
+	typename TScore
+	>
+	inline void _extendSeedUngapped(TSeed								&seed,
+									ModStringTriplex<THost1, TString1> const &haystack,
+									ModStringTriplex<THost2, TString2> const &ndl,
+									Score<TScore, Simple> const			&scoreMatrix,
+									TScore const						&scoreDropOff,
+									GardenerSwift const &
+									){
+		_extendSeedUngapped(seed, haystack, ndl, scoreMatrix, scoreDropOff, GardenerUngappedSimd());
+	}
+
+	//____________________________________________________________________________
+
+	/**
+	 * Appends the hit of an extended window to the hit list. 
+	 * If clipHits is set, the window is clipped to its longest epsilon-match first.
+	 */
+	template <
+	typename THitSet,
+	typename THaystack,
+	typename TNeedle,
+	typename TSeed,
+	typename TSeqNo,
+	typename TDiag,
+	typename TSize,
+	typename TError,
+	typename TId
+	>
+	inline void _addWindowHit(THitSet				&hitSet,
+							  THaystack const		&haystack,
+							  TNeedle const			&needle,
+							  TSeed					window,
+							  TSeqNo const			&seqno,
+							  TDiag const			&diag,
+							  TSize const			&minLength,
+							  TError const			&errorRate,
+							  bool					clipHits,
+							  TId const				&queryid
+							  ){
+		typedef typename Position<TSeed>::Type				TPos;
+		typedef typename Value<THitSet>::Type				THit;
+		
+		TPos matches = 0;
+		if (clipHits){
+			// cut ends to obtain longest epsilon-match within the window
+			matches = _longestEpsMatch(haystack, needle, window, (TPos)minLength, errorRate);
+			if (getEndDim0(window)-getBeginDim0(window) < (TPos)minLength)
+				return;
+		}
+		
+		// create a new hit and append it to the gardeners hit list
+		THit hit(queryid,
+				 seqno,					// needle seq. number            
+				 getBeginDim0(window),	// begin in haystack      
+				 getBeginDim1(window),	// needle position
+				 diag,					// the diagonal
+				 matches,
+				 getEndDim0(window)-getBeginDim0(window)
+				 );
+		if (!clipHits || !hasKey(hitSet, hit))
+			add(hitSet, hit);
+	}
+	
+	/**
+	 * Extends all seeds according to the scoring schema and a X-dropoff
+	 * The seeds of a needle are batched by diagonal (the maps are ordered by 
+	 * needle and diagonal, seeds are collected in haystack order), such that 
+	 * merging, extension and reporting of the extended windows is a single linear 
+	 * pass over each diagonal. Haystack, needles and seed sets are accessed in
+	 * place, the seed sets are left untouched.
+	 * If clipHits is set, each window is clipped to its longest epsilon-match.
 	 */
 	template <
 	typename THitSet,
@@ -722,6 +1135,7 @@ namespace SEQAN_NAMESPACE_MAIN
 	typename TMap,
 	typename TSize,
 	typename TScore,
+	typename TError,
 	typename TId
 	>
 	inline void _extendSeedlings(THitSet					&hitSet,
@@ -731,6 +1145,8 @@ namespace SEQAN_NAMESPACE_MAIN
 								 Score<TScore, Simple> const &scoreMatrix, 
 								 TSize const				&minLength,
 								 TScore	const				&scoreDropOff, 
+								 TError const				&errorRate,
+								 bool						clipHits,
 								 TId						&queryid
 								 ){
 		typedef typename Iterator<TMap>::Type				TMapIter;
@@ -746,9 +1162,11 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef typename Value<TSeedSetPointer>::Type		TSeedSet;
 		typedef typename Value<TSeedSet>::Type				TSeed;
 		typedef typename Position<TSeedSet>::Type			TPos;
-		typedef Dequeue<TSeed>								TSeedList;// @TODO known memory leak in seqan string http://trac.mi.fu-berlin.de/seqan/ticket/364
 		typedef typename Host<TFinder>::Type				THost;
 		typedef typename Value<THitSet>::Type				THit;
+		typedef typename Spec<THit>::Type					TGardenerSpec;
+		
+		THost const &haystack = host(finder);
 		
 		// process all needles with entries in the map
 		TMapIter itsme = end(seqmap);
@@ -756,83 +1174,60 @@ namespace SEQAN_NAMESPACE_MAIN
 			TSeqNo &seqno = key(*itsmb);
 			// check that seqno is valid
 			if (seqno < (TId)countSequences(needle(pattern))){
-				TDiagMapPointer diagmapP = cargo(*itsmb);
-				TDiagMap diagmap = *diagmapP;
+				TDiagMap &diagmap = *cargo(*itsmb);
 				// process each diagonal at a time
 				TDiagMapIter itdme = end(diagmap) ;
 				for (TDiagMapIter itdmb = begin(diagmap); itdmb != itdme; ++itdmb){
 					TDiag &diag = key(*itdmb);
 					// get the seed set
-					TSeedSetPointer seedsetP = cargo(*itdmb);
-					TSeedSet seedset = *seedsetP;
-					THost tmp = host(finder);
-					// extend all seeds by first overlapping with succeeding seeds
-					TSeedList newset;
-					while (!empty(seedset)){
-						TSeed seed = front(seedset);
-						popFront(seedset);
+					TSeedSet &seedset = *cargo(*itdmb);
+					// last window added to the hitlist
+					TSeed window;
+					bool added = false;
+					
+					TPos seeds = length(seedset);
+					for (TPos i = 0; i < seeds; ){
+						TSeed seed = seedset[i++];
 #ifdef TRIPLEX_DEBUG
 						::std::cout << "seed_1:" << getBeginDim0(seed) << ":" << getEndDim0(seed) << " " << getBeginDim1(seed) << ":" << getEndDim1(seed) << ::std::endl;
 #endif
-						
-						while (!empty(seedset) and isOverlapping(seed, front(seedset))){
-							TSeed seed2 = front(seedset);
-							setBeginDim0(seed, min(getBeginDim0(seed),getBeginDim0(seed2)));
-							setBeginDim1(seed, min(getBeginDim1(seed),getBeginDim1(seed2)));
-							setEndDim0(seed, max(getEndDim0(seed),getEndDim0(seed2)));
-							setEndDim1(seed, max(getEndDim1(seed),getEndDim1(seed2)));
-							popFront(seedset);
+						// extend all seeds by first overlapping with succeeding seeds
+						while (i < seeds && isOverlapping(seed, seedset[i])){
+							setBeginDim0(seed, min(getBeginDim0(seed),getBeginDim0(seedset[i])));
+							setBeginDim1(seed, min(getBeginDim1(seed),getBeginDim1(seedset[i])));
+							setEndDim0(seed, max(getEndDim0(seed),getEndDim0(seedset[i])));
+							setEndDim1(seed, max(getEndDim1(seed),getEndDim1(seedset[i])));
+							++i;
 						}
 						
 #ifdef TRIPLEX_DEBUG
 						::std::cout << "seed_2:" << getBeginDim0(seed) << ":" << getEndDim0(seed) << " " << getBeginDim1(seed) << ":" << getEndDim1(seed) << ::std::endl;
 #endif
 						// extend seed to both sides as far as possible
-						extendSeed(seed, tmp, getSequenceByNo(seqno,needle(pattern)), EXTEND_BOTH, scoreMatrix, scoreDropOff, UnGappedXDrop());
-
+						_extendSeedUngapped(seed, haystack, getSequenceByNo(seqno,needle(pattern)), scoreMatrix, scoreDropOff, TGardenerSpec());
+						
 #ifdef TRIPLEX_DEBUG
 						::std::cout << "seed_3:" << getBeginDim0(seed) << ":" << getEndDim0(seed) << " " << getBeginDim1(seed) << ":" << getEndDim1(seed) << ::std::endl;
 #endif
+						if (getEndDim0(seed)-getBeginDim0(seed) < (TPos)minLength)
+							continue;
 						
-						// merge overlapping windows
-						if (getEndDim0(seed)-getBeginDim0(seed) >=  (TPos)minLength){
-							if (!empty(newset) && isOverlapping(seed, back(newset))){
-								setBeginDim0(seed, min(getBeginDim0(seed),getBeginDim0(back(newset))));
-								setBeginDim1(seed, min(getBeginDim1(seed),getBeginDim1(back(newset))));
-								setEndDim0(seed, max(getEndDim0(seed),getEndDim0(back(newset))));
-								setEndDim1(seed, max(getEndDim1(seed),getEndDim1(back(newset))));
-							} else {
-								pushBack(newset,seed);
-							}
+						// merge windows sharing positions with the pending one, 
+						// otherwise their common triplexes would be verified and reported twice
+						if (added && isIntersecting(seed, window)){
+							setBeginDim0(window, min(getBeginDim0(window),getBeginDim0(seed)));
+							setBeginDim1(window, min(getBeginDim1(window),getBeginDim1(seed)));
+							setEndDim0(window, max(getEndDim0(window),getEndDim0(seed)));
+							setEndDim1(window, max(getEndDim1(window),getEndDim1(seed)));
+							continue;
 						}
+						if (added)
+							_addWindowHit(hitSet, haystack, getSequenceByNo(seqno,needle(pattern)), window, seqno, diag, minLength, errorRate, clipHits, queryid);
+						window = seed;
+						added = true;
 					}
-					
-					// add all now non-overlapping windows to hitlist
-					while(!empty(newset)){
-						// create a new hit and append it to the gardeners hit list
-						THit hit(queryid,
-								 seqno,					// needle seq. number            
-								 getBeginDim0(front(newset)),      // begin in haystack      
-								 getBeginDim1(front(newset)),		// needle position
-								 diag,					// the diagonal
-								 0,
-								 getEndDim0(front(newset))-getBeginDim0(front(newset))
-								 );
-
-#ifdef TRIPLEX_DEBUG
-						::std::cout << "newset:" << length(newset) << " hitSet:" << length(hitSet) << ::std::endl;
-#endif
-						
-						// append the hit 
-						add(hitSet, hit);
-						popFront(newset);
-#ifdef TRIPLEX_DEBUG
-						::std::cout << "newset:" << length(newset) << " hitSet:" << length(hitSet) << ::std::endl;
-#endif
-					}
-					
-//					// find the longest match conform with error rate
-//					_clipSeedEndsAndAdd(hitSet, queryid, seqno, diag, host(finder), getSequenceByNo(seqno,needle(pattern)), newset, errorRate, minLength, SINGLE_WORKER() );
+					if (added)
+						_addWindowHit(hitSet, haystack, getSequenceByNo(seqno,needle(pattern)), window, seqno, diag, minLength, errorRate, clipHits, queryid);
 					
 				} //diagmap
 			} else {
@@ -874,19 +1269,20 @@ namespace SEQAN_NAMESPACE_MAIN
 
 	//____________________________________________________________________________
 	/**
-	 * copy seed passing the qgram lemma
+	 * copy seed covering the needle positions seedBegin to seedEnd (inclusive)
 	 */
 	template <
 	typename TMap,
 	typename TId,
 	typename TDiag,
-	typename TSet
+	typename TPos
 	>
-	inline void _putSeedsInMap(TMap			&seqmap,
-							   TId	const	&seqNo,
-							   TDiag const	&diag,
-							   TSet		&posSet
-							   ){
+	inline void _putSeedInMap(TMap			&seqmap,
+							  TId	const	&seqNo,
+							  TDiag const	&diag,
+							  TPos const	&seedBegin,
+							  TPos const	&seedEnd
+							  ){
 		typedef typename Value<TMap>::Type				TMapPair;
 		typedef typename Cargo<TMapPair>::Type			TDiagMapPointer;
 		typedef typename Value<TDiagMapPointer>::Type 	TDiagMap;
@@ -894,12 +1290,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef typename Cargo<TDiagMapPair>::Type		TSeedSetPointer;
 		typedef typename Value<TSeedSetPointer>::Type	TSeedSet;
 		typedef typename Value<TSeedSet>::Type			TSeed;
-		typedef typename Iterator<TSet>::Type			TPosIter;
-		typedef typename Value<TSet>::Type				TPos;
 		
-#ifdef TRIPLEX_DEBUG			
-		::std::cout << "add new window:" << length(posSet) << "-" << front(posSet) << " " << back(posSet) << ::std::endl;
-#endif	
 		// new needle sequence that has no entries yet -- add new needle, and seedset corresponding to diagonal
 		if ( ! hasKey(seqmap, seqNo)){		
 			// create new needle map
@@ -911,7 +1302,7 @@ namespace SEQAN_NAMESPACE_MAIN
 			{
 				TDiagMapPointer tmp_diagMapPointer = cargo(seqmap, seqNo);
 				TSeedSetPointer seedSetPointer = new TSeedSet;
-				TSeed seed(diag+front(posSet), front(posSet), back(posSet)-front(posSet)+1);
+				TSeed seed(diag+seedBegin, seedBegin, seedEnd-seedBegin+1);
 				pushBack(*seedSetPointer,seed);
 				insert(*tmp_diagMapPointer, diag, seedSetPointer);
 			}
@@ -923,13 +1314,13 @@ namespace SEQAN_NAMESPACE_MAIN
 			if (!hasKey(*diagMapPointer, diag)){
 				// create new seedset for this diagonal
 				TSeedSet* seedSetPointer = new TSeedSet;
-				TSeed seed2(diag+front(posSet), front(posSet), back(posSet)-front(posSet)+1);
+				TSeed seed2(diag+seedBegin, seedBegin, seedEnd-seedBegin+1);
 				pushBack(*seedSetPointer,seed2);
 				insert(*diagMapPointer, diag, seedSetPointer);
 			} 
 			else { // diagonal index is known -- push seed on heap
 				TSeedSet* seedSetPointer = cargo(*diagMapPointer, diag);
-				TSeed seed3(diag+front(posSet), front(posSet), back(posSet)-front(posSet)+1);
+				TSeed seed3(diag+seedBegin, seedBegin, seedEnd-seedBegin+1);
 				// check if window simply extends previous one
 #ifdef TRIPLEX_DEBUG			
 				::std::cout << "extend? " << getBeginDim0(back(*seedSetPointer)) << "=" << getBeginDim0(seed3) << " " << getEndDim0(back(*seedSetPointer)) << " " << getEndDim0(seed3) << ::std::endl;
@@ -951,6 +1342,27 @@ namespace SEQAN_NAMESPACE_MAIN
 		}	
 	}
 	
+	//____________________________________________________________________________
+	/**
+	 * copy seed passing the qgram lemma
+	 */
+	template <
+	typename TMap,
+	typename TId,
+	typename TDiag,
+	typename TSet
+	>
+	inline void _putSeedsInMap(TMap			&seqmap,
+							   TId	const	&seqNo,
+							   TDiag const	&diag,
+							   TSet		&posSet
+							   ){
+#ifdef TRIPLEX_DEBUG			
+		::std::cout << "add new window:" << length(posSet) << "-" << front(posSet) << " " << back(posSet) << ::std::endl;
+#endif	
+		_putSeedInMap(seqmap, seqNo, diag, front(posSet), back(posSet));
+	}
+	
 	//____________________________________________________________________________
 	/**
 	 * get all the hits between needles and haystack
@@ -962,13 +1374,15 @@ namespace SEQAN_NAMESPACE_MAIN
 	typename TSpec,
 	typename TIndex,
 	typename TPos,
-	typename TMap
+	typename TMap,
+	typename TGardenerSpec
 	>
 	inline void _collectSeeds(Finder<THaystack, QGramsLookup<TSpec> >		&finder,
 							  Pattern<TIndex,  QGramsLookup<TSpec> > const	&pattern,
 							  TPos const									&seedsThreshold,
 							  TPos const									&minLength,
-							  TMap											&seqmap
+							  TMap											&seqmap,
+							  TGardenerSpec const &
 							  ){
 		typedef typename Value<TMap>::Type				TMapPair;
 		typedef typename Key<TMapPair>::Type			TId;
@@ -1058,6 +1472,138 @@ namespace SEQAN_NAMESPACE_MAIN
 			delete diagmapPointer;
 		}
 	}
+	
+	//____________________________________________________________________________
+	
+	/**
+	 * bucket counting the current run of q-gram hits on a diagonal of a needle
+	 */
+	template <typename TPos, typename TDiag>
+	struct DiagonalBucket_
+	{
+		unsigned	ndlSeqNo;	// needle sequence number
+		TDiag		diag;		// the diagonal
+		TPos		first;		// needle position of the first hit of the run
+		TPos		last;		// needle position of the last hit of the run
+		unsigned	count;		// number of hits of the run, 0 = empty bucket
+	};
+	
+	// orders runs by needle, diagonal and position
+	template <typename TBucket>
+	struct DiagonalBucketLess_ : public ::std::binary_function<TBucket, TBucket, bool>
+	{
+		inline bool operator() (TBucket const &a, TBucket const &b) const {
+			if (a.ndlSeqNo != b.ndlSeqNo) return a.ndlSeqNo < b.ndlSeqNo;
+			if (a.diag != b.diag) return a.diag < b.diag;
+			return a.first < b.first;
+		}
+	};
+	
+	template <typename TBucketString, typename TDiag>
+	inline unsigned _diagonalBucketSlot(TBucketString const &buckets, 
+										unsigned ndlSeqNo, 
+										TDiag diag
+										){
+		unsigned mask = length(buckets) - 1;
+		unsigned slot = ndlSeqNo * 0x9e3779b1u + (unsigned) diag * 0x85ebca77u;
+		slot ^= slot >> 15;
+		for (slot &= mask; buckets[slot].count != 0 && (buckets[slot].ndlSeqNo != ndlSeqNo || buckets[slot].diag != diag); slot = (slot + 1) & mask) {}
+		return slot;
+	}
+	
+	template <typename TBucketString>
+	inline void _growDiagonalBuckets(TBucketString &buckets)
+	{
+		typedef typename Value<TBucketString>::Type		TBucket;
+		
+		TBucketString old;
+		swap(old, buckets);
+		TBucket empty;
+		empty.count = 0;
+		resize(buckets, 2 * length(old), empty, Exact());
+		for (unsigned i=0; i<length(old); ++i){
+			if (old[i].count != 0)
+				buckets[_diagonalBucketSlot(buckets, old[i].ndlSeqNo, old[i].diag)] = old[i];
+		}
+	}
+	
+	/**
+	 * get all the hits between needles and haystack (SWIFT-style)
+	 * In an ungapped search the parallelograms of the SWIFT filter are single 
+	 * diagonals. The q-gram hits of each needle and diagonal are counted in a 
+	 * bucket of an open addressing table, each hit is an O(1) update and no 
+	 * positions are kept. A bucket counts a run of hits whose successive hits 
+	 * are at most minLength-q needle positions apart, hence the hits of any 
+	 * window of minLength belong to the same run. Runs reaching the threshold
+	 * are handed over as a single seed each.
+	 */
+	template <
+	typename THaystack,
+	typename TSpec,
+	typename TIndex,
+	typename TPos,
+	typename TMap
+	>
+	inline void _collectSeeds(Finder<THaystack, QGramsLookup<TSpec> >		&finder,
+							  Pattern<TIndex,  QGramsLookup<TSpec> > const	&pattern,
+							  TPos const									&seedsThreshold,
+							  TPos const									&minLength,
+							  TMap											&seqmap,
+							  GardenerSwift const &
+							  ){
+		typedef typename MakeSigned_<TPos>::Type		TDiag;
+		typedef DiagonalBucket_<TPos, TDiag>			TBucket;
+		typedef String<TBucket>							TBucketString;
+		
+		TBucket empty;
+		empty.count = 0;
+		TBucketString buckets;
+		resize(buckets, 64, empty, Exact());
+		unsigned used = 0;
+		TBucketString runs;
+		TPos maxGap = (minLength > (TPos) weight(pattern.shape)) ? minLength - weight(pattern.shape) : 0;
+		
+		while (find(finder, pattern)) {
+			unsigned ndlSeqNo = (*finder.curHit).ndlSeqNo;
+			TDiag diag = (*finder.curHit).diag;
+			TPos ndlPos = (*finder.curHit).ndlPos;
+			
+			unsigned slot = _diagonalBucketSlot(buckets, ndlSeqNo, diag);
+			TBucket &bucket = buckets[slot];
+			if (bucket.count == 0){
+				// keep the load below one half
+				if (2 * (used + 1) > length(buckets)){
+					_growDiagonalBuckets(buckets);
+					slot = _diagonalBucketSlot(buckets, ndlSeqNo, diag);
+				}
+				TBucket &newBucket = buckets[slot];
+				newBucket.ndlSeqNo = ndlSeqNo;
+				newBucket.diag = diag;
+				newBucket.first = newBucket.last = ndlPos;
+				newBucket.count = 1;
+				++used;
+			} else if (ndlPos > bucket.last + maxGap){
+				// the previous run is over
+				if (bucket.count >= seedsThreshold)
+					appendValue(runs, bucket);
+				bucket.first = bucket.last = ndlPos;
+				bucket.count = 1;
+			} else {
+				bucket.last = ndlPos;
+				++bucket.count;
+			}
+		}
+		
+		for (unsigned i=0; i<length(buckets); ++i){
+			if (buckets[i].count != 0 && buckets[i].count >= seedsThreshold)
+				appendValue(runs, buckets[i]);
+		}
+		
+		// the seed map expects the seeds of a diagonal in needle order
+		::std::sort(begin(runs, Standard()), end(runs, Standard()), DiagonalBucketLess_<TBucket>());
+		for (unsigned i=0; i<length(runs); ++i)
+			_putSeedInMap(seqmap, runs[i].ndlSeqNo, runs[i].diag, runs[i].first, runs[i].last);
+	}
 
 		
 	//____________________________________________________________________________
@@ -1090,7 +1636,8 @@ namespace SEQAN_NAMESPACE_MAIN
 					  TPos const						&minLength,
 					  TPos const						&seedsThreshold,
 					  TDrop const						&xDrop,
-					  TId								&queriyid
+					  TId								&queriyid,
+					  bool								clipHits
 					  ){
 		// used datastructure: Map < NeedleSeqNo, < Map < diagonal, SeedSet > > 
 		// for each needle all q-gram hits are stored according to the diagonal they reside in
@@ -1107,12 +1654,13 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef Map<TSeqMapPair, Skiplist< > >				TSeqMap;
 		typedef typename Iterator<TSeqMap>::Type			TSeqMapIter;
 		typedef typename Iterator<TDiagMap>::Type			TDiagMapIter;
+		typedef typename Spec<typename Value<THitSet>::Type>::Type	TGardenerSpec;
 		
 		// run gardener on first call
 		if (empty(finder) ){
 			TSeqMap seqmap;
 			// get all maxed seeds for any needle in the haystack (flanked by mismatches)
-			_collectSeeds(finder, pattern, seedsThreshold, minLength, seqmap);
+			_collectSeeds(finder, pattern, seedsThreshold, minLength, seqmap, TGardenerSpec());
 			
 			// define a scoring scheme
 			TScore match = 1;
@@ -1120,7 +1668,7 @@ namespace SEQAN_NAMESPACE_MAIN
 			Score<TScore> scoreMatrix(match, mismatch, std::numeric_limits<int>::max());
 			TScore scoreDropOff = (TScore) _max((TScore) xDrop * (-mismatch), minValue<TScore>()+1);
 			// extend seeds 
-			_extendSeedlings(hitSet, finder, pattern, seqmap, scoreMatrix, minLength, scoreDropOff, queriyid);
+			_extendSeedlings(hitSet, finder, pattern, seqmap, scoreMatrix, minLength, scoreDropOff, errorRate, clipHits, queriyid);
 			
 			// housekeeping
 			// free memory from gram-hitlist
@@ -1278,7 +1826,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		
 		// q-gram lemma
 		// w+1-(k+1)q | w=minimum length, k=errors, q=weight(q-grams)
-		TPos minSeedsThreshold = static_cast<TPos>(minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape));
+		TPos minSeedsThreshold = static_cast<TPos>(_minSeedsThreshold(pattern, errorRate, minLength));
 #ifdef TRIPLEX_DEBUG
 		::std::cout << "minLength:" << minLength << " errorRate:" << errorRate << " qgram:" << weight(pattern.shape) << ::std::endl;
 		::std::cout << (ceil(errorRate*minLength)+1) << " " << ((ceil(errorRate*minLength)+1)*weight(pattern.shape)) << " " << minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape) << ::std::endl;
@@ -1289,7 +1837,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		for (TId queryid=0; queryid<querylen; ++queryid){
 			THitSetPointer hitsPointer = new THitSet;
 			TFinder finder(queries[queryid]); 
-			_find(*hitsPointer, finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid );	
+			_find(*hitsPointer, finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid, gardener.clipHits);	
 			insert(gardener.hits, queryid, hitsPointer);
 #ifdef TRIPLEX_DEBUG
 			::std::cout << "TTS " << queryid << " : " << queries[queryid] << ::std::endl;
@@ -1338,7 +1886,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		
 		// q-gram lemma
 		// w+1−(k+1)q | w=minimum length, k=errors, q=weight(q-grams)
-		TPos minSeedsThreshold = static_cast<TPos>(minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape));
+		TPos minSeedsThreshold = static_cast<TPos>(_minSeedsThreshold(pattern, errorRate, minLength));
 #ifdef TRIPLEX_DEBUG
 		::std::cout << "minLength:" << minLength << " errorRate:" << errorRate << " qgram:" << weight(pattern.shape) << ::std::endl;
 		::std::cout << (ceil(errorRate*minLength)+1) << " " << ((ceil(errorRate*minLength)+1)*weight(pattern.shape)) << " " << minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape) << ::std::endl;
@@ -1348,7 +1896,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		for (TId queryid=0; queryid<querylen; ++queryid){
 			THitSetPointer hitsPointer = new THitSet;
 			TFinder finder(queries[queryid], minRepeatLength, maxRepeatPeriod); 
-			_find(*hitsPointer, finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid );	
+			_find(*hitsPointer, finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid, gardener.clipHits);	
 			insert(gardener.hits, queryid, hitsPointer);
 #ifdef TRIPLEX_DEBUG
 			::std::cout << "TTS " << queryid << " : " << queries[queryid] << ::std::endl;
@@ -1396,7 +1944,7 @@ namespace SEQAN_NAMESPACE_MAIN
 
 		// q-gram lemma
 		// w+1−(k+1)q | w=minimum length, k=errors, q=weight(q-grams)
-		TPos minSeedsThreshold = static_cast<TPos>(minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape));
+		TPos minSeedsThreshold = static_cast<TPos>(_minSeedsThreshold(pattern, errorRate, minLength));
 #ifdef TRIPLEX_DEBUG
 		::std::cout << "minLength:" << minLength << " errorRate:" << errorRate << " qgram:" << weight(pattern.shape) << ::std::endl;
 		::std::cout << (ceil(errorRate*minLength)+1) << " " << ((ceil(errorRate*minLength)+1)*weight(pattern.shape)) << " " << minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape) << ::std::endl;
@@ -1408,7 +1956,7 @@ namespace SEQAN_NAMESPACE_MAIN
 			for (TId queryid=0; queryid<querylen; ++queryid){
 				THitSetPointer hitsPointer = new THitSet;
 				TFinder finder(queries[queryid]);
-				_find(*hitsPointer, finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid );	
+				_find(*hitsPointer, finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid, gardener.clipHits);	
 				
 				SEQAN_PRAGMA_IF_PARALLEL(omp critical(addhitmap)  )
 				insert(gardener.hits, queryid, hitsPointer);
@@ -1457,7 +2005,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		
 		// q-gram lemma
 		// w+1−(k+1)q | w=minimum length, k=errors, q=weight(q-grams)
-		TPos minSeedsThreshold = static_cast<TPos>(minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape));
+		TPos minSeedsThreshold = static_cast<TPos>(_minSeedsThreshold(pattern, errorRate, minLength));
 #ifdef TRIPLEX_DEBUG
 		::std::cout << "minLength:" << minLength << " errorRate:" << errorRate << " qgram:" << weight(pattern.shape) << ::std::endl;
 		::std::cout << (ceil(errorRate*minLength)+1) << " " << ((ceil(errorRate*minLength)+1)*weight(pattern.shape)) << " " << minLength+1-(ceil(errorRate*minLength)+1)*weight(pattern.shape) << ::std::endl;
@@ -1476,7 +2024,7 @@ namespace SEQAN_NAMESPACE_MAIN
 			SEQAN_PRAGMA_IF_PARALLEL(omp for schedule(dynamic))
 			for (TId queryid=0; queryid<querylen; ++queryid){
 				TFinder finder(queries[queryid], minRepeatLength, maxRepeatPeriod); 
-				_find(*tmpPointerList[queryid], finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid );	
+				_find(*tmpPointerList[queryid], finder, pattern, errorRate, (TPos) minLength, minSeedsThreshold, xDrop, queryid, gardener.clipHits);	
 			}
 		}
 		
@@ -0,0 +1,198 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_GENOME_REGIONS_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_GENOME_REGIONS_H
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <map>
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Genomic regions
+// ============================================================================
+//
+// Regions are read from a BED file (0-based, end exclusive) and grouped by 
+// sequence name. Overlapping and adjacent regions of a sequence are merged.
+// The sequence of a region is either sliced from a sequence already read or 
+// read directly from the FASTA file using its samtools index (.fai).
+	
+	typedef Pair<__int64, __int64>								TGenomicRegion;	// begin and end position
+	typedef ::std::map< ::std::string, String<TGenomicRegion> >	TRegionMap;		// regions per sequence name
+	
+	// entry of a FASTA index as written by samtools faidx
+	struct FaiEntry
+	{
+		CharString	name;			// sequence name
+		__int64		length;			// number of bases
+		__int64		offset;			// file offset of the first base
+		__int64		lineBases;		// number of bases per line
+		__int64		lineWidth;		// number of bytes per line (including the line break)
+		
+		FaiEntry():
+		length(0), offset(0), lineBases(0), lineWidth(0) {}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// order regions by begin position
+	template <typename TRegion>
+	struct RegionBeginLess : public ::std::binary_function < TRegion, TRegion, bool >
+	{
+		inline bool operator() (TRegion const &a, TRegion const &b) const
+		{
+			if (a.i1 < b.i1) return true;
+			if (a.i1 > b.i1) return false;
+			return a.i2 < b.i2;
+		}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the regions of a BED file, returns false if the file can not be read
+	// or contains malformed entries
+	inline bool readBedRegions(TRegionMap &regions, char const *fileName)
+	{
+		::std::ifstream file(fileName);
+		if (!file.is_open())
+			return false;
+		
+		::std::string line;
+		while (::std::getline(file, line)){
+			// skip empty, comment, track and browser lines
+			if (line.empty() || line[0] == '#' || line.compare(0, 5, "track") == 0 || line.compare(0, 7, "browser") == 0)
+				continue;
+			::std::istringstream fields(line);
+			::std::string chrom;
+			__int64 beginPos, endPos;
+			if (!(fields >> chrom >> beginPos >> endPos) || beginPos < 0 || endPos < beginPos)
+				return false;
+			if (endPos > beginPos)
+				appendValue(regions[chrom], TGenomicRegion(beginPos, endPos), Generous());
+		}
+		
+		// sort and merge the regions of each sequence
+		for (TRegionMap::iterator it = regions.begin(); it != regions.end(); ++it){
+			String<TGenomicRegion> &seqRegions = it->second;
+			::std::sort(begin(seqRegions, Standard()), end(seqRegions, Standard()), RegionBeginLess<TGenomicRegion>());
+			unsigned merged = 0;
+			for (unsigned i = 1; i < length(seqRegions); ++i){
+				if (seqRegions[i].i1 <= seqRegions[merged].i2)
+					seqRegions[merged].i2 = ::std::max(seqRegions[merged].i2, seqRegions[i].i2);
+				else
+					seqRegions[++merged] = seqRegions[i];
+			}
+			resize(seqRegions, merged + 1);
+		}
+		return true;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read a FASTA index, returns false if there is none
+	inline bool readFaiIndex(String<FaiEntry> &index, char const *fileName)
+	{
+		::std::ifstream file(fileName);
+		if (!file.is_open())
+			return false;
+		
+		::std::string line;
+		while (::std::getline(file, line)){
+			if (line.empty())
+				continue;
+			::std::istringstream fields(line);
+			::std::string name;
+			FaiEntry entry;
+			if (!(fields >> name >> entry.length >> entry.offset >> entry.lineBases >> entry.lineWidth) || entry.lineBases <= 0 || entry.lineWidth < entry.lineBases){
+				clear(index);
+				return false;
+			}
+			entry.name = name;
+			appendValue(index, entry, Generous());
+		}
+		return true;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the bases [beginPos, endPos) of an indexed sequence from a FASTA file
+	template <typename TString>
+	inline bool readFaiSlice(TString			&slice,
+							 ::std::istream	&file,
+							 FaiEntry const	&entry,
+							 __int64		beginPos,
+							 __int64		endPos)
+	{
+		clear(slice);
+		if (endPos > entry.length)
+			endPos = entry.length;
+		if (beginPos >= endPos)
+			return true;
+		
+		// file offsets of the first base and behind the last base
+		__int64 first = entry.offset + (beginPos / entry.lineBases) * entry.lineWidth + beginPos % entry.lineBases;
+		__int64 last = entry.offset + ((endPos - 1) / entry.lineBases) * entry.lineWidth + (endPos - 1) % entry.lineBases + 1;
+		
+		String<char> buffer;
+		resize(buffer, (size_t) (last - first), Exact());
+		file.clear();
+		file.seekg(first);
+		if (!file.read(&buffer[0], last - first))
+			return false;
+		
+		reserve(slice, endPos - beginPos, Exact());
+		for (size_t i = 0; i < length(buffer); ++i){
+			if (buffer[i] != '\n' && buffer[i] != '\r')
+				appendValue(slice, buffer[i]);
+		}
+		return length(slice) == (size_t) (endPos - beginPos);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// name of a region as used in the summary, e.g. chr1:1000-2000
+	inline void regionName(CharString &name, CharString const &seqName, TGenomicRegion const &region)
+	{
+		::std::stringstream s;
+		s << seqName << ':' << region.i1 << '-' << region.i2;
+		name = s.str();
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_GENOME_REGIONS_H
@@ -35,6 +35,23 @@
 #ifndef FBUSKE_APPS_TRIPLEXATOR_HELPER_H_
 #define FBUSKE_APPS_TRIPLEXATOR_HELPER_H_
 
+#include <seqan/basic.h>
+
+#if SEQAN_ENABLE_PARALLELISM
+#include <seqan/parallel.h>
+#endif  // #if SEQAN_ENABLE_PARALLELISM
+
+// OpenMP pragmas that compile to nothing without parallelism
+#ifndef SEQAN_PRAGMA_IF_PARALLEL
+#if SEQAN_ENABLE_PARALLELISM
+#define STRINGIFY(a) #a
+#define SEQAN_PRAGMA_IF_PARALLEL(code) \
+_Pragma(STRINGIFY(code))
+#else // SEQAN_ENABLE_PARALLELISM
+#define SEQAN_PRAGMA_IF_PARALLEL(code)
+#endif // SEQAN_ENABLE_PARALLELISM
+#endif // SEQAN_PRAGMA_IF_PARALLEL
+
 using namespace std;
 namespace SEQAN_NAMESPACE_MAIN
 {
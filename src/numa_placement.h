@@ -0,0 +1,202 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_NUMA_PLACEMENT_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_NUMA_PLACEMENT_H
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// NUMA placement
+// ============================================================================
+//
+// The NUMA nodes of the host and their processors are read from sysfs. 
+// Threads are distributed over the nodes in blocks (thread t of n runs on 
+// node t * nodes / n) and pinned to the processors of their node. Memory 
+// that a pinned thread touches first is placed on its node by the kernel, 
+// hence data that a thread allocates and fills itself is local without 
+// requiring libnuma. On other platforms no topology is reported.
+	
+	struct NumaTopology
+	{
+		::std::vector< ::std::vector<int> >	cpus;	// processors per node
+	};
+	
+	// processors a thread was allowed to run on before it was pinned
+	struct ThreadAffinity
+	{
+		bool		saved;
+#if defined(__linux__) && defined(CPU_SET)
+		cpu_set_t	mask;
+#endif
+		
+		ThreadAffinity():
+		saved(false) {}
+	};
+	
+	inline unsigned
+	numaNodes(NumaTopology const &topology)
+	{
+		return topology.cpus.size();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// parse a sysfs list such as "0-3,8,10-11"
+	inline bool
+	_parseNumaList(::std::vector<int> &values, ::std::string const &list)
+	{
+		values.clear();
+		::std::istringstream input(list);
+		::std::string range;
+		while (::std::getline(input, range, ',')){
+			if (range.empty() || range == "\n")
+				continue;
+			int first = 0, last = 0;
+			char dash = 0;
+			::std::istringstream bounds(range);
+			if (!(bounds >> first))
+				return false;
+			if (bounds >> dash){
+				if (dash != '-' || !(bounds >> last))
+					return false;
+			} else 
+				last = first;
+			for (int value = first; value <= last; ++value)
+				values.push_back(value);
+		}
+		return !values.empty();
+	}
+	
+	inline bool
+	_readNumaList(::std::vector<int> &values, ::std::string const &fileName)
+	{
+		::std::ifstream file(fileName.c_str());
+		::std::string list;
+		if (!file.is_open() || !::std::getline(file, list))
+			return false;
+		return _parseNumaList(values, list);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the nodes that have processors, returns false if the topology is unknown
+	inline bool
+	readNumaTopology(NumaTopology &topology)
+	{
+		topology.cpus.clear();
+#if defined(__linux__)
+		::std::string sysfs = "/sys/devices/system/node/";
+		::std::vector<int> nodes;
+		if (!_readNumaList(nodes, sysfs + "online"))
+			return false;
+		for (unsigned i=0; i<nodes.size(); ++i){
+			::std::ostringstream fileName;
+			fileName << sysfs << "node" << nodes[i] << "/cpulist";
+			::std::vector<int> cpus;
+			// memory-only nodes have an empty list
+			if (_readNumaList(cpus, fileName.str()))
+				topology.cpus.push_back(cpus);
+		}
+#endif
+		return !topology.cpus.empty();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// node a thread is placed on
+	inline unsigned
+	numaNodeOfThread(NumaTopology const &topology, int thread, int threads)
+	{
+		if (threads < 1 || numaNodes(topology) == 0)
+			return 0;
+		return (unsigned) (((__int64) thread * numaNodes(topology)) / threads);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// pin the calling thread to the processors of a node
+	inline bool
+	pinThreadToNumaNode(NumaTopology const &topology, unsigned node)
+	{
+#if defined(__linux__) && defined(CPU_SET)
+		if (node >= numaNodes(topology))
+			return false;
+		cpu_set_t mask;
+		CPU_ZERO(&mask);
+		for (unsigned i=0; i<topology.cpus[node].size(); ++i)
+			if (topology.cpus[node][i] < CPU_SETSIZE)
+				CPU_SET(topology.cpus[node][i], &mask);
+		return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#else
+		(void)topology;
+		(void)node;
+		return false;
+#endif
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	// remember the processors the calling thread may run on
+	inline bool
+	saveThreadAffinity(ThreadAffinity &affinity)
+	{
+#if defined(__linux__) && defined(CPU_SET)
+		affinity.saved = sched_getaffinity(0, sizeof(affinity.mask), &affinity.mask) == 0;
+#endif
+		return affinity.saved;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// allow the calling thread to run on the processors it was saved with again
+	inline bool
+	restoreThreadAffinity(ThreadAffinity const &affinity)
+	{
+#if defined(__linux__) && defined(CPU_SET)
+		if (affinity.saved)
+			return sched_setaffinity(0, sizeof(affinity.mask), &affinity.mask) == 0;
+#endif
+		return false;
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_NUMA_PLACEMENT_H
@@ -0,0 +1,266 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_POTENTIAL_TABLE_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_POTENTIAL_TABLE_H
+
+#include <algorithm>
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+#include <seqan/map.h>
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Potential table
+// ============================================================================
+//
+// Open addressing hash table that accumulates the triplex potentials per 
+// pair of sequence numbers (TFO, duplex). Entries are stored densely in the 
+// order of insertion, the slot array only holds entry positions (+1, 0 marks 
+// an empty slot) and is probed linearly. Each thread fills a table of its 
+// own, tables are merged afterwards without locking. Iteration follows the 
+// insertion order, call sortByKey() for a deterministic order.
+	
+	template <typename TKey, typename TCargo>
+	class PotentialTable
+	{
+	public:
+		typedef Pair<TKey, TCargo>	TValue;
+		
+		String<TValue>		entries;	// key/cargo pairs in order of insertion
+		String<unsigned>	slots;		// position+1 of the entry, 0 if empty
+		unsigned			mask;		// number of slots - 1
+		
+		PotentialTable():
+		mask(0) {}
+	};
+	
+// ============================================================================
+// Metafunctions
+// ============================================================================
+	
+	template <typename TKey, typename TCargo>
+	struct Value<PotentialTable<TKey, TCargo> >
+	{
+		typedef Pair<TKey, TCargo> Type;
+	};
+	
+	template <typename TKey, typename TCargo>
+	struct Key<PotentialTable<TKey, TCargo> >
+	{
+		typedef TKey Type;
+	};
+	
+	template <typename TKey, typename TCargo>
+	struct Cargo<PotentialTable<TKey, TCargo> >
+	{
+		typedef TCargo Type;
+	};
+	
+	template <typename TKey, typename TCargo>
+	struct Size<PotentialTable<TKey, TCargo> >
+	{
+		typedef unsigned Type;
+	};
+	
+	template <typename TKey, typename TCargo, typename TSpec>
+	struct Iterator<PotentialTable<TKey, TCargo>, TSpec>
+	{
+		typedef typename Iterator<String<Pair<TKey, TCargo> >, Standard>::Type Type;
+	};
+	
+	template <typename TKey, typename TCargo, typename TSpec>
+	struct Iterator<PotentialTable<TKey, TCargo> const, TSpec>
+	{
+		typedef typename Iterator<String<Pair<TKey, TCargo> > const, Standard>::Type Type;
+	};
+	
+// ============================================================================
+// Functions
+// ============================================================================
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// hash of a pair of sequence numbers
+	template <typename T1, typename T2, typename TSpec>
+	inline unsigned _potentialHash(Pair<T1, T2, TSpec> const &key)
+	{
+		unsigned h = static_cast<unsigned>(key.i1) * 0x9e3779b1u;
+		h ^= static_cast<unsigned>(key.i2) + 0x7f4a7c15u + (h << 6) + (h >> 2);
+		return h ^ (h >> 15);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// number of entries
+	template <typename TKey, typename TCargo>
+	inline unsigned length(PotentialTable<TKey, TCargo> const &me)
+	{
+		return length(me.entries);
+	}
+	
+	template <typename TKey, typename TCargo>
+	inline bool empty(PotentialTable<TKey, TCargo> const &me)
+	{
+		return empty(me.entries);
+	}
+	
+	template <typename TKey, typename TCargo>
+	inline void clear(PotentialTable<TKey, TCargo> &me)
+	{
+		clear(me.entries);
+		clear(me.slots);
+		me.mask = 0;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// iterate over the entries
+	template <typename TKey, typename TCargo, typename TSpec>
+	inline typename Iterator<PotentialTable<TKey, TCargo>, TSpec>::Type
+	begin(PotentialTable<TKey, TCargo> &me, TSpec)
+	{
+		return begin(me.entries, Standard());
+	}
+	
+	template <typename TKey, typename TCargo>
+	inline typename Iterator<PotentialTable<TKey, TCargo>, Standard>::Type
+	begin(PotentialTable<TKey, TCargo> &me)
+	{
+		return begin(me.entries, Standard());
+	}
+	
+	template <typename TKey, typename TCargo, typename TSpec>
+	inline typename Iterator<PotentialTable<TKey, TCargo>, TSpec>::Type
+	end(PotentialTable<TKey, TCargo> &me, TSpec)
+	{
+		return end(me.entries, Standard());
+	}
+	
+	template <typename TKey, typename TCargo>
+	inline typename Iterator<PotentialTable<TKey, TCargo>, Standard>::Type
+	end(PotentialTable<TKey, TCargo> &me)
+	{
+		return end(me.entries, Standard());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// rebuild the slot array for the given number of slots (a power of two)
+	template <typename TKey, typename TCargo>
+	inline void _rehash(PotentialTable<TKey, TCargo> &me, unsigned numSlots)
+	{
+		clear(me.slots);
+		resize(me.slots, numSlots, 0u, Exact());
+		me.mask = numSlots - 1;
+		for (unsigned pos = 0; pos < length(me.entries); ++pos){
+			unsigned slot = _potentialHash(me.entries[pos].i1) & me.mask;
+			while (me.slots[slot] != 0u)
+				slot = (slot + 1) & me.mask;
+			me.slots[slot] = pos + 1;
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// make room for the given number of entries, keeping the load below 1/2
+	template <typename TKey, typename TCargo>
+	inline void reserve(PotentialTable<TKey, TCargo> &me, unsigned size)
+	{
+		unsigned numSlots = 16;
+		while (numSlots < 2 * size)
+			numSlots <<= 1;
+		if (numSlots > length(me.slots))
+			_rehash(me, numSlots);
+		reserve(me.entries, size);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// return the cargo stored for key, NULL if the key is unknown
+	template <typename TKey, typename TCargo>
+	inline TCargo * findCargo(PotentialTable<TKey, TCargo> &me, TKey const &key)
+	{
+		if (empty(me.slots))
+			return NULL;
+		unsigned slot = _potentialHash(key) & me.mask;
+		while (me.slots[slot] != 0u){
+			Pair<TKey, TCargo> &entry = me.entries[me.slots[slot] - 1];
+			if (entry.i1 == key)
+				return &entry.i2;
+			slot = (slot + 1) & me.mask;
+		}
+		return NULL;
+	}
+	
+	template <typename TKey, typename TCargo>
+	inline bool hasKey(PotentialTable<TKey, TCargo> &me, TKey const &key)
+	{
+		return findCargo(me, key) != NULL;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// add a new entry, the key must not be contained yet
+	template <typename TKey, typename TCargo>
+	inline void insert(PotentialTable<TKey, TCargo> &me, Pair<TKey, TCargo> const &value)
+	{
+		if (2 * (length(me.entries) + 1) > length(me.slots))
+			_rehash(me, (length(me.slots) < 16) ? 16u : 2u * (unsigned) length(me.slots));
+		appendValue(me.entries, value, Generous());
+		unsigned slot = _potentialHash(value.i1) & me.mask;
+		while (me.slots[slot] != 0u)
+			slot = (slot + 1) & me.mask;
+		me.slots[slot] = length(me.entries);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// order the entries by key, e.g. by TFO and duplex sequence number
+	template <typename TPair>
+	struct PotentialKeyLess : public ::std::binary_function < TPair, TPair, bool >
+	{
+		inline bool operator() (TPair const &a, TPair const &b) const
+		{
+			return a.i1 < b.i1;
+		}
+	};
+	
+	template <typename TKey, typename TCargo>
+	inline void sortByKey(PotentialTable<TKey, TCargo> &me)
+	{
+		if (length(me.entries) < 2)
+			return;
+		::std::sort(begin(me.entries, Standard()), end(me.entries, Standard()), PotentialKeyLess<Pair<TKey, TCargo> >());
+		_rehash(me, (unsigned) length(me.slots));
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_POTENTIAL_TABLE_H
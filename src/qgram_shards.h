@@ -0,0 +1,235 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_QGRAM_SHARDS_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_QGRAM_SHARDS_H
+
+#include <vector>
+#include <seqan/index.h>
+#include "find_index_qgrams.h"
+#include "gardener.h"
+
+#include "helper.h"
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Sharded q-gram index
+// ============================================================================
+//
+// Splits a TFO motif set into shards of consecutive motifs and builds a 
+// q-gram index per shard, the shards are indexed in parallel. All shards 
+// stay resident while searching. The shards only refer to the motifs of the
+// complete set. A query is planted against 
+// one shard after the other and the hits are merged into a single gardener, 
+// shifting their needle sequence number by the number of the first motif of
+// their shard. Hits therefore refer to the complete motif set, which is the 
+// needle of the shards, as they would with a single index.
+	
+	template <typename TMotifSet, typename TShape>
+	class QGramShards
+	{
+	public:
+		typedef typename Value<TMotifSet>::Type										TMotif;
+		typedef StringSet<TMotif, Dependent<Tight> >								TShardSet;
+		typedef Index<TShardSet, IndexQGram<TShape, OpenAddressing> >				TIndex;
+		typedef Pattern<TIndex, QGramsLookup<TShape, Standard_QGramsLookup> >		TPattern;
+		
+		TMotifSet					*motifs;	// complete motif set
+		TShape						shape;
+		::std::vector<TShardSet *>	sets;		// motifs per shard
+		::std::vector<TIndex *>		indices;	// q-gram index per shard
+		::std::vector<TPattern *>	patterns;	// q-gram lookup per shard
+		::std::vector<unsigned>		offsets;	// number of the first motif per shard
+		
+		QGramShards():
+		motifs(NULL) {}
+		
+		~QGramShards()
+		{
+			for (unsigned i=0; i<sets.size(); ++i){
+				delete patterns[i];
+				delete indices[i];
+				delete sets[i];
+			}
+		}
+		
+	private:
+		// not copyable
+		QGramShards(QGramShards const &);
+		QGramShards & operator=(QGramShards const &);
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// number of shards
+	template <typename TMotifSet, typename TShape>
+	inline unsigned numShards(QGramShards<TMotifSet, TShape> const &shards)
+	{
+		return shards.sets.size();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// the motifs the hits refer to
+	template <typename TMotifSet, typename TShape>
+	inline TMotifSet const & needle(QGramShards<TMotifSet, TShape> const &shards)
+	{
+		return *shards.motifs;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// sample the haystack q-grams looked up in each shard
+	template <typename TMotifSet, typename TShape>
+	inline void setMinimizerWindow(QGramShards<TMotifSet, TShape> &shards, unsigned window)
+	{
+		for (unsigned i=0; i<shards.patterns.size(); ++i)
+			setMinimizerWindow(*shards.patterns[i], window);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Split the motifs into shards of at most shardLength nucleotides (a 
+	// single motif longer than that makes up a shard of its own) and build 
+	// the q-gram index of every shard using the given number of threads
+	template <typename TMotifSet, typename TShape, typename TSize>
+	void createQGramShards(QGramShards<TMotifSet, TShape>	&shards,
+						   TMotifSet						&motifs,
+						   TShape const						&shape,
+						   TSize							shardLength,
+						   int								threads)
+	{
+		typedef QGramShards<TMotifSet, TShape>			TShards;
+		typedef typename TShards::TShardSet				TShardSet;
+		typedef typename TShards::TIndex				TIndex;
+		typedef typename TShards::TPattern				TPattern;
+		
+		shards.motifs = &motifs;
+		shards.shape = shape;
+		
+		TSize shardNucleotides = 0;
+		for (unsigned i=0; i<length(motifs); ++i){
+			if (shards.sets.empty() || (shardNucleotides > 0 && shardNucleotides + length(motifs[i]) > shardLength)){
+				shards.sets.push_back(new TShardSet());
+				shards.offsets.push_back(i);
+				shardNucleotides = 0;
+			}
+			appendValue(*shards.sets.back(), motifs[i], Generous());
+			shardNucleotides += length(motifs[i]);
+		}
+		
+		int count = shards.sets.size();
+		shards.indices.resize(count, (TIndex *) NULL);
+		shards.patterns.resize(count, (TPattern *) NULL);
+		
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) num_threads(threads))
+		for (int i=0; i<count; ++i){
+			shards.indices[i] = new TIndex(*shards.sets[i]);
+			resize(indexShape(*shards.indices[i]), weight(shape));
+			// creating the pattern builds the index
+			shards.patterns[i] = new TPattern(*shards.indices[i], shape);
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Move the hits of a gardener into another one, adding offset to the needle
+	// sequence number of each hit
+	template <typename TId, typename TSpec>
+	inline void _mergeHits(Gardener<TId, TSpec>	&gardener,
+						   Gardener<TId, TSpec>	&source,
+						   TId					offset)
+	{
+		typedef Gardener<TId, TSpec>							TGardener;
+		typedef typename TGardener::THitMap						THitMap;
+		typedef typename TGardener::THitSet						THitSet;
+		typedef typename TGardener::TGardenerHit				THit;
+		typedef typename Iterator<THitMap>::Type				THitMapIter;
+		typedef typename Iterator<THitSet>::Type				THitIter;
+		
+		for (THitMapIter it = begin(source.hits); it != end(source.hits); ++it){
+			TId queryid = (*it).i1;
+			THitSet *hitSet;
+			if (hasKey(gardener.hits, queryid)){
+				hitSet = cargo(gardener.hits, queryid);
+			} else {
+				hitSet = new THitSet;
+				insert(gardener.hits, queryid, hitSet);
+			}
+			for (THitIter itHit = begin(*(*it).i2); itHit != end(*(*it).i2); ++itHit){
+				THit hit = *itHit;
+				hit.ndlSeqNo += offset;
+				add(*hitSet, hit);
+			}
+		}
+		eraseAll(source);
+	}
+	
+	/** 
+	 * start gardening by planting against every shard of a sharded index,
+	 * the hits of all shards are collected in the gardener
+	 */
+	template< 
+	typename TMotifSet,		// motif set (needle)
+	typename TShape,		// shape
+	typename TQuerySet,		// query set (haystack)
+	typename TError,		// error rate
+	typename TSize,			// minimum hit size
+	typename TDrop,			// xdrop
+	typename TSpec,			// specialization
+	typename TId,			// sequence id
+	typename TWorker
+	>
+	void plant(Gardener<TId, TSpec>					&gardener,
+			   QGramShards<TMotifSet, TShape> const	&shards,
+			   TQuerySet							&queries,
+			   TError const							&errorRate,
+			   TSize const							&minLength,
+			   TDrop const							&xDrop,
+			   TWorker
+			   ){
+		for (unsigned i=0; i<numShards(shards); ++i){
+			if (i == 0){
+				// hits of the first shard need no shift
+				plant(gardener, *shards.patterns[i], queries, errorRate, minLength, xDrop, TWorker());
+				continue;
+			}
+			Gardener<TId, TSpec> shardGardener;
+			shardGardener.clipHits = gardener.clipHits;
+			plant(shardGardener, *shards.patterns[i], queries, errorRate, minLength, xDrop, TWorker());
+			_mergeHits(gardener, shardGardener, (TId) shards.offsets[i]);
+		}
+	}
+	
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_QGRAM_SHARDS_H
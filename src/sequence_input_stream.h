@@ -0,0 +1,400 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_SEQUENCE_INPUT_STREAM_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_SEQUENCE_INPUT_STREAM_H
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <streambuf>
+#include <seqan/sequence.h>
+
+#if SEQAN_HAS_ZLIB
+#include <zlib.h>
+#include <seqan/stream.h>
+#endif  // #if SEQAN_HAS_ZLIB
+
+#include "helper.h"
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+	enum INPUT_COMPRESSION
+	{
+		INPUT_PLAIN = 0,			// uncompressed file
+		INPUT_GZIP = 1,				// gzip compressed file
+		INPUT_BGZF = 2				// blocked gzip (BGZF) compressed file
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// determine the compression of a file by its magic bytes
+	inline INPUT_COMPRESSION _inputCompression(char const *fileName)
+	{
+		INPUT_COMPRESSION compression = INPUT_PLAIN;
+#if SEQAN_HAS_ZLIB
+		::std::FILE *file = ::std::fopen(fileName, "rb");
+		if (file == NULL)
+			return compression;
+		char header[18];
+		size_t length = ::std::fread(header, 1, 18, file);
+		::std::fclose(file);
+		if (length >= 2 && header[0] == (char) 0x1f && header[1] == (char) 0x8b){
+			if (length == 18 && _bgzfCheckHeader(header))
+				compression = INPUT_BGZF;
+			else 
+				compression = INPUT_GZIP;
+		}
+#else
+		(void)fileName;
+#endif  // #if SEQAN_HAS_ZLIB
+		return compression;
+	}
+	
+#if SEQAN_HAS_ZLIB
+	
+// ============================================================================
+// gzip/BGZF input
+// ============================================================================
+//
+// Reads gzip or blocked gzip (BGZF) compressed input. BGZF files consist of 
+// independently compressed blocks, hence a batch of blocks is read at once 
+// and its blocks are inflated in parallel. Other gzip files are inflated 
+// serially. 
+// The Fasta reader of SeqAn determines the length of a sequence first and 
+// then seeks back to read it, therefore the buffer retains all decompressed 
+// data starting at the position last reported by tellg(). Seeking is only 
+// supported within the retained data.
+	
+	class GzInputStreamBuf : public ::std::streambuf
+	{
+	public:
+		// maximal uncompressed payload of a BGZF block
+		static const int BLOCK_SIZE = 64 * 1024;
+		// number of blocks per thread that make up a batch
+		static const int BLOCKS_PER_THREAD = 4;
+		
+		GzInputStreamBuf():
+		_file(NULL), _gzFile(NULL), _threads(1), _blocks(NULL), _blockLengths(NULL), _inflated(NULL), _numBlocks(0), 
+		_windowBegin(0), _mark(0), _failed(false) {}
+		
+		~GzInputStreamBuf()
+		{
+			close();
+		}
+		
+		// open file for reading, BGZF blocks are inflated using the given number of threads
+		bool open(char const *fileName, int threads)
+		{
+			close();
+			if (_inputCompression(fileName) == INPUT_BGZF){
+				_file = ::std::fopen(fileName, "rb");
+				if (_file == NULL)
+					return false;
+				_threads = (threads < 1) ? 1 : threads;
+				_numBlocks = _threads * BLOCKS_PER_THREAD;
+				_blocks = new TBlock[_numBlocks];
+				_blockLengths = new int[_numBlocks];
+				_inflated = new int[_numBlocks];
+				for (int i=0; i<_numBlocks; ++i){
+					resize(_blocks[i]._uncompressedBlock, BLOCK_SIZE, Exact());
+					// inflating may look at a few bytes beyond the end of a full block
+					resize(_blocks[i]._compressedBlock, BLOCK_SIZE + 32, Exact());
+				}
+			} else {
+				_gzFile = gzopen(fileName, "rb");
+				if (_gzFile == NULL)
+					return false;
+				_threads = 1;
+				_numBlocks = BLOCKS_PER_THREAD;
+			}
+			clear(_window);
+			_windowBegin = 0;
+			_mark = 0;
+			_failed = false;
+			setg(NULL, NULL, NULL);
+			return true;
+		}
+		
+		bool is_open() const
+		{
+			return _file != NULL || _gzFile != NULL;
+		}
+		
+		void close()
+		{
+			if (_file != NULL)
+				::std::fclose(_file);
+			if (_gzFile != NULL)
+				gzclose(_gzFile);
+			_file = NULL;
+			_gzFile = NULL;
+			delete [] _blocks;
+			delete [] _blockLengths;
+			delete [] _inflated;
+			_blocks = NULL;
+			_blockLengths = NULL;
+			_inflated = NULL;
+			clear(_window);
+			shrinkToFit(_window);
+			setg(NULL, NULL, NULL);
+		}
+		
+	protected:
+		// all retained data has been read, decompress the next batch
+		virtual int_type underflow()
+		{
+			if (gptr() < egptr())
+				return traits_type::to_int_type(*gptr());
+			if (!is_open() || _failed)
+				return traits_type::eof();
+			
+			__int64 position = _position();
+			_discard((_mark < position) ? _mark : position);
+			size_t oldLength = length(_window);
+			if (_file != NULL)
+				_inflateBatch();
+			else 
+				_gunzipBatch();
+			_setGetArea(position);
+			
+			if (length(_window) == oldLength)
+				return traits_type::eof();
+			return traits_type::to_int_type(*gptr());
+		}
+		
+		virtual pos_type seekoff(off_type off, ::std::ios_base::seekdir dir, ::std::ios_base::openmode which)
+		{
+			if ((which & ::std::ios_base::in) == 0)
+				return pos_type(off_type(-1));
+			if (dir == ::std::ios_base::cur){
+				if (off == 0){
+					// tellg() marks the earliest position a later seek may go back to
+					_mark = _position();
+					return pos_type(_mark);
+				}
+				return seekpos(pos_type(_position() + off), which);
+			}
+			if (dir == ::std::ios_base::beg)
+				return seekpos(pos_type(off), which);
+			return pos_type(off_type(-1));
+		}
+		
+		virtual pos_type seekpos(pos_type pos, ::std::ios_base::openmode which)
+		{
+			__int64 position = (off_type) pos;
+			if ((which & ::std::ios_base::in) == 0 || position < _windowBegin || position > _windowBegin + (__int64) length(_window))
+				return pos_type(off_type(-1));
+			_setGetArea(position);
+			return pos;
+		}
+		
+	private:
+		typedef Stream<Bgzf>	TBlock;
+		
+		::std::FILE		*_file;			// BGZF input file
+		gzFile			_gzFile;		// gzip input file
+		int				_threads;		// number of decompression threads
+		TBlock			*_blocks;		// compressed/uncompressed buffers per block of a batch
+		int				*_blockLengths;	// compressed length per block of a batch
+		int				*_inflated;		// uncompressed length per block of a batch
+		int				_numBlocks;		// number of blocks per batch
+		String<char>	_window;		// retained decompressed data
+		__int64			_windowBegin;	// position of the first retained character
+		__int64			_mark;			// position last reported by tellg()
+		bool			_failed;		// reading or decompression failed
+		
+		// not copyable
+		GzInputStreamBuf(GzInputStreamBuf const &);
+		GzInputStreamBuf & operator=(GzInputStreamBuf const &);
+		
+		__int64 _position() const
+		{
+			return _windowBegin + (gptr() - eback());
+		}
+		
+		void _setGetArea(__int64 position)
+		{
+			if (empty(_window)){
+				setg(NULL, NULL, NULL);
+				return;
+			}
+			char *begin = &_window[0];
+			setg(begin, begin + (position - _windowBegin), begin + length(_window));
+		}
+		
+		// drop retained data in front of the given position
+		void _discard(__int64 position)
+		{
+			size_t count = position - _windowBegin;
+			if (count == 0)
+				return;
+			size_t remaining = length(_window) - count;
+			if (remaining > 0)
+				::std::memmove(&_window[0], &_window[0] + count, remaining);
+			resize(_window, remaining);
+			_windowBegin = position;
+		}
+		
+		// read a batch of BGZF blocks and inflate them in parallel
+		void _inflateBatch()
+		{
+			int const BLOCK_HEADER_LENGTH = 18;
+			int blocks = 0;
+			for (; blocks < _numBlocks; ++blocks){
+				char *header = &_blocks[blocks]._compressedBlock[0];
+				size_t count = ::std::fread(header, 1, BLOCK_HEADER_LENGTH, _file);
+				if (count == 0)
+					break;
+				if (count != (size_t) BLOCK_HEADER_LENGTH || !_bgzfCheckHeader(header)){
+					_failed = true;
+					break;
+				}
+				_blockLengths[blocks] = _bgzfUnpackInt16((unsigned char *) &header[16]) + 1;
+				count = _blockLengths[blocks] - BLOCK_HEADER_LENGTH;
+				if (_blockLengths[blocks] < BLOCK_HEADER_LENGTH || ::std::fread(header + BLOCK_HEADER_LENGTH, 1, count, _file) != count){
+					_failed = true;
+					break;
+				}
+			}
+			
+			SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(static) num_threads(_threads) if(_threads > 1 && blocks > 1))
+			for (int i=0; i<blocks; ++i){
+				_inflated[i] = _bgzfInflateBlock(_blocks[i], _blockLengths[i]);
+			}
+			
+			for (int i=0; i<blocks; ++i){
+				if (_inflated[i] < 0){
+					_failed = true;
+					return;
+				}
+				append(_window, prefix(_blocks[i]._uncompressedBlock, _inflated[i]));
+			}
+		}
+		
+		// inflate the next part of a gzip file
+		void _gunzipBatch()
+		{
+			size_t oldLength = length(_window);
+			resize(_window, oldLength + _numBlocks * BLOCK_SIZE);
+			int count = gzread(_gzFile, &_window[0] + oldLength, _numBlocks * BLOCK_SIZE);
+			if (count < 0){
+				_failed = true;
+				count = 0;
+			}
+			resize(_window, oldLength + count);
+		}
+	};
+	
+#endif  // #if SEQAN_HAS_ZLIB
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// input stream reading plain or (if compiled with zlib) gzip/BGZF compressed files
+	class SequenceInputStream : public ::std::istream
+	{
+	public:
+		SequenceInputStream():
+		::std::istream(NULL) {}
+		
+		// open file for reading, compressed files are decompressed using the given number of threads
+		void open(char const *fileName, int threads)
+		{
+#if SEQAN_HAS_ZLIB
+			if (_inputCompression(fileName) != INPUT_PLAIN){
+				if (_gzBuffer.open(fileName, threads))
+					rdbuf(&_gzBuffer);
+				else 
+					setstate(::std::ios_base::failbit);
+				return;
+			}
+#else
+			(void)threads;
+#endif  // #if SEQAN_HAS_ZLIB
+			if (_fileBuffer.open(fileName, ::std::ios_base::in | ::std::ios_base::binary))
+				rdbuf(&_fileBuffer);
+			else 
+				setstate(::std::ios_base::failbit);
+		}
+		
+		bool is_open() const
+		{
+#if SEQAN_HAS_ZLIB
+			if (_gzBuffer.is_open())
+				return true;
+#endif  // #if SEQAN_HAS_ZLIB
+			return _fileBuffer.is_open();
+		}
+		
+		void close()
+		{
+#if SEQAN_HAS_ZLIB
+			_gzBuffer.close();
+#endif  // #if SEQAN_HAS_ZLIB
+			_fileBuffer.close();
+		}
+		
+	private:
+		::std::filebuf		_fileBuffer;
+#if SEQAN_HAS_ZLIB
+		GzInputStreamBuf	_gzBuffer;
+#endif  // #if SEQAN_HAS_ZLIB
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the whole (decompressed) content of a file
+	template <typename TText>
+	inline bool _readWholeFile(TText &text, char const *fileName, int threads)
+	{
+		SequenceInputStream file;
+		file.open(fileName, threads);
+		if (!file.is_open())
+			return false;
+		
+		clear(text);
+		size_t const CHUNK_SIZE = 1024 * 1024;
+		size_t textLength = 0;
+		do {
+			resize(text, textLength + CHUNK_SIZE);
+			file.read(&text[0] + textLength, CHUNK_SIZE);
+			textLength += file.gcount();
+		} while (file);
+		resize(text, textLength);
+		return !file.bad();
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_SEQUENCE_INPUT_STREAM_H
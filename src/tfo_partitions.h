@@ -0,0 +1,259 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TFO_PARTITIONS_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_TFO_PARTITIONS_H
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+#include "checkpoint_journal.h"
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// TFO partitions
+// ============================================================================
+//
+// Results of an incremental search are stored per TFO sequence in a 
+// partition directory, one file with the triplexes (<key>.tpx) and one with 
+// the summary entries (<key>.summary) per TFO sequence. The key is a hash of
+// the name and the nucleotides of the TFO sequence. A manifest lists the 
+// keys of the last run together with a fingerprint of the search parameters:
+//
+//   # triplexator partitions <TAB> fingerprint
+//   key <TAB> name
+//
+// During the search the output of every TFO sequence is buffered and 
+// appended to its partition files once the buffer is full. Appending must 
+// be serialized.
+	
+	static const unsigned TFO_PARTITION_BUFFER_SIZE = 1 << 20;
+	
+	struct TfoPartitionTable
+	{
+		::std::string					directory;	// partition directory, ends with a separator
+		::std::vector< ::std::string >	keys;		// per TFO sequence of the search
+		::std::vector< ::std::string >	triplexes;	// buffered output per TFO sequence
+		::std::vector< ::std::string >	summaries;	// buffered summary entries per TFO sequence
+		bool							active;		// route the output to the partitions
+		
+		TfoPartitionTable():
+		active(false) {}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// use the given directory for the partitions, it is created if necessary
+	inline void
+	setTfoPartitionDirectory(TfoPartitionTable &table, ::std::string const &directory)
+	{
+		table.directory = directory;
+		if (table.directory.empty() || table.directory[table.directory.size() - 1] != '/')
+			table.directory += '/';
+#ifndef PLATFORM_WINDOWS
+		::mkdir(directory.c_str(), 0777);
+#endif
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// key of a TFO sequence, changes with its name or nucleotides
+	template <typename TName, typename TSequence>
+	inline ::std::string
+	tfoPartitionKey(TName const &name, TSequence const &sequence)
+	{
+		::std::ostringstream text;
+		text << name << '\n' << sequence;
+		::std::ostringstream key;
+		key << ::std::hex << _journalHash(text.str());
+		return key.str();
+	}
+	
+	inline ::std::string
+	_tfoPartitionFile(TfoPartitionTable const &table, ::std::string const &key, char const *suffix)
+	{
+		return table.directory + key + suffix;
+	}
+	
+	inline ::std::string
+	_tfoPartitionManifest(TfoPartitionTable const &table)
+	{
+		return table.directory + "partitions.tsv";
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the keys of the previous run, fails if there is none or if it used 
+	// other search parameters
+	inline bool
+	readTfoPartitionManifest(::std::map< ::std::string, ::std::string >	&keys,
+							 TfoPartitionTable const					&table,
+							 ::std::string const						&fingerprint)
+	{
+		keys.clear();
+		::std::ifstream file(_tfoPartitionManifest(table).c_str());
+		::std::string line;
+		if (!file.is_open() || !::std::getline(file, line))
+			return false;
+		if (line != "# triplexator partitions\t" + fingerprint)
+			return false;
+		while (::std::getline(file, line)){
+			size_t tab = line.find('\t');
+			if (tab != line.npos)
+				keys[line.substr(0, tab)] = line.substr(tab + 1);
+		}
+		return true;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// replace the manifest, it is written last such that an interrupted run 
+	// leaves the manifest of the previous run
+	template <typename TNames>
+	inline bool
+	writeTfoPartitionManifest(TfoPartitionTable const				&table,
+							  ::std::vector< ::std::string > const	&keys,
+							  TNames const							&names,
+							  ::std::string const					&fingerprint)
+	{
+		::std::string fileName = _tfoPartitionManifest(table);
+		::std::string workFileName = fileName + ".tmp";
+		::std::ofstream file(workFileName.c_str(), ::std::ios_base::out | ::std::ios_base::trunc);
+		file << "# triplexator partitions\t" << fingerprint << '\n';
+		for (unsigned i=0; i<keys.size(); ++i)
+			file << keys[i] << '\t' << names[i] << '\n';
+		file.close();
+		if (file.fail())
+			return false;
+		return ::std::rename(workFileName.c_str(), fileName.c_str()) == 0;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// prepare empty partitions for the TFO sequences to be searched
+	inline void
+	resetTfoPartitions(TfoPartitionTable					&table,
+					   ::std::vector< ::std::string > const	&keys)
+	{
+		table.keys = keys;
+		table.triplexes.assign(keys.size(), ::std::string());
+		table.summaries.assign(keys.size(), ::std::string());
+		for (unsigned i=0; i<keys.size(); ++i){
+			::std::remove(_tfoPartitionFile(table, keys[i], ".tpx").c_str());
+			::std::remove(_tfoPartitionFile(table, keys[i], ".summary").c_str());
+		}
+		table.active = true;
+	}
+	
+	inline bool
+	_spillTfoPartition(::std::string &buffer, ::std::string const &fileName)
+	{
+		::std::ofstream file(fileName.c_str(), ::std::ios_base::out | ::std::ios_base::app | ::std::ios_base::binary);
+		file.write(buffer.data(), buffer.size());
+		buffer.clear();
+		return file.good();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// append output of a TFO sequence to its partition
+	inline void
+	appendTfoPartition(TfoPartitionTable &table, unsigned seqNo, char const *triplexes, size_t size)
+	{
+		::std::string &buffer = table.triplexes[seqNo];
+		buffer.append(triplexes, size);
+		if (buffer.size() >= TFO_PARTITION_BUFFER_SIZE)
+			_spillTfoPartition(buffer, _tfoPartitionFile(table, table.keys[seqNo], ".tpx"));
+	}
+
+	
+	inline void
+	appendTfoPartitionSummary(TfoPartitionTable &table, unsigned seqNo, ::std::string const &summary)
+	{
+		::std::string &buffer = table.summaries[seqNo];
+		buffer += summary;
+		if (buffer.size() >= TFO_PARTITION_BUFFER_SIZE)
+			_spillTfoPartition(buffer, _tfoPartitionFile(table, table.keys[seqNo], ".summary"));
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// write all buffers, every searched TFO sequence gets its (maybe empty) files
+	inline bool
+	flushTfoPartitions(TfoPartitionTable &table)
+	{
+		bool ok = true;
+		for (unsigned i=0; i<table.keys.size(); ++i){
+			ok = _spillTfoPartition(table.triplexes[i], _tfoPartitionFile(table, table.keys[i], ".tpx")) && ok;
+			ok = _spillTfoPartition(table.summaries[i], _tfoPartitionFile(table, table.keys[i], ".summary")) && ok;
+		}
+		table.active = false;
+		return ok;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// remove the partitions of a TFO sequence that is no longer searched
+	inline void
+	removeTfoPartition(TfoPartitionTable const &table, ::std::string const &key)
+	{
+		::std::remove(_tfoPartitionFile(table, key, ".tpx").c_str());
+		::std::remove(_tfoPartitionFile(table, key, ".summary").c_str());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// copy a partition file to the output
+	template <typename TFile>
+	inline bool
+	copyTfoPartition(TFile &filehandle, TfoPartitionTable const &table, ::std::string const &key, char const *suffix)
+	{
+		::std::ifstream file(_tfoPartitionFile(table, key, suffix).c_str(), ::std::ios_base::in | ::std::ios_base::binary);
+		if (!file.is_open())
+			return false;
+		char buffer[1 << 16];
+		while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+			filehandle.write(buffer, file.gcount());
+		return true;
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TFO_PARTITIONS_H
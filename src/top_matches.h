@@ -0,0 +1,163 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TOP_MATCHES_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_TOP_MATCHES_H
+
+#include <algorithm>
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+#include "helper.h"
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Top matches
+// ============================================================================
+//
+// Keeps the K best triplexes per TFO sequence, ranked by score and then by 
+// guanine rate. Remaining ties are broken by the output line such that the 
+// selection does not depend on the order the duplex sequences are processed
+// in. Each heap keeps its worst entry in front. Once a heap is full, the 
+// score of that entry is published as threshold: candidates of the TFO 
+// sequence that can not reach it are skipped before verification. 
+// Insertions must be serialized, the thresholds may be read concurrently.
+	
+	struct TopMatch
+	{
+		double		score;
+		double		guanineRate;
+		CharString	line;			// formatted output of the triplex
+	};
+	
+	// true if a ranks before b
+	struct TopMatchBetter
+	{
+		bool operator()(TopMatch const &a, TopMatch const &b) const
+		{
+			if (a.score != b.score)
+				return a.score > b.score;
+			if (a.guanineRate != b.guanineRate)
+				return a.guanineRate > b.guanineRate;
+			return a.line < b.line;
+		}
+	};
+	
+	struct TopMatchTable
+	{
+		unsigned					k;
+		String<String<TopMatch> >	heaps;			// per TFO sequence
+		String<int>					thresholds;		// per TFO sequence, score required to enter the heap
+		
+		TopMatchTable():
+		k(0) {}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// prepare empty heaps of size k for the given number of TFO sequences
+	inline void resetTopMatches(TopMatchTable	&table,
+								unsigned		numSeqs,
+								unsigned		k)
+	{
+		table.k = k;
+		clear(table.heaps);
+		resize(table.heaps, numSeqs, Exact());
+		clear(table.thresholds);
+		resize(table.thresholds, numSeqs, 0, Exact());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// minimal score a triplex of the TFO sequence requires to enter the heap
+	inline int topMatchThreshold(TopMatchTable	&table,
+								 unsigned		seqNo)
+	{
+		if (table.k == 0)
+			return 0;
+		int *thresholds = begin(table.thresholds, Standard());
+		int threshold;
+		SEQAN_PRAGMA_IF_PARALLEL(omp atomic read)
+		threshold = thresholds[seqNo];
+		return threshold;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// offer a triplex of the TFO sequence, keeps it if it ranks among the best k
+	inline void insertTopMatch(TopMatchTable	&table,
+							   unsigned			seqNo,
+							   TopMatch const	&entry)
+	{
+		typedef Iterator<String<TopMatch>, Standard>::Type	TIter;
+		
+		String<TopMatch> &heap = table.heaps[seqNo];
+		if (length(heap) < table.k){
+			appendValue(heap, entry, Generous());
+			::std::push_heap(begin(heap, Standard()), end(heap, Standard()), TopMatchBetter());
+		} else if (TopMatchBetter()(entry, front(heap))){
+			TIter heapEnd = end(heap, Standard());
+			::std::pop_heap(begin(heap, Standard()), heapEnd, TopMatchBetter());
+			back(heap) = entry;
+			::std::push_heap(begin(heap, Standard()), heapEnd, TopMatchBetter());
+		} else {
+			return;
+		}
+		
+		if (length(heap) == table.k){
+			int *thresholds = begin(table.thresholds, Standard());
+			int threshold = (int) front(heap).score;
+			SEQAN_PRAGMA_IF_PARALLEL(omp atomic write)
+			thresholds[seqNo] = threshold;
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// output the kept triplexes per TFO sequence, best first
+	template <typename TFile>
+	inline void printTopMatches(TFile			&filehandle,
+								TopMatchTable	&table)
+	{
+		for (unsigned seqNo=0; seqNo<length(table.heaps); ++seqNo){
+			String<TopMatch> &heap = table.heaps[seqNo];
+			::std::sort(begin(heap, Standard()), end(heap, Standard()), TopMatchBetter());
+			for (unsigned i=0; i<length(heap); ++i)
+				filehandle.write(toCString(heap[i].line), length(heap[i].line));
+		}
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TOP_MATCHES_H
@@ -35,6 +35,7 @@
 #ifndef FBUSKE_APPS_TRIPLEXATOR_TRIPLEX_H_
 #define FBUSKE_APPS_TRIPLEXATOR_TRIPLEX_H_
 
+#include <sstream>
 #include <seqan/misc/misc_cmdparser.h>
 #include <seqan/index.h>
 #include <seqan/modifier/modifier_view.h>
@@ -48,21 +49,21 @@
 #include "triplex_alphabet.h"
 #include "triplex_pattern.h"
 #include "gardener.h"
+#include "qgram_shards.h"
+#include "triplex_binary.h"
+#include "bgzf_stream.h"
+#include "sequence_input_stream.h"
+#include "potential_table.h"
+#include "top_matches.h"
+#include "genome_regions.h"
+#include "numa_placement.h"
+#include "checkpoint_journal.h"
+#include "tfo_partitions.h"
 
 #if SEQAN_ENABLE_PARALLELISM
 #include <seqan/parallel.h>
 #endif  // #if SEQAN_ENABLE_PARALLELISM
 
-#ifndef SEQAN_PRAGMA_IF_PARALLEL
-#if SEQAN_ENABLE_PARALLELISM
-#define STRINGIFY(a) #a
-#define SEQAN_PRAGMA_IF_PARALLEL(code) \
-_Pragma(STRINGIFY(code))
-#else // SEQAN_ENABLE_PARALLELISM
-#define SEQAN_PRAGMA_IF_PARALLEL(code)
-#endif // SEQAN_ENABLE_PARALLELISM
-#endif // SEQAN_PRAGMA_IF_PARALLEL
-
 
 #ifdef BOOST
 #include <boost/iostreams/device/file.hpp>
@@ -91,7 +92,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		RUN_SERIAL				= 0,
 		RUN_PARALLEL_TRIPLEX	= 1,
 		RUN_PARALLEL_DUPLEX  	= 2,
-		RUN_PARALLEL_STRANDS	= 3
+		RUN_PARALLEL_STRANDS	= 3,
+		RUN_PARALLEL_TASKS		= 4
 
 	};
 	
@@ -119,7 +121,8 @@ namespace SEQAN_NAMESPACE_MAIN
 	{
 		FORMAT_BED	 	= 0,
 		FORMAT_TRIPLEX  = 1,
-		FORMAT_SUMMARY	= 2
+		FORMAT_SUMMARY	= 2,
+		FORMAT_BINARY	= 3
 	};
 
 	enum TRIPLEX_ERROR
@@ -171,6 +174,42 @@ namespace SEQAN_NAMESPACE_MAIN
 		char			blockClass;		// class of entry
 	};
 	
+	// definition of a triplex detected within a filtered or verified window (positions relative to the window)
+	struct TriplexInterval
+	{
+		unsigned	begin;			// begin position within the window
+		unsigned	end;			// end position within the window
+		unsigned	errors;			// number of interrupting characters
+		int			score;			// number of matching positions
+		int			guanines;		// number of matching guanines
+	};
+	
+	// scratch space for filtering motif strings and verifying windows of TFO/TTS 
+	// pairs, reused from window to window such that no memory is allocated once it has grown
+	struct TriplexVerifyBuffers
+	{
+		// character classes of a window position
+		static const unsigned char VALID = 1;		// extends a segment (parser)
+		static const unsigned char INVALID = 2;		// interrupts a segment (parser)
+		static const unsigned char FILTER = 4;		// counts towards the guanine rate
+		static const unsigned char INTERRUPT = 8;	// counts as error
+		static const unsigned char SCORE = 16;		// TFO and TTS agree
+		static const unsigned char GUANINE = 32;	// TFO and TTS agree on a guanine
+	
+		unsigned char			classes[ValueSize<Triplex>::VALUE];	// class of each triplex character
+		String<unsigned char>	codes;			// classes of the current window
+		String<unsigned>		blockEnd;		// end of the first block run at or behind a position
+		String<TriplexInterval>	intervals;		// triplexes detected in the current window
+	};
+	
+	// scratch space for formatting triplex matches, reused from match to match
+	// such that no memory is allocated once it has grown (output is serialized)
+	struct TriplexOutputBuffers
+	{
+		CharString				text;	// error strings and alignments
+		::std::stringstream		line;	// a match formatted for later output (best triplexes, partitions)
+	};
+	
 	// definition of a triplex match
 	template <typename _TGPos, typename TSize, typename TScore>
 	struct TriplexMatch
@@ -488,11 +527,16 @@ namespace SEQAN_NAMESPACE_MAIN
 		bool		motifGT_p;			// use triplex GT motifs (parallel configuration)
 		bool		motifGT_a;			// use triplex GT motifs (anti-parallel configuration)
 		int			qgramThreshold;		// the threshold used to calculate the weight of the qgram
+		bool		clipHits;			// clip q-gram hits to their longest epsilon-match before verification
+		unsigned	indexShardSize;		// maximal number of TFO nucleotides per q-gram index shard (0 = single index)
+		unsigned	minimizerWindow;	// number of consecutive TTS q-grams sampled by a single lookup (1 = all q-grams)
+		bool		swiftFilter;		// count q-gram hits per diagonal (SWIFT) instead of collecting them per seed
 		bool		bothTFOStrands;		// search both strands of the sequence for TFOs
 		unsigned int minGuanine;		// minimum number of guanines required
 		bool		filterRepeats;		// filter repeats 
 		unsigned	minRepeatLength;	// minimum length of low complex region to be filtered out
 		unsigned	maxRepeatPeriod;	// maximum repeat period defining a low complexity region
+		unsigned	repeatTileSize;		// tile size for searching low complexity regions in parallel (0 = whole sequence)
 		int			duplicatesCutoff;	// threshold above which a feature will not be reported
 		unsigned	minBlockRun;		// minimum number of consecutive matches (block) required for a feature
 		unsigned	detectDuplicates;	// whether and how to detect duplicates 
@@ -506,6 +550,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		CharString	version;			// version info
 		int			runtimeMode;		// parallel runtime mode
 		int			processors;         // number of processors in parallel mode (threads)
+		bool		numaReplicas;		// pin threads and replicate the TFO index per NUMA node (runtime mode 2)
 		__int64		minLength;			// minimum length of a triplex (default 14)
 		__int64		maxLength;			// maximum length of a triplex (default 50)
 		unsigned	maxInterruptions;	// maximum consecutive interruptions
@@ -527,10 +572,16 @@ namespace SEQAN_NAMESPACE_MAIN
 		bool		mergeFeatures;		// combine overlapping features into a feature cluster
 		// 1..Triplex format
 		// 2..summary only
+		bool		potentialOnly;		// only count triplexes for the summary instead of storing every match
+		unsigned	offTargetCap;		// off-target scan: stop searching a TFO sequence after this many triplexes (0 = off)
+		unsigned	topK;				// report only the best triplexes per TFO sequence (0 = all)
 		const char	*runID;				// runID needed for gff output	
 #ifdef BOOST
 		bool		compressOutput;
 #endif
+#if SEQAN_HAS_ZLIB
+		int			bgzfThreads;		// compress output in BGZF format with this number of threads (0 = off)
+#endif
 		
 		// filtration parameters
 		CharString shape;			// shape (e.g. 111111)
@@ -548,9 +599,15 @@ namespace SEQAN_NAMESPACE_MAIN
 		// data
 		StringSet<CharString>	tfoFileNames;
 		StringSet<CharString>	duplexFileNames;
-		
-		// 
-		TGraph triplexParser;
+		CharString				regionFileName;	// BED file restricting the triplex search to these regions
+		CharString				serverSocket;	// Unix domain socket the server listens on
+		bool					checkpoint;		// record finished duplex sequences in a journal
+		bool					resume;			// continue a previous run from its journal
+		CheckpointJournal		journal;		// finished duplex sequences if checkpoint is set
+		CharString				partitionDir;	// directory of the per-TFO results of an incremental search
+		TfoPartitionTable		partitions;		// per-TFO results of the TFO sequences searched incrementally
+		TopMatchTable			topMatches;		// best triplexes per TFO sequence if topK is set
+		TriplexOutputBuffers	outputBuffers;	// scratch space of the triplex output
 		
 		Options()
 		{
@@ -578,6 +635,10 @@ namespace SEQAN_NAMESPACE_MAIN
 			reportDuplicateLocations = false;
 			sameSequenceDuplicates = true;
 			qgramThreshold = 2;
+			clipHits = false;
+			indexShardSize = 0;
+			minimizerWindow = 1;
+			swiftFilter = false;
 			allMatches = false;
 			output = "";
 			outputFolder = "";
@@ -586,6 +647,9 @@ namespace SEQAN_NAMESPACE_MAIN
 			runtimeMode = RUN_SERIAL;
 			filterMode = BRUTE_FORCE;
 			processors= -1;
+			numaReplicas = false;
+			checkpoint = false;
+			resume = false;
 			minLength = 16;
 			maxLength = 30;
 			tolError = 0;
@@ -593,17 +657,24 @@ namespace SEQAN_NAMESPACE_MAIN
 			filterRepeats = 1;
 			minRepeatLength = 10;
 			maxRepeatPeriod = 4;
+			repeatTileSize = 0;
 			
 			prettyString = false;
 			outputFormat = 0;
 			errorReference = WATSON_STAND;
 			mergeFeatures = false;
+			potentialOnly = false;
+			offTargetCap = 0;
+			topK = 0;
 			runID = "s";
 			mixed_parallel_max_guanine     = 1.;
 			mixed_antiparallel_min_guanine = 0.;
 			
 #ifdef BOOST
 			compressOutput = false;
+#endif
+#if SEQAN_HAS_ZLIB
+			bgzfThreads = 0;
 #endif
 			version = "";
 			shape = "11111";
@@ -757,6 +828,14 @@ namespace SEQAN_NAMESPACE_MAIN
 			me.count_M += count;
 	}
 	
+	// add the counts of another potential of the same sequence pair
+	template <typename TId>
+	inline void addCounts(TriplexPotential<TId> & me, TriplexPotential<TId> const & other){
+		me.count_R += other.count_R;
+		me.count_Y += other.count_Y;
+		me.count_M += other.count_M;
+	}
+	
 	template <typename TId>
 	inline bool hasCount(TriplexPotential<TId> & me){
 		if (me.count_R != 0. or me.count_Y != 0. or me.count_M != 0.)
@@ -901,11 +980,17 @@ namespace SEQAN_NAMESPACE_MAIN
 			if (options._debugLevel >= 1)		
 				::std::cerr << "open " << fileName << ::std::endl;
 			
-			filehandle.open(toCString(fileName), ::std::ios_base::out | ::std::ios_base::trunc);
+			// continue the output of a previous run when resuming
+			::std::ios_base::openmode mode = ::std::ios_base::out | (options.journal.resumed ? ::std::ios_base::app : ::std::ios_base::trunc);
+			if (options.outputFormat == FORMAT_BINARY)
+				mode |= ::std::ios_base::binary;
+			filehandle.open(toCString(fileName), mode);
 			if (!filehandle.is_open()) {
 				::std::cerr << "Failed to open temporary output file:" << fileName << ::std::endl;
 				return;
 			}
+			if (options.journal.resumed)
+				filehandle.seekp(0, ::std::ios_base::end);
 		}
 	}
 	
@@ -928,6 +1013,31 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 #endif
 	
+#if SEQAN_HAS_ZLIB
+	void openOutputFile(BgzfOutputStream	&bgzfstream,
+						Options const		&options)
+	{
+		// create output file
+		CharString fileName = options.outputFolder;
+		CharString tmp = "tmp_";
+		if (!empty(options.output) && options.outputFormat!=2){
+			append(tmp, options.output);
+			append(fileName,tmp);
+			append(fileName,".gz");
+			
+			if (options._debugLevel >= 1)		
+				::std::cerr << "open " << fileName << ::std::endl;
+			bgzfstream.open(toCString(fileName), options.bgzfThreads);
+			if (!bgzfstream.is_open()) {
+				::std::cerr << "Failed to open temporary output file:" << fileName << ::std::endl;
+				return;
+			}
+		} else {
+			bgzfstream.attach(stdout, options.bgzfThreads);
+		}
+	}
+#endif
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// finish output
 	template <typename TFile>
@@ -991,6 +1101,40 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 #endif
 	
+#if SEQAN_HAS_ZLIB
+	inline int finishOutputFile(BgzfOutputStream	&bgzfstream,		
+								Options const		&options)
+	{
+		// rename temporary file to final location
+		CharString workFileName = options.outputFolder;
+		CharString fileName = options.outputFolder;
+		if (!empty(options.output) && options.outputFormat!=2){
+			CharString tmp = "tmp_";
+			append(tmp,options.output);
+			append(tmp,".gz");
+			append(workFileName,tmp);
+			append(fileName,options.output);
+			append(fileName,".gz");
+			
+			if (bgzfstream.is_open()){
+				bgzfstream.close();
+			}
+			
+			// remove existing file first
+			if (options._debugLevel >= 1)		
+				::std::cerr << "rename temorary file " << workFileName << " to " << fileName << ::std::endl;
+			::std::remove(toCString(fileName));
+			// rename tmporary file to final destination
+			int result = ::std::rename( toCString(workFileName) , toCString(fileName) );
+			if (result != 0){
+				::std::cerr << "Failed to rename output file " << workFileName << " to " << fileName << ::std::endl;
+				return 1;
+			}
+		} 
+		return 0;
+	}
+#endif
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// close and finish output file
 	template <typename TFile>
@@ -1018,6 +1162,19 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 #endif
 	
+#if SEQAN_HAS_ZLIB
+	inline void closeOutputFile(BgzfOutputStream	&bgzfstream,
+								Options				&options)
+	{
+		if (!empty(options.output) && options.outputFormat!=2){
+			finishOutputFile(bgzfstream, options);
+		} else {
+			// flush remaining blocks to stdout
+			bgzfstream.close();
+		}
+	}
+#endif
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// prepare output
 	void openLogFile(Options &options)
@@ -1033,7 +1190,7 @@ namespace SEQAN_NAMESPACE_MAIN
 			append(fileName,tmp);
 			append(fileName,options.logFileName);
 		}
-		options.logFileHandle.open(toCString(fileName), ::std::ios_base::out | ::std::ios_base::trunc);
+		options.logFileHandle.open(toCString(fileName), ::std::ios_base::out | (options.resume ? ::std::ios_base::app : ::std::ios_base::trunc));
 		if (!options.logFileHandle.is_open()) {
 			::std::cerr << "Failed to create log file:" << fileName << ::std::endl;
 		}
@@ -1101,10 +1258,12 @@ namespace SEQAN_NAMESPACE_MAIN
 			append(fileName,tmp);
 			append(fileName,options.summaryFileName);
 		}
-		options.summaryFileHandle.open(toCString(fileName), ::std::ios_base::out | ::std::ios_base::trunc);
+		// keep the summary of a previous run, it is cut to the journal when resuming
+		options.summaryFileHandle.open(toCString(fileName), ::std::ios_base::out | (options.resume ? ::std::ios_base::app : ::std::ios_base::trunc));
 		if (!options.summaryFileHandle.is_open()) {
 			::std::cerr << "Failed to create temporary summary file:" << fileName << ::std::endl;
 		}
+		options.summaryFileHandle.seekp(0, ::std::ios_base::end);
 	}
 	
 	
@@ -1155,13 +1314,16 @@ namespace SEQAN_NAMESPACE_MAIN
 	
 	
 	//////////////////////////////////////////////////////////////////////////////
-	// print header for triplex file
+	// print column header for triplex matches
 	template <typename TFile>
-	void printTriplexHeader(TFile	&filehandle,		// file handle
-							Options	&options)
+	void printTriplexMatchHeader(TFile		&filehandle,		// file handle
+								 Options	&options)
 	{
 		char _sep_ = '\t';
-		switch (options.outputFormat)
+		if (options.offTargetCap > 0){
+			// off-target scan, count table per TFO sequence
+			filehandle << "# Sequence-ID" << _sep_ << "Off-targets" << _sep_ << "Status" << ::std::endl;
+		} else switch (options.outputFormat)
 		{
 			case 0:	// brief Triplex Format
 				filehandle << "# Sequence-ID" << _sep_ << "TFO start" << _sep_ << "TFO end" << _sep_ << "Duplex-ID" << _sep_ << "TTS start" << _sep_ << "TTS end" << _sep_ << "Score" << _sep_ << "Error-rate" << _sep_ << "Errors" << _sep_ << "Motif" << _sep_ << "Strand" << _sep_ << "Orientation" << _sep_ << "Guanine-rate" << ::std::endl;
@@ -1172,10 +1334,31 @@ namespace SEQAN_NAMESPACE_MAIN
 			default:
 				break;
 		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// print header for triplex file
+	template <typename TFile>
+	void printTriplexHeader(TFile	&filehandle,		// file handle
+							Options	&options)
+	{
+		char _sep_ = '\t';
+		printTriplexMatchHeader(filehandle, options);
 		// summary file 
 		options.summaryFileHandle << "# Duplex-ID" << _sep_ << "Sequence-ID" << _sep_ << "Total (abs)" << _sep_ << "Total (rel)" << _sep_ << "GA (abs)" << _sep_ << "GA (rel)" << _sep_ << "TC (abs)" << _sep_ << "TC (rel)" << _sep_ << "GT (abs)" << _sep_ << "GT (rel)" << ::std::endl;
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// print header and TFO name dictionary for binary triplex file
+	template <typename TFile>
+	void printBinaryHeader(TFile							&filehandle,	// file handle
+						   StringSet<CharString> const	&tfoNames,		// tfo names
+						   Options						&options)
+	{
+		if (options.outputFormat == FORMAT_BINARY)
+			writeBinaryHeader(filehandle, tfoNames);
+	}
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// prepare tfo output
 	template <typename TFile>
@@ -1221,218 +1404,403 @@ namespace SEQAN_NAMESPACE_MAIN
 	
 	
 	//////////////////////////////////////////////////////////////////////////////
-	// Output triplex match alignments
+	// Character of a triplex target site as used for comparison (cf. FunctorTTSMotif)
+	inline Triplex _ttsMaskChar(Triplex x, char strand)
+	{
+		if (strand == '+')
+			return FunctorTTSMotif()(x);
+		return FunctorTTSMotifCompl()(x);
+	}
+	
+	// Character of a triplex target site as used for output (cf. FunctorTTSMotifPretty)
+	inline char _ttsPrettyChar(Triplex x, char strand)
+	{
+		if (strand == '+')
+			return FunctorTTSMotifPretty()(x);
+		return FunctorTTSMotifComplPretty()(x);
+	}
+	
+	// Character of a TFO as used for comparison (cf. ModStringTriplex)
+	inline Triplex _tfoMaskChar(Triplex x, char motif)
+	{
+		if (motif == 'M')
+			return FunctorGTMotif()(x);
+		else if (motif == 'Y')
+			return FunctorTCMotif()(x);
+		return FunctorGAMotif()(x);
+	}
+	
+	// Character of a TFO as used for output (cf. prettyString)
+	inline char _tfoPrettyChar(Triplex x, char motif)
+	{
+		if (motif == 'M')
+			return FunctorGTMotifPretty()(x);
+		else if (motif == 'Y')
+			return FunctorTCMotifPretty()(x);
+		return FunctorGAMotifPretty()(x);
+	}
+	
+	// append a non-negative number to a buffer without going through a stream
+	inline void _appendNumber(CharString &buffer, unsigned number)
+	{
+		char digits[16];
+		unsigned count = 0;
+		do {
+			digits[count++] = '0' + (number % 10);
+			number /= 10;
+		} while (number > 0);
+		while (count > 0)
+			appendValue(buffer, digits[--count]);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Read-only view on the TTS and TFO of a triplex match. Characters are 
+	// translated on the fly from the packed duplex and TFO sequences, which 
+	// avoids materializing ModStringTriplex masks and pretty strings per match.
+	template <typename TDuplex, typename TTfo>
+	struct TriplexMatchView
+	{
+		TDuplex const	&duplex;
+		TTfo const		&tfo;
+		unsigned		dBegin;
+		unsigned		oBegin;
+		unsigned		ttsLength;
+		unsigned		tfoLength;
+		char			strand;			// strand of the TTS
+		char			motif;			// motif of the TFO
+		bool			parallel;		// orientation of the match
+		
+		template <typename TMatch>
+		TriplexMatchView(TMatch const &match, TDuplex const &_duplex, TTfo const &_tfo):
+		duplex(_duplex), tfo(_tfo), dBegin(match.dBegin), oBegin(match.oBegin), 
+		ttsLength(match.dEnd - match.dBegin), tfoLength(match.oEnd - match.oBegin), 
+		strand(match.strand), motif(match.motif), parallel(match.parallel) {}
+		
+		// the TTS of '-' strand matches is the reverse complement of the duplex segment 
+		inline Triplex ttsChar(unsigned i) const
+		{
+			return value(duplex, dBegin + ((strand == '+') ? i : ttsLength - 1 - i));
+		}
+		
+		inline Triplex ttsMask(unsigned i) const
+		{
+			return _ttsMaskChar(ttsChar(i), strand);
+		}
+		
+		inline char ttsPretty(unsigned i) const
+		{
+			return _ttsPrettyChar(ttsChar(i), strand);
+		}
+		
+		// anti-parallel TFOs are compared in reverse
+		inline Triplex tfoMask(unsigned i) const
+		{
+			return _tfoMaskChar(value(tfo, oBegin + (parallel ? i : tfoLength - 1 - i)), motif);
+		}
+		
+		inline char tfoPretty(unsigned i) const
+		{
+			return _tfoPrettyChar(value(tfo, oBegin + i), motif);
+		}
+		
+		// no mask is defined for anti-parallel Y and parallel R motifs
+		inline bool hasTfoMask() const
+		{
+			return parallel ? (motif == 'M' || motif == 'Y') : (motif == 'M' || motif == 'R');
+		}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// append the pretty string of a TTS to a buffer, optionally reversed or complemented
+	template <typename TView>
+	inline void _appendTtsPretty(CharString &buffer, TView const &view, bool reversed, bool complemented)
+	{
+		FunctorComplement<Triplex> complement;
+		for (unsigned i = 0; i < view.ttsLength; ++i){
+			char c = view.ttsPretty(reversed ? view.ttsLength - 1 - i : i);
+			if (complemented)
+				appendValue(buffer, (char) complement(Triplex(c)));
+			else 
+				appendValue(buffer, c);
+		}
+	}
+	
+	// append the pretty string of a TFO to a buffer, optionally reversed
+	template <typename TView>
+	inline void _appendTfoPretty(CharString &buffer, TView const &view, bool reversed)
+	{
+		for (unsigned i = 0; i < view.tfoLength; ++i)
+			appendValue(buffer, view.tfoPretty(reversed ? view.tfoLength - 1 - i : i));
+	}
+	
+	// append the matching ('|') and mismatching ('*') positions of a match to a buffer
+	template <typename TView>
+	inline void _appendMatchLine(CharString &buffer, TView const &view, bool backward)
+	{
+		if (!view.hasTfoMask())
+			return;
+		unsigned n = ::std::min(view.ttsLength, view.tfoLength);
+		for (unsigned i = 0; i < n; ++i){
+			bool equal = backward ? view.ttsMask(view.ttsLength - 1 - i) == view.tfoMask(view.tfoLength - 1 - i) : view.ttsMask(i) == view.tfoMask(i);
+			appendValue(buffer, equal ? '|' : '*');
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Output triplex match alignments, the text is assembled in the given buffer
 	template <
 	typename TMatch,
 	typename TString,
-	typename TMotifSet,
-	typename TFile
+	typename TMotifSet
 	>
-	void dumpAlignment(TMatch		&match,				// forward/reverse matches
-					   TString		&duplex,			// duplex string
-					   TMotifSet	&tfoSet,
-					   TFile		&filehandle,
-					   Options		&options)
+	void _appendAlignment(CharString	&buffer,			// reusable output buffer
+						  TMatch		&match,				// forward/reverse matches
+						  TString		&duplex,			// duplex string
+						  TMotifSet		&tfoSet,
+						  Options		&options)
 	{	
 		if (options.outputFormat != FORMAT_TRIPLEX)
 			return;
 		
-		typedef typename Iterator<TString, Standard>::Type	TIter;
-		typedef typename Value<TMotifSet>::Type				TMotif;
-		TMotif tts_(duplex, match.dBegin, match.dEnd, match.parallel, match.ttsSeqNo, false, match.strand);		
-		TMotif tfo_(host(value(tfoSet,match.tfoNo)), match.oBegin, match.oEnd, match.parallel, value(tfoSet,match.tfoNo).seqNo, true, match.motif);		
-		
-		CharString psTFO = prettyString(tfo_);
-		CharString psTTS = prettyString(tts_);
-		TString opp(psTTS);
-		complement(opp);
+		typedef typename Value<TMotifSet>::Type						TMotif;
+		typedef typename RemoveConst_<typename Host<TMotif>::Type>::Type	TTfo;
+		typedef TriplexMatchView<TString, TTfo>						TView;
+		TView view(match, duplex, host(value(tfoSet,match.tfoNo)));
+		bool parallel = value(tfoSet,match.tfoNo).parallel;
 		
 		if (match.strand == '-'){
-			reverse(opp);
-			reverse(psTTS);
-			filehandle << "     5'- " << opp << " -3'" << ::std::endl;
-			filehandle << "TTS: 3'- " << psTTS << " -5'" << ::std::endl;
-			TIter itTts = begin(tts_);
-			TIter itTtsEnd = end(tts_);
-			TIter itTfo = begin(tfo_);
-			TIter itTfoEnd = end(tfo_);
-			filehandle << "         ";
-			while(itTtsEnd != itTts and itTfoEnd != itTfo){
-				--itTtsEnd;
-				--itTfoEnd;
-				if (*itTtsEnd == *itTfoEnd)
-					filehandle << "|";
-				else
-					filehandle << "*";
-			}
-			filehandle << ::std::endl;
-			if (!value(tfoSet,match.tfoNo).parallel){
-				filehandle << "TFO: 5'- " << psTFO << " -3'" << ::std::endl;
+			append(buffer, "     5'- ");
+			_appendTtsPretty(buffer, view, true, true);
+			append(buffer, " -3'\nTTS: 3'- ");
+			_appendTtsPretty(buffer, view, true, false);
+			append(buffer, " -5'\n         ");
+			_appendMatchLine(buffer, view, true);
+			if (!parallel){
+				append(buffer, "\nTFO: 5'- ");
+				_appendTfoPretty(buffer, view, false);
+				append(buffer, " -3'\n");
 			} else {
-				reverse(psTFO);
-				filehandle << "TFO: 3'- " << psTFO << " -5'" << ::std::endl;
+				append(buffer, "\nTFO: 3'- ");
+				_appendTfoPretty(buffer, view, true);
+				append(buffer, " -5'\n");
 			}
 		} else { // '+' strand
-			if (!value(tfoSet,match.tfoNo).parallel){
-				reverse(psTFO);
-				filehandle << "TFO: 3'- " << psTFO << " -5'" << ::std::endl;
+			if (!parallel){
+				append(buffer, "TFO: 3'- ");
+				_appendTfoPretty(buffer, view, true);
+				append(buffer, " -5'\n         ");
 			} else {
-				filehandle << "TFO: 5'- " << psTFO << " -3'" << ::std::endl;
-			}
-			TIter itTts = begin(tts_);
-			TIter itTtsEnd = end(tts_);
-			TIter itTfo = begin(tfo_);
-			TIter itTfoEnd = end(tfo_);
-			filehandle << "         ";
-			while(itTts != itTtsEnd and itTfo != itTfoEnd){
-				if (*itTts == *itTfo)
-					filehandle << "|";
-				else
-					filehandle << "*";
-				++itTts;
-				++itTfo;
+				append(buffer, "TFO: 5'- ");
+				_appendTfoPretty(buffer, view, false);
+				append(buffer, " -3'\n         ");
 			}
-			filehandle << ::std::endl;
-			filehandle << "TTS: 5'- " << psTTS <<  " -3'" << ::std::endl;
-			filehandle << "     3'- " << opp <<  " -5'" << ::std::endl;
+			_appendMatchLine(buffer, view, false);
+			append(buffer, "\nTTS: 5'- ");
+			_appendTtsPretty(buffer, view, false, false);
+			append(buffer, " -3'\n     3'- ");
+			_appendTtsPretty(buffer, view, false, true);
+			append(buffer, " -5'\n");
 		}
-		filehandle << ::std::endl;
+		appendValue(buffer, '\n');
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// Output triplex match alignments
+	template <
+	typename TMatch,
+	typename TString,
+	typename TMotifSet,
+	typename TFile
+	>
+	void dumpAlignment(TMatch		&match,				// forward/reverse matches
+					   TString		&duplex,			// duplex string
+					   TMotifSet	&tfoSet,
+					   TFile		&filehandle,
+					   Options		&options)
+	{	
+		CharString &buffer = options.outputBuffers.text;
+		clear(buffer);
+		_appendAlignment(buffer, match, duplex, tfoSet, options);
+		filehandle.write(toCString(buffer), length(buffer));
+	}
 	
 	//////////////////////////////////////////////////////////////////////////////
-	// get error string for triplex matches
+	// append the error string of a triplex match to the given buffer
 	template <
 	typename TMatch,
 	typename TString,
 	typename TMotifSet
 	>
-	CharString _errorString(TMatch		&match,				// forward/reverse matches
+	void _appendErrorString(CharString	&buffer,			// reusable output buffer
+							TMatch		&match,				// forward/reverse matches
 							TString		&duplex,			// duplex string
 							TMotifSet 	&tfoSet,
 							Options		&options)
 	{	
-		std::ostringstream errors;
-		
-		typedef typename Iterator<TString, Standard>::Type	TIter;
-		typedef typename Value<TMotifSet>::Type				TMotif;
-		TMotif tts_(duplex, match.dBegin, match.dEnd, match.parallel, match.ttsSeqNo, false, match.strand);		
-		TMotif tfo_(host(value(tfoSet,match.tfoNo)), match.oBegin, match.oEnd, match.parallel, value(tfoSet,match.tfoNo).seqNo, true, match.motif);		
-		
-		CharString psTFO = prettyString(tfo_);
-		CharString psTTS = prettyString(tts_);
-		
+		typedef typename Value<TMotifSet>::Type						TMotif;
+		typedef typename RemoveConst_<typename Host<TMotif>::Type>::Type	TTfo;
+		typedef TriplexMatchView<TString, TTfo>						TView;
+		TView view(match, duplex, host(value(tfoSet,match.tfoNo)));
+		bool parallel = value(tfoSet,match.tfoNo).parallel;
+		
+		// positions are reported with respect to the reference strand, which 
+		// determines the direction of comparison and of the pretty strings
+		bool backward;			// compare TTS and TFO from their ends
+		bool tfoReversed;		// TFO pretty string is reversed
 		if (options.errorReference == WATSON_STAND){
 			// requires consideration of pruine tract and parallel/anti-parallel triplex formation
-			if (match.strand == '-'){
-				reverse(psTTS);
-				if (value(tfoSet,match.tfoNo).parallel) 
-					reverse(psTFO);
-				//				::std::cerr << "\n" << psTTS << "\n" << psTFO << "\n" << tts_ << "\n" << tfo_ << "\n";
-				TIter itTts = begin(tts_);
-				TIter itTtsEnd = end(tts_);
-				TIter itTfo = begin(tfo_);
-				TIter itTfoEnd = end(tfo_);
-				unsigned i = 0;
-				while(itTtsEnd != itTts and itTfoEnd != itTfo){
-					--itTtsEnd;
-					--itTfoEnd;
-					if (*itTtsEnd != *itTfoEnd){
-						if (! isupper(value(psTTS,i)) && ! isupper(value(psTFO,i))) errors << 'b' << i;
-						else if (! isupper(value(psTTS,i))) errors << 'd' << i;
-						else if (! isupper(value(psTFO,i))) errors << 'o' << i;	
-						else errors << 't' << i;
-					}
-					++i;
-				}			
-			} else { // '+' strand
-				if (!value(tfoSet,match.tfoNo).parallel)
-					reverse(psTFO);
-				//				::std::cerr << "\n" << psTTS << "\n" << psTFO << "\n" << tts_ << "\n" << tfo_ << "\n";
-				TIter itTts = begin(tts_);
-				TIter itTtsEnd = end(tts_);
-				TIter itTfo = begin(tfo_);
-				TIter itTfoEnd = end(tfo_);
-				unsigned i = 0;
-				while(itTts != itTtsEnd && itTfo != itTfoEnd){
-					if (*itTts != *itTfo){
-						if (! isupper(value(psTTS,i)) && ! isupper(value(psTFO,i))) errors << 'b' << i;
-						else if (! isupper(value(psTTS,i))) errors << 'd' << i;
-						else if (! isupper(value(psTFO,i))) errors << 'o' << i;		
-						else errors << 't' << i;
-					}
-					++itTts;
-					++itTfo;
-					++i;
-				}
-			}
+			backward = (match.strand == '-');
+			tfoReversed = backward ? parallel : !parallel;
 		} else if (options.errorReference == PURINE_STRAND){ 
 			// only requires adjustment of anti-parallel binding third strands
-			if (!value(tfoSet,match.tfoNo).parallel) 
-				reverse(psTFO);
-			//			::std::cerr << "\n" << psTTS << "\n" << psTFO << "\n" << tts_ << "\n" << tfo_ << "\n";
-			
-			TIter itTts = begin(tts_);
-			TIter itTtsEnd = end(tts_);
-			TIter itTfo = begin(tfo_);
-			TIter itTfoEnd = end(tfo_);
-			unsigned i = 0;
-			while(itTts != itTtsEnd && itTfo != itTfoEnd){
-				if (*itTts != *itTfo){
-					if (! isupper(value(psTTS,i)) && ! isupper(value(psTFO,i))) errors << 'b' << i;
-					else if (! isupper(value(psTTS,i))) errors << 'd' << i;
-					else if (! isupper(value(psTFO,i))) errors << 'o' << i;	
-					else errors << 't' << i;
-				}
-				++itTts;
-				++itTfo;
-				++i;
-			}
+			backward = false;
+			tfoReversed = !parallel;
 		} else if (options.errorReference == THIRD_STRAND){
 			// requires consideration of parallel/anti-parallel binding
-			if (value(tfoSet,match.tfoNo).parallel) {
-				//				::std::cerr << "\n" << psTTS << "\n" << psTFO << "\n" << tts_ << "\n" << tfo_ << "\n";
-				TIter itTts = begin(tts_);
-				TIter itTtsEnd = end(tts_);
-				TIter itTfo = begin(tfo_);
-				TIter itTfoEnd = end(tfo_);
-				unsigned i = 0;
-				while(itTts != itTtsEnd && itTfo != itTfoEnd){
-					if (*itTts != *itTfo){
-						if (! isupper(value(psTTS,i)) && ! isupper(value(psTFO,i))) errors << 'b' << i;
-						else if (! isupper(value(psTTS,i))) errors << 'd' << i;
-						else if (! isupper(value(psTFO,i))) errors << 'o' << i;		
-						else errors << 't' << i;
-					}
-					++itTts;
-					++itTfo;
-					++i;
-				}
-			} else {
-				reverse(psTTS);
-				//				::std::cerr << "\n" << psTTS << "\n" << psTFO << "\n" << tts_ << "\n" << tfo_ << "\n";
-				TIter itTts = begin(tts_);
-				TIter itTtsEnd = end(tts_);
-				TIter itTfo = begin(tfo_);
-				TIter itTfoEnd = end(tfo_);
-				unsigned i = 0;
-				while(itTtsEnd != itTts and itTfoEnd != itTfo){
-					--itTtsEnd;
-					--itTfoEnd;
-					if (*itTtsEnd != *itTfoEnd){
-						if (! isupper(value(psTTS,i)) && ! isupper(value(psTFO,i))) errors << 'b' << i;
-						else if (! isupper(value(psTTS,i))) errors << 'd' << i;
-						else if (! isupper(value(psTFO,i))) errors << 'o' << i;	
-						else errors << 't' << i;
-					}
-					++i;
-				}
-			}
+			backward = !parallel;
+			tfoReversed = false;
+		} else 
+			return;
+		
+		if (!view.hasTfoMask())
+			return;
+		
+		unsigned n = ::std::min(view.ttsLength, view.tfoLength);
+		for (unsigned i = 0; i < n; ++i){
+			unsigned ttsPos = backward ? view.ttsLength - 1 - i : i;
+			unsigned tfoPos = backward ? view.tfoLength - 1 - i : i;
+			if (view.ttsMask(ttsPos) == view.tfoMask(tfoPos))
+				continue;
+			// the TTS pretty string is reversed whenever the comparison runs backwards
+			bool ttsUpper = isupper(view.ttsPretty(ttsPos));
+			bool tfoUpper = isupper(view.tfoPretty(tfoReversed ? view.tfoLength - 1 - i : i));
+			if (!ttsUpper && !tfoUpper) appendValue(buffer, 'b');
+			else if (!ttsUpper) appendValue(buffer, 'd');
+			else if (!tfoUpper) appendValue(buffer, 'o');
+			else appendValue(buffer, 't');
+			_appendNumber(buffer, i);
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// get error string for triplex matches
+	template <
+	typename TMatch,
+	typename TString,
+	typename TMotifSet
+	>
+	CharString _errorString(TMatch		&match,				// forward/reverse matches
+							TString		&duplex,			// duplex string
+							TMotifSet 	&tfoSet,
+							Options		&options)
+	{	
+		CharString errors;
+		_appendErrorString(errors, match, duplex, tfoSet, options);
+		return errors;
+	}
+	
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Output triplex matches of a duplex as binary chunk, error strings are dropped
+	template <
+	typename TMatches,
+	typename TMotifSet,
+	typename TFile
+	>
+	void _printTriplexBinary(TMatches		&matches,			// forward/reverse matches
+							 CharString		&duplexName,		// duplex name
+							 TMotifSet const	&tfoSet,		// set of tfos
+							 TFile			&filehandle,		// output file
+							 __int64		offset				// position of the searched sequence within the duplex
+							 ){
+		typedef typename Iterator<TMatches, Standard>::Type		TIter;
+		
+		if (empty(matches))
+			return;
+		
+		TriplexBinaryChunk chunk;
+		unsigned n = length(matches);
+		reserve(chunk.tfoSeqNo, n, Exact());
+		reserve(chunk.oBegin, n, Exact());
+		reserve(chunk.oEnd, n, Exact());
+		reserve(chunk.dBegin, n, Exact());
+		reserve(chunk.dEnd, n, Exact());
+		reserve(chunk.mScore, n, Exact());
+		reserve(chunk.guanines, n, Exact());
+		reserve(chunk.motif, n, Exact());
+		reserve(chunk.strand, n, Exact());
+		reserve(chunk.orientation, n, Exact());
+		
+		chunk.duplexName = duplexName;
+		chunk.duplexSeqNo = (unsigned) (*begin(matches, Standard())).ttsSeqNo;
+		for (TIter it = begin(matches, Standard()); it != end(matches, Standard()); ++it){
+			appendValue(chunk.tfoSeqNo, (unsigned) value(tfoSet,(*it).tfoNo).seqNo);
+			appendValue(chunk.oBegin, (__int64) (*it).oBegin);
+			appendValue(chunk.oEnd, (__int64) (*it).oEnd);
+			appendValue(chunk.dBegin, offset + (*it).dBegin);
+			appendValue(chunk.dEnd, offset + (*it).dEnd);
+			appendValue(chunk.mScore, (double) (*it).mScore);
+			appendValue(chunk.guanines, (double) (*it).guanines);
+			appendValue(chunk.motif, (*it).motif);
+			appendValue(chunk.strand, (*it).strand);
+			appendValue(chunk.orientation, ((*it).parallel?'P':'A'));
+		}
+		writeBinaryChunk(filehandle, chunk);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Output a single triplex match, buffer is used to assemble error strings and alignments
+	template <
+	typename TFile,
+	typename TMatch,
+	typename TString,
+	typename TMotifSet
+	>
+	inline void _printTriplexMatch(TFile						&filehandle,
+								   CharString					&buffer,
+								   TMatch						&match,
+								   unsigned						seqNo,		// TFO sequence of the match
+								   CharString					&duplexName,
+								   TString						&duplex,
+								   TMotifSet const				&tfoSet,
+								   StringSet<CharString> const	&tfoNames,
+								   Options						&options,
+								   __int64						offset
+								   ){
+		char _sep_ = '\t';
+		clear(buffer);
+		switch (options.outputFormat)
+		{
+			case 0:	// brief Triplex Format
+				_appendErrorString(buffer, match, duplex, tfoSet, options);
+				filehandle << tfoNames[seqNo] << _sep_ << match.oBegin << _sep_ << match.oEnd << _sep_ ;
+				filehandle << duplexName << _sep_ << (offset + match.dBegin) << _sep_ << (offset + match.dEnd) << _sep_ ;
+				filehandle << match.mScore << _sep_ << ::std::setprecision(2) << (1.0-match.mScore/(match.dEnd-match.dBegin)) << _sep_ ;
+				filehandle << buffer << _sep_ << match.motif << _sep_ << match.strand << _sep_ <<  (match.parallel?'P':'A') << _sep_ <<  (match.guanines/(match.dEnd-match.dBegin)) << '\n';
+				break;
+			case 1:	// extended Triplex Format
+				_appendErrorString(buffer, match, duplex, tfoSet, options);
+				filehandle << tfoNames[seqNo] << _sep_ << match.oBegin << _sep_ << match.oEnd << _sep_ ;
+				filehandle << duplexName << _sep_ << (offset + match.dBegin) << _sep_ << (offset + match.dEnd) << _sep_ ;
+				filehandle << match.mScore << _sep_ << ::std::setprecision(2) << (1.0-match.mScore/(match.dEnd-match.dBegin)) << _sep_ ;
+				filehandle << buffer << _sep_ << match.motif << _sep_ << match.strand << _sep_ <<  (match.parallel?'P':'A') << _sep_ <<  (match.guanines/(match.dEnd-match.dBegin)) << '\n';
+				clear(buffer);
+				_appendAlignment(buffer, match, duplex, tfoSet, options);
+				filehandle.write(toCString(buffer), length(buffer));
+				break;
+			default:
+				break;
 		}
-		//		::std::cerr << errors.str() << "\n";
-		return errors.str();
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// copy what has been written to the line buffer since it was rewound
+	inline void _readLine(CharString &text, ::std::stringstream &line)
+	{
+		resize(text, (unsigned) line.tellp());
+		line.seekg(0);
+		line.read(begin(text, Standard()), length(text));
+	}
 	
 	//////////////////////////////////////////////////////////////////////////////
 	// Output triplex matches
@@ -1448,37 +1816,61 @@ namespace SEQAN_NAMESPACE_MAIN
 						   TMotifSet const				&tfoSet,	// set of tfos
 						   StringSet<CharString> const	&tfoNames,	// tfo names (read from Fasta file, currently unused)
 						   TFile		&filehandle,				// output file
-						   Options		&options
+						   Options		&options,
+						   __int64		offset = 0					// position of the searched sequence (e.g. a region) within the duplex
 						   ){
 		typedef typename Iterator<TMatches, Standard>::Type		TIter;
 		typedef typename Value<TMatches>::Type					TMatch;
 		typedef ::std::list<TMatch>								TMatchList;
 		typedef unsigned										TKey;
 		
-		char _sep_ = '\t';
-		for (TIter it = begin(matches, Standard()); it != end(matches, Standard());++it){
-			TMatch match = (*it);
-			TKey seqNo = value(tfoSet,match.tfoNo).seqNo;
-			switch (options.outputFormat)
-			{
-				case 0:	// brief Triplex Format
-					filehandle << tfoNames[seqNo] << _sep_ << match.oBegin << _sep_ << match.oEnd << _sep_ ;
-					filehandle << duplexName << _sep_ << match.dBegin << _sep_ << match.dEnd << _sep_ ;
-					filehandle << match.mScore << _sep_ << ::std::setprecision(2) << (1.0-match.mScore/(match.dEnd-match.dBegin)) << _sep_ ;
-					filehandle << _errorString(match, duplex, tfoSet, options) << _sep_ << match.motif << _sep_ << match.strand << _sep_ <<  (match.parallel?'P':'A') << _sep_ <<  (match.guanines/(match.dEnd-match.dBegin)) << ::std::endl;
-					break;
-				case 1:	// extended Triplex Format
-					filehandle << tfoNames[seqNo] << _sep_ << match.oBegin << _sep_ << match.oEnd << _sep_ ;
-					filehandle << duplexName << _sep_ << match.dBegin << _sep_ << match.dEnd << _sep_ ;
-					filehandle << match.mScore << _sep_ << ::std::setprecision(2) << (1.0-match.mScore/(match.dEnd-match.dBegin)) << _sep_ ;
-					filehandle << _errorString(match, duplex, tfoSet, options) << _sep_ << match.motif << _sep_ << match.strand << _sep_ <<  (match.parallel?'P':'A') << _sep_ <<  (match.guanines/(match.dEnd-match.dBegin)) << ::std::endl;
-					dumpAlignment(match, duplex, tfoSet, filehandle, options);
-					break;
-				default:
-					break;
-			}
+		if (options.outputFormat == FORMAT_BINARY){
+			_printTriplexBinary(matches, duplexName, tfoSet, filehandle, offset);
+			return;
 		}
-	}
+		
+		// error strings, alignments and matches kept for later are assembled in 
+		// buffers that are reused for all matches
+		CharString &buffer = options.outputBuffers.text;
+		::std::stringstream &line = options.outputBuffers.line;
+		line.precision(2);
+		if (options.topK > 0){
+			// keep only the best matches per TFO sequence, they are output at the end
+			TopMatch entry;
+			for (TIter it = begin(matches, Standard()); it != end(matches, Standard());++it){
+				TMatch &match = (*it);
+				TKey seqNo = value(tfoSet,match.tfoNo).seqNo;
+				if (match.mScore < topMatchThreshold(options.topMatches, seqNo))
+					continue;
+				line.seekp(0);
+				_printTriplexMatch(line, buffer, match, seqNo, duplexName, duplex, tfoSet, tfoNames, options, offset);
+				entry.score = match.mScore;
+				entry.guanineRate = match.guanines/(match.dEnd-match.dBegin);
+				_readLine(entry.line, line);
+				insertTopMatch(options.topMatches, seqNo, entry);
+			}
+			return;
+		}
+		
+		if (options.partitions.active){
+			// incremental search, the matches are stored in the partition of their TFO sequence
+			for (TIter it = begin(matches, Standard()); it != end(matches, Standard());++it){
+				TMatch &match = (*it);
+				TKey seqNo = value(tfoSet,match.tfoNo).seqNo;
+				line.seekp(0);
+				_printTriplexMatch(line, buffer, match, seqNo, duplexName, duplex, tfoSet, tfoNames, options, offset);
+				_readLine(buffer, line);
+				appendTfoPartition(options.partitions, seqNo, toCString(buffer), length(buffer));
+			}
+			return;
+		}
+		
+		for (TIter it = begin(matches, Standard()); it != end(matches, Standard());++it){
+			TMatch &match = (*it);
+			TKey seqNo = value(tfoSet,match.tfoNo).seqNo;
+			_printTriplexMatch(filehandle, buffer, match, seqNo, duplexName, duplex, tfoSet, tfoNames, options, offset);
+		}
+	}
 	
 	// output single TTS hit
 	template<typename TFile, typename TEntry, typename TDuplexNames>
@@ -1632,12 +2024,10 @@ namespace SEQAN_NAMESPACE_MAIN
 	void dumpTfoMatches(TFile				&filehandle,
 						TMotifSet			&tfoMotifSet,
 						TSeqNames const		&tfoIDs,		// tfo names (read from Fasta file, currently unused)
+						unsigned			&counter,		// running number of the entries, continued across calls
 						Options				&options)
 	{
-		typedef typename Value<TMotifSet>::Type					TMotif;
 		typedef typename Iterator<TMotifSet, Standard>::Type	TIter;
-		unsigned counter;
-		
 		
 		// nothing found?
 		if (length(tfoMotifSet)==0){
@@ -1649,7 +2039,6 @@ namespace SEQAN_NAMESPACE_MAIN
 		switch (options.outputFormat)
 		{
 			case 0:	// brief Triplex Format
-				counter = 1;
 				for(TIter it = begin(tfoMotifSet, Standard()); it != end(tfoMotifSet, Standard()); ++it){
 					if ((*it).motif == '-')
 						continue;
@@ -1658,7 +2047,6 @@ namespace SEQAN_NAMESPACE_MAIN
 				break;
 				
 			case 1:	// Bed format
-				counter = 1;
 				for(TIter it = begin(tfoMotifSet, Standard()); it != end(tfoMotifSet, Standard()); ++it){
 					printTfoEntry(filehandle, *it, counter, tfoIDs, options);
 				}
@@ -1670,6 +2058,23 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 	
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// Output matches
+	template <
+	typename TFile,
+	typename TMotifSet,
+	typename TSeqNames
+	>
+	void dumpTfoMatches(TFile				&filehandle,
+						TMotifSet			&tfoMotifSet,
+						TSeqNames const		&tfoIDs,		// tfo names (read from Fasta file, currently unused)
+						Options				&options)
+	{
+		unsigned counter = 1;
+		dumpTfoMatches(filehandle, tfoMotifSet, tfoIDs, counter, options);
+	}
+	
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// Output summary entries
 	template <
@@ -1749,9 +2154,32 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef typename Key<TPotValue>::Type			TPotKey;
 		typedef typename Cargo<TPotValue>::Type			TPotCargo;
 		
+		// candidates skipped by the top-k threshold are not counted
+		if (options.topK > 0)
+			return;
+		
 		// summary
 		char _sep_ = '\t';
 		
+		// report sequence pairs in the order of the TFOs
+		sortByKey(tpots);
+		if (options.partitions.active){
+			// incremental search, the entries are stored in the partition of their TFO sequence
+			::std::ostringstream line;
+			line.precision(3);
+			for(TPotIter it = begin(tpots); it != end(tpots); ++it){
+				TPotCargo tpot = cargo(*it);
+				if (!hasCount(tpot))
+					continue;
+				line.str("");
+				line << duplexName << _sep_ << tfoNames[getKey(tpot).i1] << _sep_ << getCounts(tpot) << _sep_ << ::std::setprecision(3) << (getCounts(tpot)/getNorm(tpot)) << _sep_;
+				line << getCount(tpot,'R') << _sep_ << ::std::setprecision(3) << (getCount(tpot,'R')/getNorm(tpot)) << _sep_;
+				line << getCount(tpot,'Y') << _sep_ << ::std::setprecision(3) << (getCount(tpot,'Y')/getNorm(tpot)) << _sep_;
+				line << getCount(tpot,'M') << _sep_ << ::std::setprecision(3) << (getCount(tpot,'M')/getNorm(tpot)) << _sep_ << ::std::endl;
+				appendTfoPartitionSummary(options.partitions, getKey(tpot).i1, line.str());
+			}
+			return;
+		}
 		for(TPotIter it = begin(tpots); it != end(tpots); ++it){
 			TPotValue tpotvalue = *it;
 			TPotCargo tpot = cargo(tpotvalue);
@@ -1789,6 +2217,20 @@ namespace SEQAN_NAMESPACE_MAIN
 		return qgramWeight;
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// q-gram hits per match guaranteed when sampling one out of every 
+	// minimizerWindow consecutive TTS q-grams (see _minSeedsThreshold)
+	inline int _sampledSeedsThreshold(Options &options){
+		int errors = static_cast<int>(ceil(options.errorRate*options.minLength));
+		if (options.maximalError >=0)
+			errors  = min(errors, options.maximalError);
+		int window = max(1, static_cast<int>(options.minimizerWindow));
+		int sampled = static_cast<int>(options.minLength) - errors - (errors+1)*(static_cast<int>(length(options.shape))+window-2);
+		if (sampled <= 0)
+			return sampled;
+		return (sampled + window - 1) / window;
+	}
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// produce a timestamp for the log file
 	CharString _getTimeStamp(){
@@ -1802,6 +2244,508 @@ namespace SEQAN_NAMESPACE_MAIN
 		return buffer;
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// Checkpointing
+	//
+	// Every duplex sequence whose results have been written is recorded in a 
+	// journal next to the temporary output file. A resumed run reads the 
+	// journal, cuts the temporary output and summary files to the results of 
+	// the finished sequences, and skips these sequences. The journal is only
+	// accepted for the same TFO file, TFO motifs and search parameters.
+	
+	// duplex file (name, size and modification time) and parameters that 
+	// determine the output of a triplex search
+	inline ::std::string _searchParameterText(Options const &options)
+	{
+		::std::ostringstream text;
+		text << options.duplexFileNames[0] << '\t' << _fileStamp(toCString(options.duplexFileNames[0])) << '\t' << options.outputFormat << '\t' << options.errorReference << '\t' << options.prettyString;
+		text << '\t' << options.minLength << '\t' << options.maxLength << '\t' << options.errorRate << '\t' << options.maximalError << '\t' << options.maxInterruptions;
+		text << '\t' << options.minGuanineRate << '\t' << options.maxGuanineRate << '\t' << options.minBlockRun << '\t' << options.allMatches;
+		text << '\t' << options.forward << options.reverse << '\t' << options.filterMode << '\t' << options.qgramThreshold << options.clipHits;
+		text << '\t' << options.filterRepeats << '\t' << options.minRepeatLength << '\t' << options.maxRepeatPeriod;
+		text << '\t' << options.motifTC << options.motifGA << options.motifGT_p << options.motifGT_a << '\t' << options.mixed_parallel_max_guanine << '\t' << options.mixed_antiparallel_min_guanine;
+		text << '\t' << options.regionFileName;
+		return text.str();
+	}
+	
+	template <typename TMotifSet>
+	inline void setCheckpointFingerprint(TMotifSet		&tfoMotifSet,
+										 Options		&options)
+	{
+		typedef typename Iterator<TMotifSet, Standard>::Type	TIter;
+		
+		::std::ostringstream text;
+		text << options.tfoFileNames[0] << '\t' << _fileStamp(toCString(options.tfoFileNames[0])) << '\t' << _searchParameterText(options);
+		for (TIter itr = begin(tfoMotifSet, Standard()); itr != end(tfoMotifSet, Standard()); ++itr)
+			text << '\t' << (*itr).seqNo << ',' << beginPosition(*itr) << ',' << length(*itr) << ',' << (*itr).motif << ',' << (*itr).parallel;
+		setJournalFingerprint(options.journal, text.str());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the journal of a previous run and cut the temporary files accordingly,
+	// without a matching journal the search starts from the beginning
+	inline void resumeCheckpoint(Options &options)
+	{
+		CheckpointJournal &journal = options.journal;
+		CharString prefix = options.outputFolder;
+		append(prefix, "tmp_");
+		append(prefix, options.output);
+		CharString summaryName = prefix;
+		append(summaryName, ".summary");
+		journal.fileName = toCString(prefix);
+		journal.fileName += ".journal";
+		
+		journal.resumed = options.resume && readCheckpointJournal(journal);
+		if (options.resume && !journal.resumed)
+			options.logFileHandle << _getTimeStamp() << " * No journal of a previous run with the same TFOs and parameters, starting from the beginning" << ::std::endl;
+		if (journal.resumed && !_truncateFile(toCString(prefix), journal.outputSize)){
+			options.logFileHandle << _getTimeStamp() << " * Could not continue the output file " << prefix << ", starting from the beginning" << ::std::endl;
+			journal.resumed = false;
+		}
+		if (!journal.resumed)
+			journal.finished.clear();
+		else
+			options.logFileHandle << _getTimeStamp() << " * Resuming the search, skipping " << journal.finished.size() << " finished duplex sequences" << ::std::endl;
+		
+		// the summary file has been opened for appending
+		if (options.resume){
+			options.summaryFileHandle.close();
+			_truncateFile(toCString(summaryName), journal.resumed ? journal.summarySize : 0);
+			openSummaryFile(options);
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// start recording once the headers have been written
+	template <typename TFile>
+	inline bool startCheckpointJournal(TFile	&outputfile,
+									   Options	&options)
+	{
+		outputfile.flush();
+		options.summaryFileHandle.flush();
+		return openCheckpointJournal(options.journal, (__int64) outputfile.tellp(), (__int64) options.summaryFileHandle.tellp());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// record a duplex sequence after its results have been output
+	template <typename TFile>
+	inline void _recordCheckpoint(TFile				&outputfile,
+								  __int64			seqNo,
+								  CharString const	&duplexName,
+								  Options			&options)
+	{
+		if (!options.checkpoint)
+			return;
+		outputfile.flush();
+		options.summaryFileHandle.flush();
+		recordCheckpoint(options.journal, seqNo, duplexName, (__int64) outputfile.tellp(), (__int64) options.summaryFileHandle.tellp());
+	}
+	
+	inline bool _isCheckpointed(__int64 seqNo, Options const &options)
+	{
+		return options.checkpoint && isCheckpointed(options.journal, seqNo);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// find low complexity regions once and mask them in place, 
+	// the regions are kept in repeats for reuse
+	template <typename TSequence, typename TRepeatString>
+	inline void _filterLowComplexityRegions(TSequence		&sequence,
+											TRepeatString	&repeats,
+											Options const	&options
+											){
+		findLowComplexityRegions(repeats, sequence, options.minRepeatLength, options.maxRepeatPeriod, options.repeatTileSize);
+		maskLowComplexityRegions(sequence, repeats, 'N');
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Character counted as an error by the triplex filter of a motif string, 
+	// TFO motif strings mask non-binding characters with 'N'
+	template <typename TTag>
+	inline char _motifInterruptChar(TTag const &)
+	{
+		return 'N';
+	}
+	
+	// TTS motif strings mask pyrimidines with 'Y'
+	inline char _motifInterruptChar(TTS const &)
+	{
+		return 'Y';
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Character class of a motif string character with respect to the triplex filter,
+	// guanines count towards the guanine rate and interrupting characters as errors
+	template <typename TTag>
+	inline unsigned char _filterClass(Triplex		x,
+									  Options const	&options,
+									  TTag const &
+									  ){
+		Triplex filterChar = 'G';
+		Triplex interruptChar = _motifInterruptChar(TTag());
+		// if no guanine rate restriction, then collapse filter and tolerated chars
+		if (options.minGuanineRate <= 0.0){
+			x = FunctorRYFilter()(x);
+			filterChar = 'R';
+		}
+		if (x == filterChar)
+			return TriplexVerifyBuffers::FILTER;
+		if (x == interruptChar)
+			return TriplexVerifyBuffers::INTERRUPT;
+		return 0;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Set up the character classes for filtering motif strings of the given motif
+	template <typename TTag>
+	inline void _prepareFilterBuffers(TriplexVerifyBuffers	&buffers,
+									  Options const			&options,
+									  TTag const &
+									  ){
+		for (unsigned v=0; v<ValueSize<Triplex>::VALUE; ++v){
+			Triplex x;
+			x.value = v;
+			buffers.classes[v] = _filterClass(x, options, TTag());
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Set up the character classes for verifying windows, which correspond to 
+	// the TTS parser (valid "GAR", interrupting "TCYN") and to the filter classes 
+	// of the TTS motif string of a segment
+	inline void _prepareVerifyBuffers(TriplexVerifyBuffers	&buffers,
+									  Options const			&options
+									  ){
+		for (unsigned v=0; v<ValueSize<Triplex>::VALUE; ++v){
+			Triplex x;
+			x.value = v;
+			unsigned char cls = _filterClass(FunctorTTSMotif()(x), options, TTS());
+			if (x == 'G' || x == 'A' || x == 'R')
+				cls |= TriplexVerifyBuffers::VALID;
+			else if (x == 'T' || x == 'C' || x == 'Y' || x == 'N')
+				cls |= TriplexVerifyBuffers::INVALID;
+			if (x != 'N')
+				cls |= TriplexVerifyBuffers::SCORE;
+			if (x == 'G')
+				cls |= TriplexVerifyBuffers::GUANINE;
+			buffers.classes[v] = cls;
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Record for each position of the classified string where the first run of
+	// minBlockRun non-interrupting characters at or behind that position ends
+	inline void _findBlockRuns(TriplexVerifyBuffers	&buffers,
+							   unsigned				len,
+							   Options const		&options
+							   ){
+		resize(buffers.blockEnd, len + 1, Generous());
+		unsigned char const *codes = begin(buffers.codes, Standard());
+		unsigned *blockEnd = begin(buffers.blockEnd, Standard());
+		unsigned const minBlockRun = options.minBlockRun;
+		
+		unsigned pending = 0;	// first position still waiting for a block run
+		unsigned run = 0;		// non-interrupting characters in front of position i
+		for (unsigned i=0; i<=len; ++i){
+			if (run >= minBlockRun){
+				for (; pending + minBlockRun <= i; ++pending)
+					blockEnd[pending] = i;
+			}
+			if (i < len)
+				run = (codes[i] & TriplexVerifyBuffers::INTERRUPT) ? 0 : run + 1;
+		}
+		for (; pending <= len; ++pending)
+			blockEnd[pending] = MaxValue<unsigned>::VALUE;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Remove the leftmost position of a verification window
+	inline void _shrinkVerifyWindow(unsigned char const	*codes,
+									unsigned			&pos,
+									int					&filter_chars,
+									int					&interrupt_chars,
+									int					&nonfilter_chars
+									){
+		unsigned char cls = codes[pos];
+		filter_chars -= (cls & TriplexVerifyBuffers::FILTER) != 0;
+		interrupt_chars -= (cls & TriplexVerifyBuffers::INTERRUPT) != 0;
+		nonfilter_chars -= (cls & TriplexVerifyBuffers::FILTER) == 0;
+		++pos;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Append the next position to a verification window
+	inline void _growVerifyWindow(unsigned char const	*codes,
+								  unsigned				&pos,
+								  int					&filter_chars,
+								  int					&interrupt_chars,
+								  int					&nonfilter_chars
+								  ){
+		unsigned char cls = codes[pos];
+		filter_chars += (cls & TriplexVerifyBuffers::FILTER) != 0;
+		interrupt_chars += (cls & TriplexVerifyBuffers::INTERRUPT) != 0;
+		nonfilter_chars += (cls & TriplexVerifyBuffers::FILTER) == 0;
+		++pos;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Store a triplex of the current window together with its score and guanines
+	inline void _addVerifiedMatch(TriplexVerifyBuffers	&buffers,
+								  unsigned				start,
+								  unsigned				end,
+								  unsigned				errors
+								  ){
+		unsigned char const *codes = begin(buffers.codes, Standard());
+		TriplexInterval interval;
+		interval.begin = start;
+		interval.end = end;
+		interval.errors = errors;
+		interval.score = 0;
+		interval.guanines = 0;
+		for (unsigned i=start; i<end; ++i){
+			if (codes[i] & TriplexVerifyBuffers::SCORE)
+				++interval.score;
+			if (codes[i] & TriplexVerifyBuffers::GUANINE)
+				++interval.guanines;
+		}
+		appendValue(buffers.intervals, interval, Generous());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Filter the segment [segBegin,segEnd) of the current window with the 
+	// requested guanine rate AND the error rate on the precomputed character classes
+	// returns the total number of matches (all_matches) that comply to the 
+	// defined constraints, matches are only counted but not added if countOnly is set
+	template <ORIENTATION TOrientation, typename TTag>
+	inline unsigned _verifySegment(TriplexVerifyBuffers	&buffers,
+								   unsigned				segBegin,
+								   unsigned				segEnd,
+								   bool					countOnly,
+								   Options const		&options,
+								   TTag const &
+								   ){
+		unsigned char const *codes = begin(buffers.codes, Standard()) + segBegin;
+		unsigned const *blockEnd = begin(buffers.blockEnd, Standard()) + segBegin;
+		unsigned const len = segEnd - segBegin;
+		
+		double max_error = floor(len*options.errorRate);
+		if (options.maximalError >= 0)
+			max_error = min(max_error, double(options.maximalError));
+		double max_tolerated = (floor(len*(1.0-options.minGuanineRate)));
+		unsigned max_length = len;
+		if (options.maxLength >= options.minLength)
+			max_length = options.maxLength;
+		
+		int cnt_filter_chars = 0;
+		int cnt_interrupt_chars = 0;
+		int cnt_nonfilter_chars = 0;
+		bool is_match = false;
+		unsigned tmp_start = 0;
+		unsigned tmp_end = 0;
+		unsigned tmp_error = 0;
+		unsigned covered_end = 0;
+		unsigned itLeft = 0;
+		unsigned itRight = 0;
+		unsigned totalNumberOfMatches = 0;
+		
+		// there must be another valid blockrun
+		while (blockEnd[itLeft] <= segEnd && itLeft+options.minLength <= len){
+			// obey minimum length 
+			while (itRight-itLeft < options.minLength && itRight < len){
+				while (itRight-itLeft < options.minLength && itRight < len)
+					_growVerifyWindow(codes, itRight, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
+				
+				// obey maximum error
+				while (cnt_interrupt_chars > max_error)
+					_shrinkVerifyWindow(codes, itLeft, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
+				
+				// obey maximum filterchars 
+				while (cnt_nonfilter_chars > max_tolerated)
+					_shrinkVerifyWindow(codes, itLeft, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
+				
+				// hit cannot start with interrupting char
+				while (itLeft < len && (codes[itLeft] & TriplexVerifyBuffers::INTERRUPT))
+					_shrinkVerifyWindow(codes, itLeft, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
+				
+				if (itRight < itLeft){
+					itRight = itLeft;
+					cnt_filter_chars = 0;
+					cnt_interrupt_chars = 0;
+					cnt_nonfilter_chars = 0;
+				}
+			}
+			
+			// cannot fulfil minimum length constraint
+			if (itRight-itLeft < options.minLength)
+				break;
+			
+			is_match = false;
+			// got a minimum length segment that does not violate maximum constraints
+			// extend to the right as far as possible
+			while (cnt_interrupt_chars <= max_error && cnt_nonfilter_chars <= max_tolerated && itRight-itLeft <= max_length){
+				double filter_chars_rate = double(cnt_filter_chars)/(itRight-itLeft);
+				double interrupt_chars_rate = double(cnt_interrupt_chars)/(itRight-itLeft);
+				if (blockEnd[itLeft] <= segBegin + itRight && !(codes[itRight-1] & TriplexVerifyBuffers::INTERRUPT)
+					&& interrupt_chars_rate <= options.errorRate 
+					&& options.minGuanineRate <= filter_chars_rate && filter_chars_rate <= options.maxGuanineRate
+					&& _motifSpecificConstraints(filter_chars_rate, interrupt_chars_rate, TOrientation, options, TTag()))
+				{
+					is_match = true;
+					++totalNumberOfMatches;
+					tmp_start = itLeft;
+					tmp_end = itRight;
+					tmp_error = cnt_interrupt_chars;
+					// add match straight away if all matches should be reported
+					if (options.allMatches && !countOnly){
+						_addVerifiedMatch(buffers, segBegin + tmp_start, segBegin + tmp_end, tmp_error);
+						covered_end = tmp_end;
+						is_match = false; // prevent redundant addition
+					}
+				}
+				
+				if (itRight < len){
+					_growVerifyWindow(codes, itRight, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
+				} else {
+					break;
+				}
+			}
+			if (is_match && tmp_end > covered_end && !countOnly){
+				_addVerifiedMatch(buffers, segBegin + tmp_start, segBegin + tmp_end, tmp_error);
+				covered_end = tmp_end;
+			}
+			// increase leftmost pointer & skip errors
+			++itLeft;
+			while (itLeft < len && (codes[itLeft] & TriplexVerifyBuffers::INTERRUPT))
+				++itLeft;
+			
+			itRight = itLeft;
+			cnt_filter_chars = 0;
+			cnt_interrupt_chars = 0;
+			cnt_nonfilter_chars = 0;
+		}
+		return totalNumberOfMatches;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Verify a window of a TFO/TTS pair with a single pass over both sequences.
+	// Yields the same triplexes as masking the mismatching positions with 'N', 
+	// splitting the masked string with the TTS parser and filtering each segment
+	// with _filterWithGuanineAndErrorRate, but neither copies the sequences nor
+	// allocates memory once the buffers have grown. Windows with less than
+	// minMatches agreeing positions are rejected straight away.
+	// Returns the total number of matches, the triplexes themselves are kept in 
+	// buffers.intervals unless countOnly is set.
+	template <typename TTfoIter, typename TTtsIter>
+	inline unsigned _verifyWindow(TriplexVerifyBuffers	&buffers,
+								  TTfoIter				itTfo,
+								  TTtsIter				itTts,
+								  unsigned				windowLength,
+								  int					minMatches,
+								  bool					countOnly,
+								  Options const			&options
+								  ){
+		clear(buffers.intervals);
+		resize(buffers.codes, windowLength, Generous());
+		unsigned char *codes = begin(buffers.codes, Standard());
+		unsigned char const maskedClass = buffers.classes[ordValue(Triplex('N'))];
+		
+		// classify the positions, mismatches are treated like 'N'
+		int matching = 0;
+		for (unsigned i=0; i<windowLength; ++i, ++itTfo, ++itTts){
+			unsigned char cls = maskedClass;
+			if (*itTfo == *itTts){
+				cls = buffers.classes[ordValue(*itTts)];
+				++matching;
+			}
+			codes[i] = cls;
+		}
+		// the score of any triplex within the window is bounded by its matching positions
+		if (matching < minMatches)
+			return 0;
+		_findBlockRuns(buffers, windowLength, options);
+		
+		// split the window into segments like the TTS parser does, allowing up 
+		// to maxInterruptions consecutive invalid characters within a segment
+		unsigned totalNumberOfMatches = 0;
+		unsigned segBegin = 0;
+		int state = -1;		// -1: segment start, 0: valid character, >0: consecutive interruptions
+		for (unsigned i=0; i<windowLength; ++i){
+			if (codes[i] & TriplexVerifyBuffers::VALID){
+				state = 0;
+			} else if ((codes[i] & TriplexVerifyBuffers::INVALID) && state >= 0 && state < (int) options.maxInterruptions){
+				++state;
+			} else {
+				// segment ends before the trailing interruptions
+				unsigned segEnd = i - _min(options.maxInterruptions, i - segBegin);
+				if (segEnd - segBegin >= options.minLength)
+					totalNumberOfMatches += _verifySegment<TRIPLEX_ORIENTATION_BOTH>(buffers, segBegin, segEnd, countOnly, options, TTS());
+				segBegin = i + 1;
+				state = -1;
+			}
+		}
+		// last segment
+		if (windowLength - segBegin >= options.minLength)
+			totalNumberOfMatches += _verifySegment<TRIPLEX_ORIENTATION_BOTH>(buffers, segBegin, windowLength, countOnly, options, TTS());
+		return totalNumberOfMatches;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Filter a string with the requested guanine rate AND the error rate
+	// returns the total number of matches (all_matches) that comply to the 
+	// defined constraints, matches are only counted but not added if countOnly is set
+	// The motif tag and the binding orientation are resolved at compile time, 
+	// the characters are classified with the table set up by _prepareFilterBuffers
+	template <ORIENTATION TOrientation, typename TMotifSet, typename TTag>
+	inline unsigned _filterWithGuanineAndErrorRate(TMotifSet						&patternString,
+												   typename Value<TMotifSet>::Type	&pattern,
+												   TriplexVerifyBuffers				&buffers,
+												   bool								reduceSet,
+												   Options const					&options,
+												   TTag const &,
+												   bool								countOnly = false
+												   ){
+		typedef typename Value<TMotifSet>::Type								TPattern;
+		typedef typename Iterator<TPattern, Standard>::Type					TIter;
+		typedef typename Iterator<String<TriplexInterval>, Standard>::Type	TIntervalIter;
+		
+		TMotifSet tmp_pattern_set;
+		TMotifSet* ptr_pattern_set;
+		if (reduceSet){
+			ptr_pattern_set = &tmp_pattern_set;
+		} else {
+			ptr_pattern_set = &patternString;
+		}
+		
+		unsigned len = length(pattern);
+		clear(buffers.intervals);
+		resize(buffers.codes, len, Generous());
+		unsigned char *codes = begin(buffers.codes, Standard());
+		TIter it = begin(pattern, Standard());
+		for (unsigned i=0; i<len; ++i, ++it)
+			codes[i] = buffers.classes[ordValue(*it)];
+		_findBlockRuns(buffers, len, options);
+		
+		unsigned totalNumberOfMatches = _verifySegment<TOrientation>(buffers, 0, len, countOnly, options, TTag());
+		for (TIntervalIter itr=begin(buffers.intervals, Standard()); itr!=end(buffers.intervals, Standard()); ++itr){
+#ifdef TRIPLEX_DEBUG		
+			::std::cerr << "add match:" << infix(pattern, itr->begin, itr->end) << " errors: " << itr->errors << ::std::endl;
+#endif	
+			_addMatch(*ptr_pattern_set, pattern, itr->begin, itr->end, itr->errors, TTag());
+		}
+		
+		// reduce motif set for triplex search
+		if (reduceSet){
+#ifdef TRIPLEX_DEBUG	
+			::std::cerr << "# Elements before merging:" << length(tmp_pattern_set) << ::std::endl;
+#endif			
+			_reduceMotifSet(patternString, tmp_pattern_set);
+		} 
+#ifdef TRIPLEX_DEBUG
+		::std::cerr << "# Elements final patterns:" << length(patternString) << ::std::endl;
+#endif			
+		return totalNumberOfMatches;
+	}
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// Search a sequence compatible with the TC-motif and add these for parallel binding
 	template <typename TOligoMotifSet, typename TString, typename TId>
@@ -1830,10 +2774,12 @@ namespace SEQAN_NAMESPACE_MAIN
 		_parse(seqString,parser, sequence, options);
 		
 		// convert tfo sequences into matching tts to allow pattern search
+		TriplexVerifyBuffers buffers;
+		_prepareFilterBuffers(buffers, options, PYRIMIDINEMOTIF());
 		unsigned totalNumberOfMatches = 0;
 		for (TSegStringIter it = begin(seqString, Standard()); it != end(seqString, Standard()); ++it){
 			TTfoMotif tfomotif(*it, true, tfoSeqNo, true, 'Y');
-			totalNumberOfMatches += _filterWithGuanineAndErrorRate(motifSet, tfomotif, 'G', 'N', reduceSet, TRIPLEX_ORIENTATION_PARALLEL, options, PYRIMIDINEMOTIF());
+			totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_PARALLEL>(motifSet, tfomotif, buffers, reduceSet, options, PYRIMIDINEMOTIF());
 		}
 		return totalNumberOfMatches;
 	}
@@ -1866,10 +2812,12 @@ namespace SEQAN_NAMESPACE_MAIN
 		_parse(seqString,parser, sequence, options);
 		
 		// convert tfo sequences into matching tts to allow pattern search
+		TriplexVerifyBuffers buffers;
+		_prepareFilterBuffers(buffers, options, PURINEMOTIF());
 		unsigned totalNumberOfMatches = 0;
 		for (TSegStringIter it = begin(seqString, Standard()); it != end(seqString, Standard()); ++it){
 			TTfoMotif tfomotif(*it, false, tfoSeqNo, true, 'R');
-			totalNumberOfMatches += _filterWithGuanineAndErrorRate(motifSet, tfomotif, 'G', 'N', reduceSet, TRIPLEX_ORIENTATION_ANTIPARALLEL, options, PURINEMOTIF());
+			totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_ANTIPARALLEL>(motifSet, tfomotif, buffers, reduceSet, options, PURINEMOTIF());
 		}
 		return totalNumberOfMatches;
 	}
@@ -1906,6 +2854,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		_parse(seqString,parser, sequence, options);
 		
 		// convert tfo sequences into matching tts to allow pattern search
+		TriplexVerifyBuffers buffers;
+		_prepareFilterBuffers(buffers, options, MIXEDMOTIF());
 		unsigned totalNumberOfMatches = 0;
 		for (TSegStringIter it = begin(seqString, Standard()); it != end(seqString, Standard()); ++it){
 #ifdef TRIPLEX_DEBUG
@@ -1913,11 +2863,17 @@ namespace SEQAN_NAMESPACE_MAIN
 #endif
 			if ((orientation == TRIPLEX_ORIENTATION_BOTH || orientation == TRIPLEX_ORIENTATION_PARALLEL) && options.mixed_parallel_max_guanine >= options.minGuanineRate){
 				TTfoMotif tfomotif(*it, true, tfoSeqNo, true, 'M');
-				totalNumberOfMatches += _filterWithGuanineAndErrorRate(motifSet, tfomotif, 'G', 'N', reduceSet, orientation, options, MIXEDMOTIF());
+				if (orientation == TRIPLEX_ORIENTATION_BOTH)
+					totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_BOTH>(motifSet, tfomotif, buffers, reduceSet, options, MIXEDMOTIF());
+				else
+					totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_PARALLEL>(motifSet, tfomotif, buffers, reduceSet, options, MIXEDMOTIF());
 			}
 			if ((orientation == TRIPLEX_ORIENTATION_BOTH || orientation == TRIPLEX_ORIENTATION_ANTIPARALLEL) && options.mixed_antiparallel_min_guanine <= options.maxGuanineRate){
 				TTfoMotif tfomotif_rev(*it, false, tfoSeqNo, true, 'M');
-				totalNumberOfMatches += _filterWithGuanineAndErrorRate(motifSet, tfomotif_rev, 'G', 'N', reduceSet, orientation, options, MIXEDMOTIF());
+				if (orientation == TRIPLEX_ORIENTATION_BOTH)
+					totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_BOTH>(motifSet, tfomotif_rev, buffers, reduceSet, options, MIXEDMOTIF());
+				else
+					totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_ANTIPARALLEL>(motifSet, tfomotif_rev, buffers, reduceSet, options, MIXEDMOTIF());
 			}
 		}
 		return totalNumberOfMatches;
@@ -1958,6 +2914,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		_parse(seqString, parser, duplex, options);
 		
 		// process one segment at a time
+		TriplexVerifyBuffers buffers;
+		_prepareFilterBuffers(buffers, options, TTS());
 		unsigned totalNumberOfMatches = 0;
 		for (TSegStringIter it = begin(seqString, Standard()); it != end(seqString, Standard()); ++it){
 #ifdef TRIPLEX_DEBUG
@@ -1965,15 +2923,32 @@ namespace SEQAN_NAMESPACE_MAIN
 #endif
 			if (plusstrand){
 				TTtsMotif ttsfilter(*it, true, seqNo, false, '+');
-				totalNumberOfMatches += _filterWithGuanineAndErrorRate(ttsSet, ttsfilter, 'G', 'Y', reduceSet, TRIPLEX_ORIENTATION_BOTH, options, TTS());
+				totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_BOTH>(ttsSet, ttsfilter, buffers, reduceSet, options, TTS());
 			} else {
 				TTtsMotif ttsfilter(*it, true, seqNo, false, '-');
-				totalNumberOfMatches += _filterWithGuanineAndErrorRate(ttsSet, ttsfilter, 'G', 'Y', reduceSet, TRIPLEX_ORIENTATION_BOTH, options, TTS());
+				totalNumberOfMatches += _filterWithGuanineAndErrorRate<TRIPLEX_ORIENTATION_BOTH>(ttsSet, ttsfilter, buffers, reduceSet, options, TTS());
 			}
 		}
 		return totalNumberOfMatches;
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// Append motif sets that were detected independently (e.g. one per sequence 
+	// in parallel) to a common motif set, keeping the order of the sets
+	template <typename TMotifSet, typename TMotifSets>
+	inline void _appendMotifSets(TMotifSet	&motifSet,
+								 TMotifSets	&motifSets
+								 ){
+		typedef typename Iterator<TMotifSet, Standard>::Type	TIter;
+		
+		for (unsigned i=0; i<length(motifSets); ++i){
+			for (TIter it = begin(motifSets[i], Standard()); it != end(motifSets[i], Standard()); ++it)
+				appendValue(motifSet, *it, Generous());
+			// release the memory of the copied set early
+			clear(motifSets[i]);
+		}
+	}
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// Search for triplexes given a set of duplexes and a set of TFOs
 	template<
@@ -1993,6 +2968,7 @@ namespace SEQAN_NAMESPACE_MAIN
 		if (options.maximalError >= 0){
 			eR = min(options.errorRate, max(double(options.maximalError)/options.minLength, 0.0));
 		}
+		gardener.clipHits = options.clipHits;
 #if SEQAN_ENABLE_PARALLELISM	
 		if (options.runtimeMode==RUN_PARALLEL_TRIPLEX){
 			plant(gardener, pattern, ttsSet, eR, options.minLength, options.maxInterruptions+1, MULTIPLE_WORKER() );
@@ -2026,7 +3002,8 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 	
 	//////////////////////////////////////////////////////////////////////////////
-	// copy the potentials across from the source to the sink
+	// copy the potentials across from the source to the sink, counts of 
+	// sequence pairs contained in both are added up
 	template<
 	typename TPotentials
 	>
@@ -2036,9 +3013,16 @@ namespace SEQAN_NAMESPACE_MAIN
 		
 		typedef typename Iterator<TPotentials, Standard>::Type	TIter;
 		typedef typename Value<TPotentials>::Type				TPotential;
+		typedef typename Cargo<TPotential>::Type				TPotCargo;
 		
+		reserve(tpot_sink, length(tpot_sink) + length(tpot_source));
 		for (TIter it = begin(tpot_source); it != end(tpot_source); ++it){
-			insert(tpot_sink, *it);
+			TPotCargo* potential = findCargo(tpot_sink, key(*it));
+			if (potential != NULL){
+				addCounts(*potential, cargo(*it));
+			} else {
+				insert(tpot_sink, *it);
+			}
 		}
 	}
 	
@@ -2236,69 +3220,93 @@ namespace SEQAN_NAMESPACE_MAIN
 
 	
 	//////////////////////////////////////////////////////////////////////////////
-	// Search for a triplex given a target string and a set of TFOs
+	// Search a set of putative TTSs without filter, in parallel per TTS in 
+	// runtime mode 1
 	template<
 	typename TMatches,
 	typename TPotentials,
 	typename TId, 
 	typename TPatterns,
-	typename TDuplex
+	typename TTtsSet
 	>
-	void _detectTriplex(TMatches		&matches,
-						TPotentials		&potentials,
-						TPatterns		&tfoSet,
-						TDuplex			&duplexString,
-						TId const		&duplexId,
-						Options			&options,
-						BruteForce
-						){	
-		typedef ModStringTriplex<TDuplex, TDuplex>	TTts;
-		typedef StringSet<TTts>						TTtsSet;
-		typedef typename Iterator<TTtsSet>::Type	TTtsIter;
-		
-		bool reduceSet = true; // merge overlapping features
-		TTtsSet ttsSet;
-		// prefilter for putative TTSs
-		if (options.forward) {
-			processDuplex(ttsSet, duplexString, duplexId, true, reduceSet, options);
-		}
-		if (options.reverse) {
-			processDuplex(ttsSet, duplexString, duplexId, false, reduceSet, options);
-		}
-#ifdef TRIPLEX_DEBUG
-		::std::cerr << "printing all tts segments" << ::std::endl;
-		for (TTtsIter itr=begin(ttsSet); itr != end(ttsSet);++itr){
-			::std::cerr << "tts: " << ttsString(*itr) << " type: " << (*itr).motif << " length: "<< length(*itr) <<  " position: "<< beginPosition(*itr) << " " << ::std::endl;
-		}
-#endif
-		
+	void _searchTtsSetBruteForce(TMatches			&matches,
+								 TPotentials		&potentials,
+								 TPatterns			&tfoSet,
+								 TTtsSet			&ttsSet,
+								 TId const			&duplexId,
+								 Options			&options
+								 ){
 #if SEQAN_ENABLE_PARALLELISM	
 		if (options.runtimeMode==RUN_PARALLEL_TRIPLEX){
 			
+			// potentials are accumulated per thread and merged without locking at the end
+			String<TPotentials> thread_potentials;
+			resize(thread_potentials, omp_get_max_threads(), Exact());
 			SEQAN_PRAGMA_IF_PARALLEL(omp parallel)
 			{
-				SEQAN_PRAGMA_IF_PARALLEL(omp for schedule(dynamic) )
+				TPotentials &potentials_local = thread_potentials[omp_get_thread_num()];
+				SEQAN_PRAGMA_IF_PARALLEL(omp for schedule(dynamic) nowait)
 				for (unsigned int tts=0; tts<length(ttsSet); ++tts){
 					
 					TTtsSet tmp_ttsSet;
 					appendValue(tmp_ttsSet, ttsSet[tts]);
 					TMatches tmp_matches;
-					TPotentials tmp_potentials;
-					_detectTriplexBruteForce(tmp_matches, tmp_potentials, tfoSet, tmp_ttsSet, duplexId, options);
+					_detectTriplexBruteForce(tmp_matches, potentials_local, tfoSet, tmp_ttsSet, duplexId, options);
 					
 					if (length(tmp_matches)>0){
 						SEQAN_PRAGMA_IF_PARALLEL(omp critical(addMatches) ){
 							_saveMatches(matches, tmp_matches);
-							_savePotentials(potentials, tmp_potentials);
 						}
 					}
 				}
 			}
+			for (unsigned i=0; i<length(thread_potentials); ++i)
+				_savePotentials(potentials, thread_potentials[i]);
 		} else		
 #endif
 		_detectTriplexBruteForce(matches, potentials, tfoSet, ttsSet, duplexId, options);
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// Search for a triplex given a target string and a set of TFOs
+	template<
+	typename TMatches,
+	typename TPotentials,
+	typename TId, 
+	typename TPatterns,
+	typename TDuplex
+	>
+	void _detectTriplex(TMatches		&matches,
+						TPotentials		&potentials,
+						TPatterns		&tfoSet,
+						TDuplex			&duplexString,
+						TId const		&duplexId,
+						Options			&options,
+						BruteForce
+						){	
+		typedef ModStringTriplex<TDuplex, TDuplex>	TTts;
+		typedef StringSet<TTts>						TTtsSet;
+		typedef typename Iterator<TTtsSet>::Type	TTtsIter;
+		
+		bool reduceSet = true; // merge overlapping features
+		TTtsSet ttsSet;
+		// prefilter for putative TTSs
+		if (options.forward) {
+			processDuplex(ttsSet, duplexString, duplexId, true, reduceSet, options);
+		}
+		if (options.reverse) {
+			processDuplex(ttsSet, duplexString, duplexId, false, reduceSet, options);
+		}
+#ifdef TRIPLEX_DEBUG
+		::std::cerr << "printing all tts segments" << ::std::endl;
+		for (TTtsIter itr=begin(ttsSet); itr != end(ttsSet);++itr){
+			::std::cerr << "tts: " << ttsString(*itr) << " type: " << (*itr).motif << " length: "<< length(*itr) <<  " position: "<< beginPosition(*itr) << " " << ::std::endl;
+		}
+#endif
+		
+		_searchTtsSetBruteForce(matches, potentials, tfoSet, ttsSet, duplexId, options);
+	}
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// Search for a triplex given a target string and a set of TFOs
 	template<
@@ -2320,16 +3328,15 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef typename Iterator<TTtsSet>::Type	TTtsIter;
 		typedef typename Iterator<TPatterns const>::Type	TPattIter;
 		typedef typename Value<TPatterns>::Type		TPattern;
-		typedef typename Host<TPattern>::Type		TTfo;
 		typedef typename Position<TPatterns>::Type	TPos;
 		typedef typename Infix<TDuplex>::Type		TSegment;
-		typedef String<TSegment>					TSegString;
-		typedef typename Iterator<TSegString>::Type	TSegStringIter;
+		typedef typename Iterator<String<TriplexInterval>, Standard>::Type	TIntervalIter;
 		typedef typename Value<TPotentials>::Type	TPotential;
 		typedef typename Key<TPotential>::Type		TPotentialKey;
 		typedef typename Cargo<TPotential>::Type	TPotentialCargo;
 		
-		TTtsSet triplexSet;
+		TriplexVerifyBuffers buffers;
+		_prepareVerifyBuffers(buffers, options);
 		
 		int minScore = options.minLength- static_cast<int>(ceil(options.errorRate * options.minLength));
 		if (length(ttsSet)>0){
@@ -2340,17 +3347,16 @@ namespace SEQAN_NAMESPACE_MAIN
 				TPattern pat = *itO;
 				::std::cerr << "tfo candidate: " << pat << ::std::endl << "--- candidate: " << tfoString(*itO) << " " << getMotif(*itO) <<  " " << isParallel(*itO) << :: std::endl;
 #endif
-				TTfo tfoCandidate = ttsString(*itO);
-				Finder<TTfo > finder(tfoCandidate);
+				// candidates that can not enter the top matches of the TFO sequence are skipped
+				int tfoMinScore = _max(minScore, topMatchThreshold(options.topMatches, getSequenceNo(*itO)));
 				// iterate over all TTS candidates
 				int ttsNo = 0;
 				for (TTtsIter itD = begin(ttsSet); itD != end(ttsSet); ++itD, ++ttsNo){
-					TDuplex ttsCandidate = ttsString(*itD);
 #ifdef TRIPLEX_DEBUG
-					::std::cerr << "tts candidate: " << ttsCandidate << ::std::endl;
+					::std::cerr << "tts candidate: " << ttsString(*itD) << ::std::endl;
 #endif
 					// iterate all suitable (>= minLength) diagonals
-					for (int diag = -(length(ttsCandidate)-options.minLength); diag <= length(tfoCandidate)-options.minLength; ++diag){
+					for (int diag = -(length(*itD)-options.minLength); diag <= length(*itO)-options.minLength; ++diag){
 						int offsetTts = 0;
 						int offsetTfo = 0;
 						if (diag < 0)
@@ -2358,135 +3364,90 @@ namespace SEQAN_NAMESPACE_MAIN
 						else if (diag > 0)
 							offsetTfo = diag;
 						
-						int lenS = min(length(ttsCandidate)-offsetTts, length(tfoCandidate)-offsetTfo);
-						TDuplex triplex(infix(ttsCandidate, offsetTts, offsetTts+lenS));
-						TTfo tfo(infix(tfoCandidate, offsetTfo, offsetTfo+lenS));
+						int lenS = min(length(*itD)-offsetTts, length(*itO)-offsetTfo);
+						// check for minimum requirement of matching positions and run 
+						// the diagonal through the TTS parser and filter
+						// no matches are stored in potential-only mode, just counted
+						unsigned totalNumberOfMatches = _verifyWindow(buffers,
+																	  begin(*itO, Standard()) + offsetTfo,
+																	  begin(*itD, Standard()) + offsetTts,
+																	  lenS,
+																	  tfoMinScore,
+																	  options.potentialOnly,
+																	  options);
 #ifdef TRIPLEX_DEBUG
-						::std::cerr << "tts: " << triplex << ::std::endl;
-						::std::cerr << "tfo: " << tfo << ::std::endl;
-#endif	
-						int m = 0; //matches between the sequences
-						for (int k=0; k<lenS; ++k){
-							if (triplex[k]!=tfo[k]){
-								triplex[k]='N';
-							} else {
-								++m;
-							}
+						::std::cerr << "totalNumberOfMatches:" << totalNumberOfMatches << ::std::endl;
+#endif		
+						// skip parts below if no matches have been detected
+						if (totalNumberOfMatches==0){
+							continue;
 						}
-#ifdef TRIPLEX_DEBUG	
-						::std::cerr << "tts: " << triplex <<  " " << (m < minScore?"discarded":"to verify") << ::std::endl;
-#endif					
-						// check for minimum requirement of matching positions
-						if (m >= minScore){
-							// run through TTS parser
+						
+						// save all matches
+						TPos tfoStart;
+						TPos tfoEnd;
+						TPos ttsStart;
+						TPos ttsEnd;
+						char strand;
+						for (TIntervalIter itr=begin(buffers.intervals, Standard()); itr!=end(buffers.intervals, Standard()); ++itr){
+							TPos triplexLength = itr->end - itr->begin;
 							
-							// clear triplex result set from previous entries first
-							clear(triplexSet);
-							// create parser once
-							if (empty(options.triplexParser)){
-								TDuplex valid("GAR");		// the valid characters
-								TDuplex invalid("TCYN");	// the interrupting characters			
-								_makeParser(options.triplexParser, valid, invalid, options);
+							// calculate tts positions according to strand in the duplex
+							if (getMotif(*itD)=='+'){
+								ttsStart = offsetTts + beginPosition(*itD) + itr->begin;
+								ttsEnd = ttsStart + triplexLength;
+								strand = '+';			
+							} else {
+								ttsEnd = endPosition(*itD) - (offsetTts + itr->begin);
+								ttsStart = ttsEnd - triplexLength;
+								strand = '-';
 							}
 							
-							// split duplex into valid parts
-							TSegString seqString;	// target segment container
-							_parse(seqString, options.triplexParser, triplex, options);
-							unsigned totalNumberOfMatches = 0;
-							
-							// process one segment at a time
-							for (TSegStringIter it = begin(seqString, Standard()); it != end(seqString, Standard()); ++it){
-#ifdef TRIPLEX_DEBUG
-								::std::cerr << "pTriplex:" << *it << ::std::endl;
-#endif
-								TTts ttsfilter(*it, true, getSequenceNo(*itD), false, '+');
-								bool reduceSet = false; // don't merge overlapping triplexes	
-								totalNumberOfMatches += _filterWithGuanineAndErrorRate(triplexSet, ttsfilter, 'G', 'Y', reduceSet, TRIPLEX_ORIENTATION_BOTH, options, TTS());
-							}
-#ifdef TRIPLEX_DEBUG
-							::std::cerr << "totalNumberOfMatches:" << totalNumberOfMatches << ::std::endl;
-#endif		
-							// skip parts below if no matches have been detected
-							if (totalNumberOfMatches==0){
-								continue;
+							// calculate tfo positions according to binding orientation
+							if (isParallel(*itO)){
+								tfoStart = offsetTfo + beginPosition(*itO) + itr->begin;
+								tfoEnd = tfoStart + triplexLength;
+							} else {
+								tfoEnd = endPosition(*itO) - (offsetTfo + itr->begin);
+								tfoStart = tfoEnd - triplexLength;
 							}
 							
-							// save all matches
-							TPos tfoStart;
-							TPos tfoEnd;
-							TPos ttsStart;
-							TPos ttsEnd;
-							char strand;
-							for (TTtsIter itr=begin(triplexSet); itr!=end(triplexSet); ++itr){
-								// compute score = matching positions, which can be found in the triplex string (number of N's within the interval found)
-								int score=0;
-								int guanines=0;
-								for (unsigned int i=beginPosition(*itr); i<endPosition(*itr); ++i){
-									if (triplex[i]!='N')
-										++score;
-									if (triplex[i]=='G')
-										++guanines;
-								}
-								
-								// calculate tts positions according to strand in the duplex
-								if (getMotif(*itD)=='+'){
-									ttsStart = offsetTts + beginPosition(*itD)+ beginPosition(*itr);
-									ttsEnd = ttsStart + length(*itr);
-									strand = '+';			
-								} else {
-									ttsEnd = endPosition(*itD) - (offsetTts + beginPosition(*itr));
-									ttsStart = ttsEnd - length(*itr);
-									strand = '-';
-								}
-								
-								// calculate tfo positions according to binding orientation
-								if (isParallel(*itO)){
-									tfoStart = offsetTfo + beginPosition(*itO)+beginPosition(*itr);
-									tfoEnd = tfoStart + length(*itr);
-								} else {
-									tfoEnd = endPosition(*itO) - (offsetTfo + beginPosition(*itr));
-									tfoStart = tfoEnd - length(*itr);
-								}
-								
-								// save the corresponding triplex match and 
-								// squeeze in the total number of matches between the TFO and the TTS as well
-								TMatch match(tfoNo,
-											 tfoStart,
-											 tfoEnd,
-											 duplexId,
-											 ttsNo,
-											 ttsStart,
-											 ttsEnd,
-											 score,
-											 isParallel(*itO),
-											 getMotif(*itO),
-											 strand,
-											 guanines
-											 );
-								appendValue(matches, match);
-								
+							// save the corresponding triplex match and 
+							// squeeze in the total number of matches between the TFO and the TTS as well
+							TMatch match(tfoNo,
+										 tfoStart,
+										 tfoEnd,
+										 duplexId,
+										 ttsNo,
+										 ttsStart,
+										 ttsEnd,
+										 itr->score,
+										 isParallel(*itO),
+										 getMotif(*itO),
+										 strand,
+										 itr->guanines
+										 );
+							appendValue(matches, match);
+							
 #ifdef TRIPLEX_DEBUG
-								::std::cerr << "tts: " << ttsString(*itr) << " length: "<< length(*itr) <<  " position: "<< beginPosition(*itr) << "-" <<endPosition(*itr) << " " << infix(triplex, beginPosition(*itr), endPosition(*itr)) << ::std::endl;
-								TSegment ftfo = infix(host(*itO), tfoStart, tfoEnd);
-								TSegment ftts = infix(host(*itD), ttsStart, ttsEnd);
-								::std::cerr << "ttsC: " << tfoCandidate << ::std::endl << "tfoC: "<< tfoCandidate << ::std::endl;
-								::std::cerr << "tts: " << ftts << ::std::endl << "tfo: "<< ftfo << ::std::endl;
+							TSegment ftfo = infix(host(*itO), tfoStart, tfoEnd);
+							TSegment ftts = infix(host(*itD), ttsStart, ttsEnd);
+							::std::cerr << "tts: " << ftts << ::std::endl << "tfo: "<< ftfo << ::std::endl;
 #endif
-							}
-							
-							// save potential
-							TPotentialKey pkey(getSequenceNo(*itO), getSequenceNo(*itD));
-							if (hasKey(potentials, pkey)){
-								// sequence pair already known, just add counts
-								TPotentialCargo* potential = &cargo(potentials, pkey);
-								addCount(*potential, totalNumberOfMatches, getMotif(*itO));
-							} else {
-								// new sequence pair, add counts and compute norm
-								TPotentialCargo potential(pkey);
-								addCount(potential, totalNumberOfMatches, getMotif(*itO));
-								setNorm(potential, length(host(*itO)), length(host(*itD)), options);
-								insert(potentials, TPotential(pkey, potential));
-							}
+						}
+						
+						// save potential
+						TPotentialKey pkey(getSequenceNo(*itO), getSequenceNo(*itD));
+						TPotentialCargo* potential = findCargo(potentials, pkey);
+						if (potential != NULL){
+							// sequence pair already known, just add counts
+							addCount(*potential, totalNumberOfMatches, getMotif(*itO));
+						} else {
+							// new sequence pair, add counts and compute norm
+							TPotentialCargo potential(pkey);
+							addCount(potential, totalNumberOfMatches, getMotif(*itO));
+							setNorm(potential, length(host(*itO)), length(host(*itD)), options);
+							insert(potentials, TPotential(pkey, potential));
 						}
 					}
 				}
@@ -2836,342 +3797,6 @@ namespace SEQAN_NAMESPACE_MAIN
 		return removed;
 	}
 	
-	//////////////////////////////////////////////////////////////////////////////
-	// Increase left handsite iterator 
-	template< typename TNum, typename TArray, typename TPos>
-	inline void _increaseLeft(TArray	&encoded_seq,
-							  TPos		&pos,
-							  TNum		&filter_chars,
-							  TNum		&interrupt_chars,
-							  TNum		&nonfilter_char
-							  ){
-		// increase leftmost pointer
-		filter_chars -= encoded_seq[0][pos];
-		interrupt_chars -= encoded_seq[1][pos];
-		nonfilter_char -= encoded_seq[2][pos];
-		++pos;
-	}
-	
-	//////////////////////////////////////////////////////////////////////////////
-	// Increase right handsite iterator
-	template< typename TNum, typename TArray, typename TPos>
-	inline void _increaseRight(TArray	&encoded_seq,
-							   TPos		&pos,
-							   TNum		&filter_chars,
-							   TNum		&interrupt_chars,
-							   TNum		&nonfilter_char
-							   ){
-		// increase right pointer
-		filter_chars += encoded_seq[0][pos];
-		interrupt_chars += encoded_seq[1][pos];
-		nonfilter_char += encoded_seq[2][pos];
-		++pos;
-	} 
-	
-	//////////////////////////////////////////////////////////////////////////////
-	// Return whether pposition corresponds to interrupting character
-	template<typename TArray, typename TPos>
-	inline bool _isInterruptingChar(TArray	&encoded_seq,
-									TPos	pos
-									){
-		return encoded_seq[1][pos];
-	}
-	
-	//////////////////////////////////////////////////////////////////////////////
-	// Encodes a sequence in a 2D array of dim [3][length(sequence)] where
-	// where the first row contains a one at positions containing the filter char
-	// the second row contains a 1 where a interrupt char 
-	template <
-	typename TString,
-	typename TChar
-	>
-	inline bool** _encodeSeq(TString		&sequence,
-							 TChar const	&filter_char,
-							 TChar const	&interrupting_char,
-							 bool**			blockruns, 
-							 Options const	&options
-							){
-		typedef typename Iterator<TString>::Type	TIter;
-		
-		int rows = 3;
-		int cols = length(sequence);
-
-		// declaration
-		bool** encoded_seq;
-		
-		// allocation
-		encoded_seq = new bool*[rows];
-		for(int i = 0; i < rows; i++){
-			encoded_seq[i] = new bool[cols];
-		}
-		
-		// initialization
-		for(int i = 0; i < rows; ++i){
-			for(int j = 0; j < cols; ++j){
-				encoded_seq[i][j] = false;
-			}
-		}
-		
-		unsigned counter = 0;
-		unsigned runCounter = 0;
-		for (TIter it = begin(sequence); it != end(sequence); ++it, ++counter){
-			if (*it == filter_char){
-				encoded_seq[0][counter] = true;
-			} else if (*it == interrupting_char){
-				encoded_seq[1][counter] = true;
-				encoded_seq[2][counter] = true;
-				if (counter - runCounter >= options.minBlockRun){
-					for (unsigned t1=0; t1 <= counter - options.minBlockRun; ++t1){
-						for (unsigned t2=max(t1,runCounter) + options.minBlockRun; t2 <= length(sequence); ++t2){
-							blockruns[t1][t2] = true;
-						}
-					}
-				}
-				runCounter = counter+1;
-			} else {
-				encoded_seq[2][counter] = true;
-			}
-		}
-		// final segment
-		if (counter - runCounter >= options.minBlockRun){
-			for (unsigned t1=0; t1 <= counter - options.minBlockRun ; ++t1){
-				for (unsigned t2=max(t1,runCounter) + options.minBlockRun; t2 <= length(sequence); ++t2){
-					blockruns[t1][t2] = true;
-				}
-			}
-
-		}
-		return encoded_seq;
-	}
-	
-	
-	//////////////////////////////////////////////////////////////////////////////
-	// Filter a string with the requested guanine rate AND the error rate
-	// returns the total number of matches (all_matches) that comply to the 
-	// defined constraints
-	template <typename TMotifSet, typename TTag>
-	inline unsigned _filterWithGuanineAndErrorRate(TMotifSet						&patternString,
-												   typename Value<TMotifSet>::Type	&pattern,
-												   char								filter_char,
-												   char								interrupting_char,
-												   bool								reduceSet,
-												   ORIENTATION const				orientation,
-												   Options const					&options,
-												   TTag const & 
-												   ){
-		typedef typename Value<TMotifSet>::Type			TPattern;
-		typedef typename Host<TPattern>::Type			TString;
-		typedef typename Iterator<TString>::Type		TStringIter;
-		typedef ModifiedString<TString, ModView< FunctorRYFilter > >  	TFilter;
-		typedef typename Iterator<TFilter>::Type		TFilterIter;
-		typedef short									TEncode;
-		
-		TMotifSet tmp_pattern_set;
-		TMotifSet* ptr_pattern_set;
-		if (reduceSet){
-			ptr_pattern_set = &tmp_pattern_set;
-		} else {
-			ptr_pattern_set = &patternString;
-		}
-
-		bool** encoded_seq;
-		bool** blockruns; // flag indicating for each seq interval whether there exists a valid blockRun inbetween
-		// allocation
-		blockruns = new bool*[length(pattern)-options.minBlockRun+1];
-		for(unsigned i = 0; i <= length(pattern)-options.minBlockRun; i++){
-			blockruns[i] = new bool[length(pattern)+1];
-		}
-		// initialization
-		for (unsigned t1=0; t1 <= length(pattern)-options.minBlockRun; ++t1){
-			for (unsigned t2=0; t2 <= length(pattern); ++t2){
-				blockruns[t1][t2] = false;
-			}
-		}
-
-		// if no guanine rate restriction, then collapse filter and tolerated chars
-		if (options.minGuanineRate <= 0.0){
-			TFilter filter_seq(pattern);
-			if (filter_char == 'G')
-				filter_char='R';
-			else
-				filter_char='Y';
-			encoded_seq = _encodeSeq(filter_seq, filter_char, interrupting_char, blockruns, options);
-		} else {
-			encoded_seq = _encodeSeq(pattern, filter_char, interrupting_char, blockruns, options);
-		}
-	
-#ifdef TRIPLEX_DEBUG
-		::std::cerr << pattern << ::std::endl;
-		for (int r=0; r<3;++r){
-			for (unsigned i=0; i<length(pattern) ; ++i){
-				::std::cerr << encoded_seq[r][i] ;
-			}
-			::std::cerr << ::std::endl;
-		}
-		::std::cerr << ::std::endl;
-		for (unsigned t1=0; t1 <= length(pattern)-options.minBlockRun; ++t1){
-			for (unsigned t2=0; t2 <= length(pattern); ++t2){
-				::std::cerr << blockruns[t1][t2];
-			}
-			::std::cerr  << ::std::endl;
-		}
-		
-		::std::cerr << "Any hit: " << blockruns[0][length(pattern)] << " " << length(pattern) << ::std::endl;
-#endif		
-		
-		double max_error = floor(length(pattern)*options.errorRate);
-		if (options.maximalError >= 0)
-			max_error = min(max_error, double(options.maximalError));
-		double max_tolerated = (floor(length(pattern)*(1.0-options.minGuanineRate)));
-		
-		
-		double cnt_filter_chars = 0.0;
-		double cnt_interrupt_chars = 0.0;
-		double cnt_nonfilter_chars = 0.0;
-		bool is_match = false;
-		unsigned max_length = length(pattern);
-		if (options.maxLength >= options.minLength)
-			max_length = options.maxLength;
-		
-		double tmp_error = 0.0;
-		unsigned tmp_start = 0;
-		unsigned tmp_end = 0;
-		unsigned covered_end= 0;
-		
-		unsigned itLeft = 0;
-		unsigned itRight = 0;
-		
-		double filter_chars_rate = 0.;
-		double interrupt_chars_rate = 0.;
-	
-		unsigned totalNumberOfMatches = 0;
-		
-		// there must be another valid blockrun
-		while (blockruns[itLeft][length(pattern)] && itLeft+options.minLength <= length(pattern)){
-			// obey minimum length 
-			while (itRight-itLeft < options.minLength && itRight < length(pattern) ){
-				while (itRight-itLeft < options.minLength && itRight < length(pattern) ){
-					_increaseRight(encoded_seq, itRight, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
-				}
-				
-				// obey maximum error
-				while (cnt_interrupt_chars > max_error)
-					_increaseLeft(encoded_seq, itLeft, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
-				
-				// obey maximum filterchars 
-				while (cnt_nonfilter_chars > max_tolerated)
-					_increaseLeft(encoded_seq, itLeft, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
-				
-				// hit cannot start with interrupting char
-				while (itLeft < length(pattern) && _isInterruptingChar(encoded_seq, itLeft))
-					_increaseLeft(encoded_seq, itLeft, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
-
-				if (itRight < itLeft){
-					itRight = itLeft;
-					cnt_filter_chars = 0.0;
-					cnt_interrupt_chars = 0.0;
-					cnt_nonfilter_chars = 0.0;	
-				}
-			}
-			
-			// cannot fulfil minimum length constraint
-			if (itRight-itLeft < options.minLength){
-				break;
-				
-			} else {
-				is_match = false;
-				// got a minimum length segment that does not violate maximum constraints
-				// extend to the left as far as possible
-				while (cnt_interrupt_chars <= max_error && cnt_nonfilter_chars <= max_tolerated && itRight-itLeft <= max_length){
-					filter_chars_rate = double(cnt_filter_chars)/(itRight-itLeft);
-					interrupt_chars_rate = double(cnt_interrupt_chars)/(itRight-itLeft);
-					if (blockruns[itLeft][itRight] && !_isInterruptingChar(encoded_seq, itRight-1) 
-						&& interrupt_chars_rate <= options.errorRate 
-						&& options.minGuanineRate <= filter_chars_rate && filter_chars_rate <= options.maxGuanineRate
-						&& _motifSpecificConstraints(filter_chars_rate, interrupt_chars_rate, orientation, options, TTag()))
-					{	
-						is_match = true;
-						++totalNumberOfMatches;
-						tmp_start = itLeft;
-						tmp_end = itRight;
-						tmp_error = cnt_interrupt_chars;
-						// add match straight away if all matches should be reported
-						if (options.allMatches){
-#ifdef TRIPLEX_DEBUG		
-							::std::cerr << "add match:" << infix(pattern,tmp_start,tmp_end) << ::std::endl;
-							double tmp_cnt_filter_chars = 0.0;
-							double tmp_cnt_interrupt_chars = 0.0;
-							double tmp_cnt_nonfilter_char = 0.0;
-							unsigned it=tmp_start;
-							while(it<tmp_end){
-								_increaseRight(encoded_seq, it, tmp_cnt_filter_chars, tmp_cnt_interrupt_chars, tmp_cnt_nonfilter_char);
-							}
-							::std::cerr << "len : " << (tmp_end-tmp_start) << ::std::endl;
-							::std::cerr << "err : " << (tmp_cnt_interrupt_chars/(tmp_end-tmp_start)) << ::std::endl;
-							::std::cerr << "gua : " << (tmp_cnt_nonfilter_char/(tmp_end-tmp_start)) << ::std::endl;							
-#endif	
-							_addMatch(*ptr_pattern_set, pattern, tmp_start, tmp_end, tmp_error, TTag());
-							covered_end = tmp_end;
-							is_match = false; // prevent redundant addition
-						}
-					}
-					
-					if (itRight < length(pattern)){
-						_increaseRight(encoded_seq, itRight, cnt_filter_chars, cnt_interrupt_chars, cnt_nonfilter_chars);
-					} else {
-						break;
-					}
-				}
-				if (is_match && tmp_end > covered_end){
-#ifdef TRIPLEX_DEBUG		
-					::std::cerr << "add match:" << infix(pattern,tmp_start,tmp_end) << ::std::endl;
-					double tmp_cnt_filter_chars = 0.0;
-					double tmp_cnt_interrupt_chars = 0.0;
-					double tmp_cnt_nonfilter_char = 0.0;
-					unsigned it=tmp_start;
-					while(it<tmp_end){
-						_increaseRight(encoded_seq, it, tmp_cnt_filter_chars, tmp_cnt_interrupt_chars, tmp_cnt_nonfilter_char);
-					}
-					::std::cerr << "len : " << (tmp_end-tmp_start) << ::std::endl;
-					::std::cerr << "err : " << (tmp_cnt_interrupt_chars/(tmp_end-tmp_start)) << ::std::endl;
-					::std::cerr << "gua : " << (tmp_cnt_nonfilter_char/(tmp_end-tmp_start)) << ::std::endl;
-#endif	
-					_addMatch(*ptr_pattern_set, pattern, tmp_start, tmp_end, tmp_error, TTag());
-					covered_end = tmp_end;
-				}
-				is_match = false;
-				// increase leftmost pointer & skip errors
-				++itLeft;
-				while (itLeft < length(pattern) && _isInterruptingChar(encoded_seq, itLeft))
-					++itLeft;
-				
-				itRight = itLeft;
-				cnt_filter_chars = 0.0;
-				cnt_interrupt_chars = 0.0;
-				cnt_nonfilter_chars = 0.0;				
-			}
-		}
-		
-		for (int r=0; r<3;++r)
-			delete [] encoded_seq[r];
-		delete [] encoded_seq;
-		for (unsigned t1=0; t1<=length(pattern)-options.minBlockRun; ++t1)
-			delete [] blockruns[t1];
-		delete [] blockruns;
-	
-		// reduce motif set for triplex search
-		if (reduceSet){
-#ifdef TRIPLEX_DEBUG	
-			::std::cerr << "# Elements before merging:" << length(tmp_pattern_set) << ::std::endl;
-#endif			
-			_reduceMotifSet(patternString, tmp_pattern_set);
-		} 
-#ifdef TRIPLEX_DEBUG
-		::std::cerr << "# Elements final patterns:" << length(patternString) << ::std::endl;
-#endif			
-		return totalNumberOfMatches;
-	}
-	
 	//////////////////////////////////////////////////////////////////////////////
 	// Processing motif specific constraints
 	template <typename TSize, typename TTag>
@@ -3538,17 +4163,16 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef typename Value<TStringSet>::Type			TString;
 		typedef typename Iterator<TStringSet>::Type			TStringIter;
 		typedef typename Host<TString>::Type				THost;
-		typedef typename Iterator<THost>::Type				THostIter;
-		
-		typedef typename Infix<THost>::Type					TSegment;
-		typedef String<TSegment>							TSegString;
-		typedef typename Iterator<TSegString>::Type			TSegStringIter;
+		typedef typename Iterator<String<TriplexInterval>, Standard>::Type	TIntervalIter;
 
 		typedef typename Iterator<TPotentials>::Type		TPotIter;
 		typedef typename Value<TPotentials>::Type			TPotValue;
 		typedef typename Key<TPotValue>::Type				TPotKey;
 		typedef typename Cargo<TPotValue>::Type				TPotCargo;
 		
+		TriplexVerifyBuffers buffers;
+		_prepareVerifyBuffers(buffers, options);
+		
 		// check all queries for hits	
 		for (TId queryid=0; queryid<(TId)length(ttsSet); ++queryid){
 			for (TIter it = harvestBegin(gardener,queryid); it != harvestEnd(gardener, queryid); ++it){
@@ -3559,44 +4183,17 @@ namespace SEQAN_NAMESPACE_MAIN
 				TPos ttsEnd;
 				char strand;
 				
-				THost tfo = infix(ttsString(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))), hit.getNdlPos(), hit.getNdlPos() + hit.getHitLength());
-				THost triplex(infix(ttsString(value(ttsSet,hit.getHstId())), hit.getHstkPos(), hit.getHstkPos()+hit.getHitLength()));
-#ifdef TRIPLEX_DEBUG
-				::std::cerr << "transform: " << triplex << :: std::endl;
-#endif
-				THostIter itTTS=begin(triplex);
-				for (THostIter itTFO=begin(tfo); itTFO!=end(tfo); ++itTFO,++itTTS){
-					if (*itTFO!=*itTTS){
-						*itTTS = 'N';
-					}	
-				}
-#ifdef TRIPLEX_DEBUG
-				::std::cerr << "to       : " << triplex << :: std::endl;
-#endif
-				
-				// run through TTS parser
- 				TStringSet triplexSet;
-				// create parser once
-				if (empty(options.triplexParser)){
-					THost valid("GAR");		// the valid characters
-					THost invalid("TCYN");	// the interrupting characters			
-					_makeParser(options.triplexParser, valid, invalid, options);
-				}
-				
-				// split duplex into valid parts
-				TSegString seqString;	// target segment container
-				_parse(seqString, options.triplexParser, triplex, options);
-				unsigned totalNumberOfMatches = 0;
+				TString const &tfo = getSequenceByNo(hit.getNdlSeqNo(),needle(pattern));
+				TString const &tts = value(ttsSet,hit.getHstId());
 				
-				// process one segment at a time
-				for (TSegStringIter it = begin(seqString, Standard()); it != end(seqString, Standard()); ++it){
-#ifdef TRIPLEX_DEBUG
-					::std::cerr << "pTriplex:" << *it << ::std::endl;
-#endif
-					TString ttsfilter(*it, true, hit.getHstId(), false, '+');
-					bool reduceSet = false; // don't merge overlapping triplexes	
-					totalNumberOfMatches += _filterWithGuanineAndErrorRate(triplexSet, ttsfilter, 'G', 'Y', reduceSet, TRIPLEX_ORIENTATION_BOTH, options, TTS());
-				}
+				// the score of any triplex within the hit is bounded by its matching positions
+				unsigned totalNumberOfMatches = _verifyWindow(buffers,
+															  begin(tfo, Standard()) + hit.getNdlPos(),
+															  begin(tts, Standard()) + hit.getHstkPos(),
+															  hit.getHitLength(),
+															  topMatchThreshold(options.topMatches, getSequenceNo(tfo)),
+															  options.potentialOnly,
+															  options);
 #ifdef TRIPLEX_DEBUG
 				::std::cerr << "totalNumberOfMatches:" << totalNumberOfMatches << ::std::endl;
 #endif	
@@ -3605,36 +4202,27 @@ namespace SEQAN_NAMESPACE_MAIN
 					continue;
 				}
 				
-				for (TStringIter itr=begin(triplexSet); itr!=end(triplexSet); ++itr){
-					// compute score = matching positions, which can be found in the triplex string (number of N's within the interval found)
-					int score=0;
-					int guanines=0;
-					for (unsigned int i=beginPosition(*itr); i<endPosition(*itr); ++i){
-						if (triplex[i]!='N')
-							++score;
-						if (triplex[i]=='G')
-							++guanines;
-					}
+				for (TIntervalIter itr=begin(buffers.intervals, Standard()); itr!=end(buffers.intervals, Standard()); ++itr){
+					TPos triplexLength = itr->end - itr->begin;
 					
 					// calculate tts positions according to strand in the duplex
 					if (plusstrand){
-						ttsStart = hit.getHstkPos() + beginPosition(value(ttsSet,hit.getHstId()))+ beginPosition(*itr);
-						ttsEnd = ttsStart + length(*itr);
+						ttsStart = hit.getHstkPos() + beginPosition(tts) + itr->begin;
+						ttsEnd = ttsStart + triplexLength;
 						strand = '+';			
 					} else {
-						ttsEnd = endPosition(value(ttsSet,hit.getHstId())) - (hit.getHstkPos() + beginPosition(*itr));
-						ttsStart = ttsEnd - length(*itr);
+						ttsEnd = endPosition(tts) - (hit.getHstkPos() + itr->begin);
+						ttsStart = ttsEnd - triplexLength;
 						strand = '-';
 					}
 					
 					// calculate tfo positions according to binding orientation
-					if (isParallel(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern)))){
-						tfoStart = hit.getNdlPos() + beginPosition(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern)))+beginPosition(*itr);
-						tfoEnd = tfoStart + length(*itr);
+					if (isParallel(tfo)){
+						tfoStart = hit.getNdlPos() + beginPosition(tfo) + itr->begin;
+						tfoEnd = tfoStart + triplexLength;
 					} else {
-						tfoEnd = endPosition(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))) - (hit.getNdlPos() + beginPosition(*itr));
-						tfoStart = tfoEnd - length(*itr);
-
+						tfoEnd = endPosition(tfo) - (hit.getNdlPos() + itr->begin);
+						tfoStart = tfoEnd - triplexLength;
 					}
 					
 					// save the corresponding triplex match 
@@ -3645,33 +4233,32 @@ namespace SEQAN_NAMESPACE_MAIN
 								 queryid,
 								 ttsStart,
 								 ttsEnd,
-								 score,
-								 isParallel(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))),
-								 getMotif(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))),
+								 itr->score,
+								 isParallel(tfo),
+								 getMotif(tfo),
 								 strand,
-								 guanines
+								 itr->guanines
 								 );
 					appendValue(matches, match);
 					
 #ifdef TRIPLEX_DEBUG
- 					::std::cerr << "tts: " << ttsString(*itr) << " length: "<< length(*itr) <<  " position: "<< beginPosition(*itr) << "-" <<endPosition(*itr) << " " << infix(triplex, beginPosition(*itr), endPosition(*itr)) << ::std::endl;
-					THost ftfo = infix(ttsString(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))), tfoStart, tfoEnd);
-					THost ftts = infix(ttsString(value(ttsSet,hit.getHstId())), ttsStart, ttsEnd);
+					THost ftfo = infix(ttsString(tfo), tfoStart, tfoEnd);
+					THost ftts = infix(ttsString(tts), ttsStart, ttsEnd);
 					::std::cerr << "tts: " << ftts << ::std::endl << "tfo: "<< ftfo << ::std::endl;
 #endif				
 				}
 				
 				// save potential
-				TPotKey pkey(getSequenceNo(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))), getSequenceNo(value(ttsSet,hit.getHstId())));
-				if (hasKey(potentials, pkey)){
+				TPotKey pkey(getSequenceNo(tfo), getSequenceNo(tts));
+				TPotCargo* potential = findCargo(potentials, pkey);
+				if (potential != NULL){
 					// sequence pair already known, just add counts
-					TPotCargo* potential = &cargo(potentials, pkey);
-					addCount(*potential, totalNumberOfMatches, getMotif(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))));
+					addCount(*potential, totalNumberOfMatches, getMotif(tfo));
 				} else {
 					// new sequence pair, add counts and compute norm
 					TPotCargo potential(pkey);
-					addCount(potential, totalNumberOfMatches, getMotif(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern))));
-					setNorm(potential, length(host(getSequenceByNo(hit.getNdlSeqNo(),needle(pattern)))), length(host(ttsSet[queryid])), options);
+					addCount(potential, totalNumberOfMatches, getMotif(tfo));
+					setNorm(potential, length(host(tfo)), length(host(ttsSet[queryid])), options);
 					insert(potentials, TPotValue(pkey, potential));
 				}
 			}
@@ -3748,17 +4335,13 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 	
 	//////////////////////////////////////////////////////////////////////////////
-	// Load multi-Fasta sequences
+	// Split multi-Fasta sequences into sequences and ids
 	template <typename TSequenceSet, typename TNameSet, typename TOptions>
-	bool _loadOligos(TSequenceSet		&sequences,
-				     TNameSet			&fastaIDs,
-				     const char *		fileName,
-				     TOptions const	&options)
+	bool _splitOligos(TSequenceSet		&sequences,
+					  TNameSet			&fastaIDs,
+					  MultiSeqFile		&multiFasta,
+					  TOptions const	&options)
 	{
-		
-		MultiSeqFile multiFasta;
-		if (!open(multiFasta.concat, fileName, OPEN_RDONLY)) return false;
-		
 		AutoSeqFormat format;
 		guessFormat(multiFasta.concat, format);
 		split(multiFasta, format);
@@ -3778,6 +4361,47 @@ namespace SEQAN_NAMESPACE_MAIN
 			::std::cerr << "read " << length(sequences) << " sequences.\n";
 		return (seqCount > 0);
 	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Load multi-Fasta sequences
+	template <typename TSequenceSet, typename TNameSet, typename TOptions>
+	bool _loadOligos(TSequenceSet		&sequences,
+				     TNameSet			&fastaIDs,
+				     const char *		fileName,
+				     TOptions const	&options)
+	{
+		
+		MultiSeqFile multiFasta;
+		if (_inputCompression(fileName) != INPUT_PLAIN){
+			// compressed files can not be mapped directly, decompress them into a temporary file
+			if (!openTemp(multiFasta.concat)) return false;
+			if (!_readWholeFile(multiFasta.concat, fileName, options.processors)) return false;
+		} else {
+			if (!open(multiFasta.concat, fileName, OPEN_RDONLY)) return false;
+		}
+		
+		return _splitOligos(sequences, fastaIDs, multiFasta, options);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Load multi-Fasta sequences given as text (e.g. received by the server)
+	template <typename TSequenceSet, typename TNameSet, typename TOptions>
+	bool _loadOligosFromText(TSequenceSet		&sequences,
+							 TNameSet			&fastaIDs,
+							 CharString const	&text,
+							 TOptions const		&options)
+	{
+		if (empty(text)) return false;
+		MultiSeqFile multiFasta;
+		if (!openTemp(multiFasta.concat)) return false;
+		assign(multiFasta.concat, text);
+		return _splitOligos(sequences, fastaIDs, multiFasta, options);
+	}
+	
+	// bounds of a batch of single-stranded sequences read in streaming mode:
+	// number of sequences per thread and number of nucleotides
+	static const unsigned TFO_BATCH_SEQUENCES = 1024;
+	static const __int64 TFO_BATCH_BASES = 1 << 24;
 		
 	//////////////////////////////////////////////////////////////////////////////
 	// Find triplexes in many duplex sequences (import from Fasta) in parallel
@@ -3804,17 +4428,17 @@ namespace SEQAN_NAMESPACE_MAIN
 
 		typedef Pair<unsigned, unsigned>							TPotKey;
 		typedef TriplexPotential<TPotKey>							TPotPair;
-		typedef Map<Pair<TPotKey, TPotPair>, Skiplist<> >			TPotentials;
+		typedef PotentialTable<TPotKey, TPotPair>					TPotentials;
 		
 		typedef Repeat<unsigned, unsigned>							TRepeat;
 		typedef String<TRepeat>										TRepeatString; 
-		typedef typename Iterator<TRepeatString, Rooted>::Type		TRepeatIterator;
 		
 		// open duplex file
-		::std::ifstream file;
-		file.open(toCString(options.duplexFileNames[0]), ::std::ios_base::in | ::std::ios_base::binary);
-		if (!file.is_open())
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
 			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
 		
 		// remove the directory prefix of current duplex file
 		::std::string duplexFile(toCString(options.duplexFileNames[0]));
@@ -3839,16 +4463,13 @@ namespace SEQAN_NAMESPACE_MAIN
 				::std::cerr << "Processing:\t" << duplexName << "\t(seq " << duplexSeqNoWithinFile << ")\r" << ::std::flush;
 			
 			read(file, duplexSeq, Fasta());			// read Fasta sequence
+			if (_isCheckpointed(duplexSeqNoWithinFile, options))
+				continue;						// finished by a previous run
 
 			// find low complexity regions and mask sequences if requested
 			if (options.filterRepeats){
 				TRepeatString	data_repeats;
-				findRepeats(data_repeats, duplexSeq, options.minRepeatLength, options.maxRepeatPeriod);
-				for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-					TRepeat repeat = *rbeg;
-					CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-					replace(duplexSeq, repeat.beginPosition, repeat.endPosition, replacement);
-				}
+				_filterLowComplexityRegions(duplexSeq, data_repeats, options);
 			}
 			
 #if SEQAN_ENABLE_PARALLELISM
@@ -3862,11 +4483,12 @@ namespace SEQAN_NAMESPACE_MAIN
 			// output all entries
 			printTriplexEntry(matches, duplexName, duplexSeq, tfoMotifSet, tfoNames, outputfile, options);
 			dumpSummary(potentials, duplexName, tfoNames, options, TPX() );
+			_recordCheckpoint(outputfile, duplexSeqNoWithinFile, duplexName, options);
 			
 			// clean up
 			clear(matches);
 		}
-		file.close();
+		input.close();
 		return TRIPLEX_NORMAL_PROGAM_EXIT;
 	}
 	
@@ -3893,19 +4515,19 @@ namespace SEQAN_NAMESPACE_MAIN
 		
 		typedef Pair<unsigned, unsigned>							TPotKey;
 		typedef TriplexPotential<TPotKey>							TPotPair;
-		typedef Map<Pair<TPotKey, TPotPair>, Skiplist<> >			TPotentials;
+		typedef PotentialTable<TPotKey, TPotPair>					TPotentials;
 		
 		typedef Repeat<unsigned, unsigned>							TRepeat;
 		typedef String<TRepeat>										TRepeatString; 
-		typedef typename Iterator<TRepeatString, Rooted>::Type		TRepeatIterator;
 		
         (void)pattern; // deceive compiler to suppress warning of unused parameter
         
 		// open duplex file
-		::std::ifstream file;
-		file.open(toCString(options.duplexFileNames[0]), ::std::ios_base::in | ::std::ios_base::binary);
-		if (!file.is_open())
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
 			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
 		
 		// remove the directory prefix of current duplex file
 		::std::string duplexFile(toCString(options.duplexFileNames[0]));
@@ -3929,17 +4551,14 @@ namespace SEQAN_NAMESPACE_MAIN
 				::std::cerr << "Processing:\t" << duplexName << "\t(seq " << duplexSeqNoWithinFile << ")\r" << ::std::flush;
 			
 			read(file, duplexSeq, Fasta());			// read Fasta sequence
+			if (_isCheckpointed(duplexSeqNoWithinFile, options))
+				continue;						// finished by a previous run
 			
 			// find low complexity regions and mask sequences if requested
 			if (options.filterRepeats){
 				// find low complexity regions and mask sequences if requested
 				TRepeatString	data_repeats;
-				findRepeats(data_repeats, duplexSeq, options.minRepeatLength, options.maxRepeatPeriod);
-				for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-					TRepeat repeat = *rbeg;
-					CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-					replace(duplexSeq, repeat.beginPosition, repeat.endPosition, replacement);
-				}
+				_filterLowComplexityRegions(duplexSeq, data_repeats, options);
 				if (options._debugLevel > 1 )
 					options.logFileHandle << _getTimeStamp() << "   ... Finished low complexity filtering of duplex sequence" << ::std::endl;
 			}
@@ -3955,14 +4574,487 @@ namespace SEQAN_NAMESPACE_MAIN
 			// output all entries
 			printTriplexEntry(matches, duplexName, duplexSeq, tfoMotifSet, tfoNames, outputfile, options);
 			dumpSummary(potentials, duplexName, tfoNames, options, TPX() );
+			_recordCheckpoint(outputfile, duplexSeqNoWithinFile, duplexName, options);
 			
 			// clean up
 			clear(matches);
 		}
-		file.close();
+		input.close();
 		return TRIPLEX_NORMAL_PROGAM_EXIT;
 	}
 	
+	//////////////////////////////////////////////////////////////////////////////
+	// Search a single region with the q-gram filter
+	template <
+	typename TMatches,
+	typename TPotentials,
+	typename TMotifSet,
+	typename TPattern,
+	typename TDuplex,
+	typename TId,
+	typename TGardenerSpec
+	>
+	inline void _detectTriplexInRegion(TMatches			&matches,
+									   TPotentials		&potentials,
+									   TMotifSet		&,
+									   TPattern const	&pattern,
+									   TDuplex			&regionSeq,
+									   TId const		&duplexId,
+									   Options			&options,
+									   Gardener<TId, TGardenerSpec>
+									   ){
+		typedef Gardener<TId, TGardenerSpec>	TGardener;
+#if SEQAN_ENABLE_PARALLELISM
+		if (options.runtimeMode==RUN_PARALLEL_STRANDS && options.forward && options.reverse){
+			_detectTriplexParallelStrands(matches, potentials, pattern, regionSeq, duplexId, options, TGardener());
+			return;
+		}
+#endif
+		_detectTriplex(matches, potentials, pattern, regionSeq, duplexId, options, TGardener());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Search a single region without filter
+	template <
+	typename TMatches,
+	typename TPotentials,
+	typename TMotifSet,
+	typename TPattern,
+	typename TDuplex,
+	typename TId
+	>
+	inline void _detectTriplexInRegion(TMatches			&matches,
+									   TPotentials		&potentials,
+									   TMotifSet		&tfoMotifSet,
+									   TPattern const	&,
+									   TDuplex			&regionSeq,
+									   TId const		&duplexId,
+									   Options			&options,
+									   BruteForce
+									   ){
+#if SEQAN_ENABLE_PARALLELISM
+		if (options.runtimeMode==RUN_PARALLEL_STRANDS && options.forward && options.reverse){
+			_detectTriplexParallelStrands(matches, potentials, tfoMotifSet, regionSeq, duplexId, options, BruteForce());
+			return;
+		}
+#endif
+		_detectTriplex(matches, potentials, tfoMotifSet, regionSeq, duplexId, options, BruteForce());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Search the regions of one duplex sequence, in parallel in runtime mode 
+	// RUN_PARALLEL_DUPLEX, and output the results in the order of the regions
+	template <
+	typename TRegionSeqs,
+	typename TMotifSet,
+	typename TPattern,
+	typename TFile,
+	typename TId,
+	typename TTag
+	>
+	inline void _searchRegions(TRegionSeqs					&regionSeqs,
+							   String<TGenomicRegion> const	&regions,
+							   CharString					&duplexName,
+							   TId const					&duplexId,
+							   TMotifSet					&tfoMotifSet,
+							   StringSet<CharString> const	&tfoNames,
+							   TPattern const				&pattern,
+							   TFile						&outputfile,
+							   Options						&options,
+							   TTag
+							   ){
+		typedef ::std::list<TMatch>							TMatches;
+		typedef Pair<unsigned, unsigned>					TPotKey;
+		typedef TriplexPotential<TPotKey>					TPotPair;
+		typedef PotentialTable<TPotKey, TPotPair>			TPotentials;
+		typedef Repeat<unsigned, unsigned>					TRepeat;
+		typedef String<TRepeat>								TRepeatString;
+		
+		int numRegions = (int) length(regionSeqs);
+		::std::vector<TMatches> matches(numRegions);
+		::std::vector<TPotentials> potentials(numRegions);
+		
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) if(options.runtimeMode==RUN_PARALLEL_DUPLEX))
+		for (int r=0; r<numRegions; ++r){
+			// find low complexity regions and mask sequences if requested
+			if (options.filterRepeats){
+				TRepeatString	data_repeats;
+				_filterLowComplexityRegions(regionSeqs[r], data_repeats, options);
+			}
+			_detectTriplexInRegion(matches[r], potentials[r], tfoMotifSet, pattern, regionSeqs[r], duplexId, options, TTag());
+		}
+		
+		// output all entries in genomic coordinates, the summary is given per region
+		CharString name;
+		for (int r=0; r<numRegions; ++r){
+			printTriplexEntry(matches[r], duplexName, regionSeqs[r], tfoMotifSet, tfoNames, outputfile, options, regions[r].i1);
+			regionName(name, duplexName, regions[r]);
+			dumpSummary(potentials[r], name, tfoNames, options, TPX());
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Find triplexes only within the regions of a BED file. The region sequences
+	// are read directly using the FASTA index of an uncompressed duplex file if 
+	// available (<duplex file>.fai), otherwise they are sliced from the duplex 
+	// sequences while reading through the file. Sequences without regions are 
+	// skipped.
+	template <
+	typename TMotifSet,
+	typename TPattern,
+	typename TFile,
+	typename TId,
+	typename TTag
+	>
+	int inline startTriplexSearchRegions(TMotifSet					&tfoMotifSet,
+										 StringSet<CharString> const	&tfoNames,
+										 TPattern const				&pattern,
+										 TFile						&outputfile,
+										 TId						duplexSeqNo,
+										 TRegionMap const			&regions,
+										 Options					&options,
+										 TTag
+										 ){
+		typedef TriplexString								TDuplex;
+		typedef ::std::vector<TDuplex>						TRegionSeqs;
+		
+		// open duplex file
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
+			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
+		
+		// use the FASTA index for random access to the regions of an uncompressed file
+		String<FaiEntry> faiIndex;
+		::std::string faiFileName(toCString(options.duplexFileNames[0]));
+		faiFileName += ".fai";
+		bool indexed = _inputCompression(toCString(options.duplexFileNames[0])) == INPUT_PLAIN && readFaiIndex(faiIndex, faiFileName.c_str());
+		if (indexed)
+			options.logFileHandle << _getTimeStamp() << " * Reading regions using the index " << faiFileName << ::std::endl;
+		
+		::std::set< ::std::string > found;	// sequence names of the regions found in the duplex file
+		TId duplexSeqNoWithinFile = 0;
+		for(; indexed ? duplexSeqNoWithinFile < (TId) length(faiIndex) : !_streamEOF(file); ++duplexSeqNo,++duplexSeqNoWithinFile){
+			CharString duplexName;
+			TDuplex duplexSeq;
+			if (indexed){
+				duplexName = faiIndex[duplexSeqNoWithinFile].name;
+			} else {
+				readShortID(file, duplexName, Fasta());	// read Fasta id up to first whitespace
+				read(file, duplexSeq, Fasta());			// read Fasta sequence
+			}
+			TRegionMap::const_iterator it = regions.find(toCString(duplexName));
+			if (it == regions.end())
+				continue;
+			found.insert(it->first);
+			if (options._debugLevel >= 2)
+				::std::cerr << "Processing:\t" << duplexName << "\t(" << length(it->second) << " regions)\r" << ::std::flush;
+			
+			// slice the region sequences
+			String<TGenomicRegion> const &seqRegions = it->second;
+			TRegionSeqs regionSeqs(length(seqRegions));
+			for (unsigned r=0; r<length(seqRegions); ++r){
+				if (indexed){
+					if (!readFaiSlice(regionSeqs[r], file, faiIndex[duplexSeqNoWithinFile], seqRegions[r].i1, seqRegions[r].i2))
+						return TRIPLEX_DUPLEXREAD_FAILED;
+				} else if (seqRegions[r].i1 < (__int64) length(duplexSeq)){
+					assign(regionSeqs[r], infix(duplexSeq, seqRegions[r].i1, ::std::min(seqRegions[r].i2, (__int64) length(duplexSeq))));
+				}
+			}
+			clear(duplexSeq);
+			
+			_searchRegions(regionSeqs, seqRegions, duplexName, duplexSeqNoWithinFile, tfoMotifSet, tfoNames, pattern, outputfile, options, TTag());
+		}
+		input.close();
+		
+		// report every sequence name of the region file that is missing once
+		for (TRegionMap::const_iterator it = regions.begin(); it != regions.end(); ++it){
+			if (found.find(it->first) == found.end())
+				options.logFileHandle << _getTimeStamp() << " * Sequence " << it->first << " of the region file is not in the duplex file, skipped " << length(it->second) << " regions" << ::std::endl;
+		}
+		return TRIPLEX_NORMAL_PROGAM_EXIT;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Motifs still searched by the off-target scan, filtered with a q-gram 
+	// index that is rebuilt whenever motifs are retired
+	template <typename TMotifSet, typename TShape, typename TSpec>
+	struct OffTargetFilter
+	{
+		typedef Index<TMotifSet, IndexQGram<TShape, OpenAddressing> >					TQGramIndex;
+		typedef Pattern<TQGramIndex, QGramsLookup< TShape, Standard_QGramsLookup > >	TPattern;
+		
+		TMotifSet		liveSet;		// motifs of the TFO sequences not retired yet
+		TShape			shape;
+		TQGramIndex		*index;
+		TPattern		*pattern;
+		
+		OffTargetFilter(TShape const &_shape):
+		shape(_shape), index(NULL), pattern(NULL) {}
+		
+		~OffTargetFilter()
+		{
+			delete pattern;
+			delete index;
+		}
+		
+	private:
+		OffTargetFilter(OffTargetFilter const &);
+		OffTargetFilter & operator=(OffTargetFilter const &);
+	};
+	
+	// motifs still searched by the off-target scan without filter
+	template <typename TMotifSet, typename TShape>
+	struct OffTargetFilter<TMotifSet, TShape, BruteForce>
+	{
+		TMotifSet		liveSet;		// motifs of the TFO sequences not retired yet
+		
+		OffTargetFilter(TShape const &) {}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// keep only the motifs of TFO sequences that are not retired
+	template <typename TMotifSet, typename TShape, typename TSpec>
+	inline void _setLiveMotifs(OffTargetFilter<TMotifSet, TShape, TSpec>	&filter,
+							   TMotifSet const								&tfoMotifSet,
+							   String<bool> const							&retired)
+	{
+		typedef OffTargetFilter<TMotifSet, TShape, TSpec>	TFilter;
+		
+		clear(filter.liveSet);
+		for (unsigned i=0; i<length(tfoMotifSet); ++i){
+			if (!retired[getSequenceNo(tfoMotifSet[i])])
+				appendValue(filter.liveSet, tfoMotifSet[i]);
+		}
+		delete filter.pattern;
+		delete filter.index;
+		filter.pattern = NULL;
+		filter.index = NULL;
+		if (!empty(filter.liveSet)){
+			filter.index = new typename TFilter::TQGramIndex(filter.liveSet);
+			resize(indexShape(*filter.index), weight(filter.shape));
+			filter.pattern = new typename TFilter::TPattern(*filter.index, filter.shape);
+		}
+	}
+	
+	template <typename TMotifSet, typename TShape>
+	inline void _setLiveMotifs(OffTargetFilter<TMotifSet, TShape, BruteForce>	&filter,
+							   TMotifSet const									&tfoMotifSet,
+							   String<bool> const								&retired)
+	{
+		clear(filter.liveSet);
+		for (unsigned i=0; i<length(tfoMotifSet); ++i){
+			if (!retired[getSequenceNo(tfoMotifSet[i])])
+				appendValue(filter.liveSet, tfoMotifSet[i]);
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// search the live motifs in a batch of putative TTSs
+	template <typename TPotentials, typename TMotifSet, typename TShape, typename TSpec, typename TTtsSet, typename TId>
+	inline void _detectOffTargets(TPotentials								&potentials,
+								  OffTargetFilter<TMotifSet, TShape, TSpec>	&filter,
+								  TTtsSet									&ttsSet,
+								  TId const									&duplexId,
+								  bool										plusstrand,
+								  Options									&options)
+	{
+		::std::list<TMatch> matches;	// stays empty, only potentials are counted
+		_searchTtsBatch(matches, potentials, *filter.pattern, filter.liveSet, ttsSet, duplexId, plusstrand, options, TSpec());
+	}
+	
+	template <typename TPotentials, typename TMotifSet, typename TShape, typename TTtsSet, typename TId>
+	inline void _detectOffTargets(TPotentials									&potentials,
+								  OffTargetFilter<TMotifSet, TShape, BruteForce>	&filter,
+								  TTtsSet										&ttsSet,
+								  TId const										&duplexId,
+								  bool,
+								  Options										&options)
+	{
+		::std::list<TMatch> matches;	// stays empty, only potentials are counted
+		_searchTtsSetBruteForce(matches, potentials, filter.liveSet, ttsSet, duplexId, options);
+	}
+	
+	// number of putative TTSs per strand searched before TFO sequences are retired
+	static const unsigned OFF_TARGET_BATCH_SIZE = 256;
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Off-target scan: count the triplexes of each TFO sequence over all duplex
+	// sequences without storing them. The putative TTSs of a duplex sequence are
+	// searched in batches. Once a TFO sequence reaches the off-target cap it is 
+	// retired, i.e. its motifs are removed from the search of all following 
+	// batches, and the scan ends early when no TFO sequence is left. Outputs the
+	// number of off-targets per TFO sequence.
+	template <
+	typename TMotifSet,
+	typename TFile,
+	typename TShape,
+	typename TSpec
+	>
+	int inline startOffTargetScan(TMotifSet					&tfoMotifSet,
+								  StringSet<CharString> const	&tfoNames,
+								  TFile						&outputfile,
+								  Options					&options,
+								  TShape const				&shape,
+								  TSpec
+								  ){
+		typedef TriplexString								TDuplex;
+		typedef __int64										TId;
+		typedef Pair<unsigned, unsigned>					TPotKey;
+		typedef TriplexPotential<TPotKey>					TPotPair;
+		typedef PotentialTable<TPotKey, TPotPair>			TPotentials;
+		typedef typename Iterator<TPotentials>::Type		TPotIter;
+		typedef Repeat<unsigned, unsigned>					TRepeat;
+		typedef String<TRepeat>								TRepeatString;
+		
+		// open duplex file
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
+			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
+		
+		unsigned numTfos = length(tfoNames);
+		String<unsigned> offTargets;
+		String<bool> retired;
+		resize(offTargets, numTfos, 0u, Exact());
+		resize(retired, numTfos, false, Exact());
+		unsigned numRetired = 0;
+		
+		OffTargetFilter<TMotifSet, TShape, TSpec> filter(shape);
+		_setLiveMotifs(filter, tfoMotifSet, retired);
+		
+		TId duplexSeqNoWithinFile = 0;
+		for(; !empty(filter.liveSet) && !_streamEOF(file); ++duplexSeqNoWithinFile){
+			TPotentials potentials;
+			TDuplex	duplexSeq;
+			CharString duplexName;
+			readShortID(file, duplexName, Fasta());	// read Fasta id up to first whitespace
+			read(file, duplexSeq, Fasta());			// read Fasta sequence
+			if (options._debugLevel >= 2)
+				::std::cerr << "Processing:\t" << duplexName << "\t(" << length(filter.liveSet) << " TFO motifs left)\r" << ::std::flush;
+			
+			// find low complexity regions and mask sequences if requested
+			if (options.filterRepeats){
+				TRepeatString	data_repeats;
+				_filterLowComplexityRegions(duplexSeq, data_repeats, options);
+			}
+			
+			// collect the putative TTSs of both strands
+			TTargetSet strands[2];
+			bool reduceSet = true; // merge overlapping features
+			if (options.forward)
+				processDuplex(strands[0], duplexSeq, duplexSeqNoWithinFile, true, reduceSet, options);
+			if (options.reverse)
+				processDuplex(strands[1], duplexSeq, duplexSeqNoWithinFile, false, reduceSet, options);
+			
+			// search the TTSs batch by batch, TFO sequences that reached the cap 
+			// are retired before the next batch
+			unsigned numTts = _max(length(strands[0]), length(strands[1]));
+			for (unsigned b=0; b<numTts && !empty(filter.liveSet); b+=OFF_TARGET_BATCH_SIZE){
+				TTargetSet batches[2];
+				TPotentials batchPotentials[2];
+				for (int s=0; s<2; ++s){
+					unsigned batchEnd = _min(b + OFF_TARGET_BATCH_SIZE, (unsigned) length(strands[s]));
+					for (unsigned k=b; k<batchEnd; ++k)
+						appendValue(batches[s], strands[s][k]);
+				}
+#if SEQAN_ENABLE_PARALLELISM
+				bool parallelStrands = (options.runtimeMode==RUN_PARALLEL_STRANDS);
+				SEQAN_PRAGMA_IF_PARALLEL(omp parallel for num_threads(2) if(parallelStrands))
+#endif
+				for (int s=0; s<2; ++s){
+					if (!empty(batches[s]))
+						_detectOffTargets(batchPotentials[s], filter, batches[s], duplexSeqNoWithinFile, s == 0, options);
+				}
+				
+				unsigned newlyRetired = 0;
+				for (int s=0; s<2; ++s){
+					for (TPotIter it = begin(batchPotentials[s]); it != end(batchPotentials[s]); ++it){
+						unsigned seqNo = key(*it).i1;
+						offTargets[seqNo] += getCounts(cargo(*it));
+						if (!retired[seqNo] && offTargets[seqNo] >= options.offTargetCap){
+							retired[seqNo] = true;
+							++newlyRetired;
+						}
+					}
+					_savePotentials(potentials, batchPotentials[s]);
+				}
+				if (newlyRetired > 0){
+					numRetired += newlyRetired;
+					options.logFileHandle << _getTimeStamp() << "   ... " << numRetired << " of " << numTfos << " TFO sequences reached the off-target cap in " << duplexName << ::std::endl;
+					_setLiveMotifs(filter, tfoMotifSet, retired);
+				}
+			}
+			dumpSummary(potentials, duplexName, tfoNames, options, TPX() );
+		}
+		if (empty(filter.liveSet) && !_streamEOF(file))
+			options.logFileHandle << _getTimeStamp() << " * All TFO sequences reached the off-target cap, skipping the remaining duplex sequences" << ::std::endl;
+		input.close();
+		
+		// output the number of off-targets per TFO sequence
+		char _sep_ = '\t';
+		for (unsigned seqNo=0; seqNo<numTfos; ++seqNo)
+			outputfile << tfoNames[seqNo] << _sep_ << offTargets[seqNo] << _sep_ << (retired[seqNo]?"capped":"complete") << '\n';
+		return TRIPLEX_NORMAL_PROGAM_EXIT;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Search a batch of putative TTSs of one strand with the q-gram filter
+	template <
+	typename TMatches,
+	typename TPotentials,
+	typename TPattern,
+	typename TMotifSet,
+	typename TTtsSet,
+	typename TId,
+	typename TGardenerSpec
+	>
+	inline void _searchTtsBatch(TMatches				&matches,
+								TPotentials				&potentials,
+								TPattern const			&pattern,
+								TMotifSet const			&,
+								TTtsSet					&ttsSet,
+								TId const				&duplexId,
+								bool					plusstrand,
+								Options					&options,
+								Gardener<TId, TGardenerSpec>
+								){
+		typedef Gardener<TId, TGardenerSpec>	TGardener;
+		
+		if (empty(ttsSet))
+			return;
+		TGardener gardener;
+		_filterTriplex(gardener, pattern, ttsSet, options);
+		_verifyAndStore(matches, potentials, gardener, pattern, ttsSet, duplexId, plusstrand, options);
+		eraseAll(gardener);
+	}
+	
+	// Search a batch of putative TTSs without filter
+	template <
+	typename TMatches,
+	typename TPotentials,
+	typename TPattern,
+	typename TMotifSet,
+	typename TTtsSet,
+	typename TId
+	>
+	inline void _searchTtsBatch(TMatches				&matches,
+								TPotentials				&potentials,
+								TPattern const			&,
+								TMotifSet const			&tfoMotifSet,
+								TTtsSet					&ttsSet,
+								TId const				&duplexId,
+								bool,
+								Options					&options,
+								BruteForce
+								){
+		if (empty(ttsSet))
+			return;
+		_detectTriplexBruteForce(matches, potentials, tfoMotifSet, ttsSet, duplexId, options);
+	}
+	
 #if SEQAN_ENABLE_PARALLELISM	
 	//////////////////////////////////////////////////////////////////////////////
 	// Find triplexes in many duplex sequences (import from Fasta) in parallel
@@ -3989,15 +5081,15 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef ::std::vector<TSeq>								TDataContainer;
 		typedef Repeat<unsigned, unsigned>						TRepeat;
 		typedef String<TRepeat>									TRepeatString; 
-		typedef typename Iterator<TRepeatString, Rooted>::Type	TRepeatIterator;
 		
 		TDataContainer data;
 		
 		// open duplex file and read all fasta files
-		::std::ifstream file;
-		file.open(toCString(options.duplexFileNames[0]), ::std::ios_base::in | ::std::ios_base::binary);
-		if (!file.is_open())
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
 			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
 		
 		// remove the directory prefix of current duplex file
 		::std::string duplexFile(toCString(options.duplexFileNames[0]));
@@ -4022,16 +5114,13 @@ namespace SEQAN_NAMESPACE_MAIN
 			CharString duplexId;
 			readShortID(file, duplexId, Fasta());	// read Fasta id up to first whitespace
 			read(file, duplexString, Fasta());		// read Fasta sequence
+			if (_isCheckpointed(duplexSeqNoWithinFile, options))
+				continue;							// finished by a previous run
 			
 			// find low complexity regions and mask sequences if requested
 			if (options.filterRepeats){
 				TRepeatString	data_repeats;
-				findRepeats(data_repeats, duplexString, options.minRepeatLength, options.maxRepeatPeriod);
-				for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-					TRepeat repeat = *rbeg;
-					CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-					replace(duplexString, repeat.beginPosition, repeat.endPosition, replacement);
-				}				
+				_filterLowComplexityRegions(duplexString, data_repeats, options);
 				if (options._debugLevel > 1 )
 					options.logFileHandle << _getTimeStamp() << "   ... Finished low complexity filtering of duplex sequence" << ::std::endl;
 			}
@@ -4052,11 +5141,292 @@ namespace SEQAN_NAMESPACE_MAIN
 			::std::cerr << "Outputting results\r" << ::std::endl;
 		
 		options.timeFindTriplexes += SEQAN_PROTIMEDIFF(find_time);
-		file.close();
+		input.close();
 		return TRIPLEX_NORMAL_PROGAM_EXIT;
 	}
 #endif 
 	
+#if SEQAN_ENABLE_PARALLELISM	
+	//////////////////////////////////////////////////////////////////////////////
+	// Task-based search (runtime mode 4)
+	//
+	// Duplex sequences are read in windows and every sequence becomes a task 
+	// that masks repeats and collects the putative TTSs of both strands (in 
+	// tasks of their own). The TTSs are then split into batches that are 
+	// searched as tasks, too. Idle threads pick up pending tasks of any 
+	// sequence of the window, such that a few long and many short sequences 
+	// in the same file all keep the threads busy. Results are output per 
+	// window in the order of the file.
+	
+	template <typename TMatches, typename TPotentials>
+	struct DuplexTask
+	{
+		static const unsigned BATCH_SIZE = 256;			// TTSs per batch
+		
+		__int64						seqNo;
+		CharString					name;
+		TDuplex						duplex;
+		TTargetSet					strands[2];			// forward, reverse
+		::std::vector<TTargetSet>	batches;			// forward strand first
+		::std::vector<bool>			plusstrand;			// strand of each batch
+		::std::vector<TMatches>		matches;			// per batch
+		::std::vector<TPotentials>	potentials;			// per batch
+	};
+	
+	// number of nucleotides read ahead before the tasks of a window are waited for
+	static const __int64 DUPLEX_TASK_WINDOW_BASES = 1 << 26;
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// process one duplex sequence, spawns tasks for the strands and TTS batches
+	template <
+	typename TMatches,
+	typename TPotentials,
+	typename TPattern,
+	typename TMotifSet,
+	typename TTag
+	>
+	inline void _runDuplexTask(DuplexTask<TMatches, TPotentials>	*task,
+							   TPattern const						&pattern,
+							   TMotifSet const						&tfoMotifSet,
+							   Options								&options,
+							   TTag
+							   ){
+		typedef Repeat<unsigned, unsigned>	TRepeat;
+		typedef String<TRepeat>				TRepeatString;
+		
+		if (options.filterRepeats){
+			TRepeatString	data_repeats;
+			_filterLowComplexityRegions(task->duplex, data_repeats, options);
+		}
+		
+		bool reduceSet = true; // merge overlapping features
+		for (int s=0; s<2; ++s){
+			if ((s == 0 && !options.forward) || (s == 1 && !options.reverse))
+				continue;
+			SEQAN_PRAGMA_IF_PARALLEL(omp task default(shared) firstprivate(task, s, reduceSet))
+			processDuplex(task->strands[s], task->duplex, task->seqNo, s == 0, reduceSet, options);
+		}
+		SEQAN_PRAGMA_IF_PARALLEL(omp taskwait)
+		
+		for (int s=0; s<2; ++s){
+			TTargetSet &strandSet = task->strands[s];
+			for (unsigned b=0; b<length(strandSet); b+=task->BATCH_SIZE){
+				task->batches.push_back(TTargetSet());
+				task->plusstrand.push_back(s == 0);
+				TTargetSet &batch = task->batches.back();
+				unsigned batchEnd = _min(b + task->BATCH_SIZE, (unsigned) length(strandSet));
+				reserve(batch, batchEnd - b, Exact());
+				for (unsigned k=b; k<batchEnd; ++k)
+					appendValue(batch, strandSet[k]);
+			}
+		}
+		
+		int numBatches = task->batches.size();
+		task->matches.resize(numBatches);
+		task->potentials.resize(numBatches);
+		for (int b=0; b<numBatches; ++b){
+			SEQAN_PRAGMA_IF_PARALLEL(omp task default(shared) firstprivate(task, b))
+			_searchTtsBatch(task->matches[b], task->potentials[b], pattern, tfoMotifSet, task->batches[b], task->seqNo, task->plusstrand[b], options, TTag());
+		}
+		SEQAN_PRAGMA_IF_PARALLEL(omp taskwait)
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Find triplexes in many duplex sequences (import from Fasta) with tasks
+	template <
+	typename TMotifSet,
+	typename TFile,
+	typename TPattern,
+	typename TId,
+	typename TTag
+	>
+	int inline startTriplexSearchTasks(TMotifSet					&tfoMotifSet,
+									   StringSet<CharString> const	&tfoNames,
+									   TPattern const				&pattern,
+									   TFile						&outputfile,
+									   TId							duplexSeqNo,
+									   Options						&options,
+									   TTag
+									   ){
+		typedef ::std::list<TMatch>							TMatches;
+		typedef Pair<unsigned, unsigned>					TPotKey;
+		typedef TriplexPotential<TPotKey>					TPotPair;
+		typedef PotentialTable<TPotKey, TPotPair>			TPotentials;
+		typedef DuplexTask<TMatches, TPotentials>			TTask;
+		
+		// open duplex file
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
+			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
+		
+		::std::vector<TTask *> window;
+		unsigned maxWindowSize = 4 * options.processors;
+		
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel)
+		SEQAN_PRAGMA_IF_PARALLEL(omp single)
+		while (!_streamEOF(file)){
+			// read the next window, every duplex sequence becomes a task
+			__int64 windowBases = 0;
+			while (!_streamEOF(file) && window.size() < maxWindowSize && windowBases < DUPLEX_TASK_WINDOW_BASES){
+				TTask *task = new TTask();
+				task->seqNo = duplexSeqNo++;
+				readShortID(file, task->name, Fasta());	// read Fasta id up to first whitespace
+				read(file, task->duplex, Fasta());			// read Fasta sequence
+				if (_isCheckpointed(task->seqNo, options)){
+					delete task;							// finished by a previous run
+					continue;
+				}
+				windowBases += length(task->duplex);
+				window.push_back(task);
+				if (options._debugLevel >= 2)
+					::std::cerr << "Processing:\t" << task->name << "\t(seq " << task->seqNo << ")\r" << ::std::flush;
+				SEQAN_PRAGMA_IF_PARALLEL(omp task default(shared) firstprivate(task))
+				_runDuplexTask(task, pattern, tfoMotifSet, options, TTag());
+			}
+			SEQAN_PRAGMA_IF_PARALLEL(omp taskwait)
+			
+			// output in the order of the file
+			for (unsigned i=0; i<window.size(); ++i){
+				TTask *task = window[i];
+				TMatches matches;
+				TPotentials potentials;
+				for (unsigned b=0; b<task->batches.size(); ++b){
+					matches.splice(matches.end(), task->matches[b]);
+					_savePotentials(potentials, task->potentials[b]);
+				}
+				printTriplexEntry(matches, task->name, task->duplex, tfoMotifSet, tfoNames, outputfile, options);
+				dumpSummary(potentials, task->name, tfoNames, options, TPX() );
+				_recordCheckpoint(outputfile, task->seqNo, task->name, options);
+				delete task;
+			}
+			window.clear();
+		}
+		input.close();
+		return TRIPLEX_NORMAL_PROGAM_EXIT;
+	}
+#endif
+	
+	
+#if SEQAN_ENABLE_PARALLELISM	
+	//////////////////////////////////////////////////////////////////////////////
+	// Copy of the TFO motifs (and their q-gram index) owned by a NUMA node
+	//
+	// The copy is made by a thread pinned to the node, such that it is placed 
+	// in the memory of the node. The TFO sequences the motifs refer to are 
+	// shared, the search only reads them when verifying a hit.
+	
+	template <typename TMotifSet, typename TPattern>
+	struct NumaReplica
+	{
+		TMotifSet		motifs;
+		
+		NumaReplica(TMotifSet const &tfoSet, TPattern const &):
+		motifs(tfoSet) {}
+		
+		TPattern const & pattern(TPattern const &shared) const
+		{
+			return shared;
+		}
+	};
+	
+	template <typename TMotifSet, typename TIndex, typename TShape, typename TSpec>
+	struct NumaReplica<TMotifSet, Pattern<TIndex, QGramsLookup<TShape, TSpec> > >
+	{
+		typedef Pattern<TIndex, QGramsLookup<TShape, TSpec> >	TPattern;
+		
+		TMotifSet		motifs;
+		TIndex			index;
+		TPattern		*_pattern;
+		
+		NumaReplica(TMotifSet const &tfoSet, TPattern const &shared):
+		motifs(tfoSet), index(motifs)
+		{
+			indexShape(index) = indexShape(host(shared));
+			_pattern = new TPattern(index, shared.shape, shared.window);
+		}
+		
+		~NumaReplica()
+		{
+			delete _pattern;
+		}
+		
+		TPattern const & pattern(TPattern const &) const
+		{
+			return *_pattern;
+		}
+		
+	private:
+		// not copyable
+		NumaReplica(NumaReplica const &);
+		NumaReplica & operator=(NumaReplica const &);
+	};
+	
+	// a sharded index is meant for TFO sets that fit into memory only once, 
+	// all nodes search the shared shards
+	template <typename TMotifSet, typename TShardedMotifSet, typename TShape>
+	struct NumaReplica<TMotifSet, QGramShards<TShardedMotifSet, TShape> >
+	{
+		typedef QGramShards<TShardedMotifSet, TShape>	TPattern;
+		
+		NumaReplica(TMotifSet const &, TPattern const &) {}
+		
+		TPattern const & pattern(TPattern const &shared) const
+		{
+			return shared;
+		}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Pin the calling thread to its node and return the replica of the node.
+	// Must be called by all threads of a parallel region, the first thread 
+	// of every node creates the replica of the node. The previous affinity of
+	// the thread is kept in affinity, to be restored at the end of the region.
+	template <typename TReplica, typename TMotifSet, typename TPattern>
+	inline TReplica const *
+	_numaLocalReplica(::std::vector<TReplica *>	&replicas,
+					  ThreadAffinity			&affinity,
+					  NumaTopology const		&topology,
+					  TMotifSet const			&tfoSet,
+					  TPattern const			&pattern
+					  ){
+		int thread = omp_get_thread_num();
+		int threads = omp_get_num_threads();
+		unsigned node = numaNodeOfThread(topology, thread, threads);
+		saveThreadAffinity(affinity);
+		pinThreadToNumaNode(topology, node);
+		if (thread == 0 || numaNodeOfThread(topology, thread - 1, threads) != node)
+			replicas[node] = new TReplica(tfoSet, pattern);
+		SEQAN_PRAGMA_IF_PARALLEL(omp barrier)
+		return replicas[node];
+	}
+	
+	template <typename TReplica>
+	inline void
+	_clearNumaReplicas(::std::vector<TReplica *> &replicas)
+	{
+		for (unsigned i=0; i<replicas.size(); ++i)
+			delete replicas[i];
+		replicas.clear();
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// prepare NUMA placement if requested, returns false on single node hosts
+	inline bool
+	_prepareNumaPlacement(NumaTopology &topology, Options &options)
+	{
+		if (!options.numaReplicas)
+			return false;
+		if (!readNumaTopology(topology) || numaNodes(topology) < 2){
+			if (options._debugLevel >= 1)
+				options.logFileHandle << _getTimeStamp() << " - Single NUMA node, threads are not pinned" << ::std::endl;
+			return false;
+		}
+		options.logFileHandle << _getTimeStamp() << " * Pinning threads and replicating the TFO motifs on " << numaNodes(topology) << " NUMA nodes" << ::std::endl;
+		return true;
+	}
+#endif
 	
 #if SEQAN_ENABLE_PARALLELISM	
 	template <
@@ -4085,11 +5455,22 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef Pair<unsigned, unsigned>				TPotKey;
 		typedef TriplexPotential<TPotKey>				TPotPair;
 		typedef TriplexPotential<unsigned>				TPotSingle;
-		typedef Map<Pair<TPotKey,TPotPair>, Skiplist<> >	TPotentials;
+		typedef PotentialTable<TPotKey, TPotPair>		TPotentials;
+		typedef NumaReplica<TMotifSet, TPattern>		TReplica;
+		
+		NumaTopology topology;
+		bool numa = _prepareNumaPlacement(topology, options);
+		::std::vector<TReplica *> replicas(numaNodes(topology), (TReplica *) NULL);
 
 		// parallel section 
 		SEQAN_PRAGMA_IF_PARALLEL(omp parallel)
 		{
+			// search the TFO index of the node the thread is pinned to
+			TPattern const *localPattern = &pattern;
+			ThreadAffinity affinity;
+			if (numa)
+				localPattern = &_numaLocalReplica(replicas, affinity, topology, tfoSet, pattern)->pattern(pattern);
+			
 			SEQAN_PRAGMA_IF_PARALLEL(omp for schedule(dynamic) )
 			for (int i=0; i<(int)length(data);++i){
 				TMatches matches;
@@ -4097,18 +5478,22 @@ namespace SEQAN_NAMESPACE_MAIN
 				TSeq seq = data[i];
 				TCounter duplexCounter = seq.i1;
 				TString duplexName = seq.i2;
-				TDuplex duplex = seq.i3;
+				TDuplex duplex = seq.i3;	// copied by the worker, i.e. placed on its node
 				
-				_detectTriplex(matches, potentials, pattern, duplex, duplexCounter, options, TGardener());
+				_detectTriplex(matches, potentials, *localPattern, duplex, duplexCounter, options, TGardener());
 
-				if (length(matches)>0){
+				if (length(matches)>0 || length(potentials)>0 || options.checkpoint){
 					SEQAN_PRAGMA_IF_PARALLEL(omp critical(printTriplexEntry) ){
 						printTriplexEntry(matches, duplexName, duplex, tfoSet, tfoNames, outputfile, options);
 						dumpSummary(potentials, duplexName, tfoNames, options, TPX());
+						_recordCheckpoint(outputfile, duplexCounter, duplexName, options);
 					}
 				}
 			}
+			// threads of the pool are reused by later parallel regions
+			restoreThreadAffinity(affinity);
 		}
+		_clearNumaReplicas(replicas);
 	}
 #endif
 	
@@ -4136,13 +5521,23 @@ namespace SEQAN_NAMESPACE_MAIN
 		typedef Pair<unsigned, unsigned>				TPotKey;
 		typedef TriplexPotential<TPotKey>				TPotPair;
 		typedef TriplexPotential<unsigned>				TPotSingle;
-		typedef Map<Pair<TPotKey,TPotPair>, Skiplist<> >	TPotentials;
+		typedef PotentialTable<TPotKey, TPotPair>		TPotentials;
 		
-        (void)pattern; // deceive compiler to suppress warning
+		typedef NumaReplica<TMotifSet, TPattern>		TReplica;
+		
+		NumaTopology topology;
+		bool numa = _prepareNumaPlacement(topology, options);
+		::std::vector<TReplica *> replicas(numaNodes(topology), (TReplica *) NULL);
         
 		// parallel section 
 		SEQAN_PRAGMA_IF_PARALLEL(omp parallel)
 		{
+			// search the TFO motifs of the node the thread is pinned to
+			TMotifSet const *localTfoSet = &tfoSet;
+			ThreadAffinity affinity;
+			if (numa)
+				localTfoSet = &_numaLocalReplica(replicas, affinity, topology, tfoSet, pattern)->motifs;
+			
 			SEQAN_PRAGMA_IF_PARALLEL(omp for schedule(dynamic) )
 			for (int i=0; i<(int)length(data);++i){
 				TMatches matches;
@@ -4150,18 +5545,22 @@ namespace SEQAN_NAMESPACE_MAIN
 				TSeq seq = data[i];
 				TCounter duplexCounter = seq.i1;
 				TString duplexName = seq.i2;
-				TDuplex duplex = seq.i3;
+				TDuplex duplex = seq.i3;	// copied by the worker, i.e. placed on its node
 				
-				_detectTriplex(matches, potentials, tfoSet, duplex, duplexCounter, options, BruteForce());
+				_detectTriplex(matches, potentials, *localTfoSet, duplex, duplexCounter, options, BruteForce());
 				
-				if (length(matches)>0){
+				if (length(matches)>0 || length(potentials)>0 || options.checkpoint){
 					SEQAN_PRAGMA_IF_PARALLEL(omp critical(printTriplexEntry) ){
 						printTriplexEntry(matches, duplexName, duplex, tfoSet, tfoNames, outputfile, options);
 						dumpSummary(potentials, duplexName, tfoNames, options, TPX());
+						_recordCheckpoint(outputfile, duplexCounter, duplexName, options);
 					}
 				}
 			}
+			// threads of the pool are reused by later parallel regions
+			restoreThreadAffinity(affinity);
 		}
+		_clearNumaReplicas(replicas);
 	}
 	
 #endif	
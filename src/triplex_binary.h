@@ -0,0 +1,260 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TRIPLEX_BINARY_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_TRIPLEX_BINARY_H
+
+#include <iostream>
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Binary triplex format
+// ============================================================================
+//
+// The binary format stores the fields of each match directly instead of 
+// formatting them as text. A file consists of a fixed header followed by
+// chunks, each introduced by a single tag character:
+//
+//   header	: magic "TPXB", uint32 version
+//   'O'	: TFO name dictionary 
+//			  uint32 n, n x (uint32 length, characters)
+//   'D'	: all matches of one duplex sequence, stored column-wise
+//			  uint32 duplex seqNo, uint32 length, characters (duplex name), uint32 n,
+//			  n x uint32 TFO seqNo, n x int64 TFO begin, TFO end, TTS begin, TTS end,
+//			  n x double score, guanines, n x char motif, strand, orientation
+//
+// Numbers are written in host byte order. Error strings are not stored.
+	
+	enum BINARY_CHUNK
+	{
+		BINARY_CHUNK_TFO_NAMES	= 'O',
+		BINARY_CHUNK_DUPLEX		= 'D'
+	};
+	
+	static const char		TRIPLEX_BINARY_MAGIC[4] = {'T','P','X','B'};
+	static const unsigned	TRIPLEX_BINARY_VERSION = 1;
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// matches of a single duplex held column-wise
+	struct TriplexBinaryChunk
+	{
+		unsigned			duplexSeqNo;	// sequence number of the duplex
+		CharString			duplexName;		// name of the duplex
+		String<unsigned>	tfoSeqNo;		// sequence number of the TFO (index into name dictionary)
+		String<__int64>		oBegin;			// begin in TFO
+		String<__int64>		oEnd;			// end in TFO
+		String<__int64>		dBegin;			// begin in duplex
+		String<__int64>		dEnd;			// end in duplex
+		String<double>		mScore;			// score of the match
+		String<double>		guanines;		// number of guanines in the target
+		String<char>		motif;			// triplex motif
+		String<char>		strand;			// strand of the TTS
+		String<char>		orientation;	// 'P' parallel or 'A' anti-parallel
+		
+		TriplexBinaryChunk():
+		duplexSeqNo(0) {}
+	};
+	
+	inline unsigned length(TriplexBinaryChunk const &chunk)
+	{
+		return length(chunk.tfoSeqNo);
+	}
+	
+	inline void clear(TriplexBinaryChunk &chunk)
+	{
+		clear(chunk.duplexName);
+		clear(chunk.tfoSeqNo);
+		clear(chunk.oBegin);
+		clear(chunk.oEnd);
+		clear(chunk.dBegin);
+		clear(chunk.dEnd);
+		clear(chunk.mScore);
+		clear(chunk.guanines);
+		clear(chunk.motif);
+		clear(chunk.strand);
+		clear(chunk.orientation);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// low-level writing
+	template <typename TFile, typename TValue>
+	inline void _writeBinaryValue(TFile &file, TValue const &val)
+	{
+		file.write(reinterpret_cast<char const *>(&val), sizeof(TValue));
+	}
+	
+	template <typename TFile, typename TValue>
+	inline void _writeBinaryColumn(TFile &file, String<TValue> const &column)
+	{
+		if (!empty(column))
+			file.write(reinterpret_cast<char const *>(begin(column, Standard())), length(column) * sizeof(TValue));
+	}
+	
+	template <typename TFile>
+	inline void _writeBinaryString(TFile &file, CharString const &str)
+	{
+		_writeBinaryValue(file, (unsigned) length(str));
+		_writeBinaryColumn(file, str);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// low-level reading
+	template <typename TFile, typename TValue>
+	inline bool _readBinaryValue(TFile &file, TValue &val)
+	{
+		file.read(reinterpret_cast<char *>(&val), sizeof(TValue));
+		return file.good();
+	}
+	
+	template <typename TFile, typename TValue>
+	inline bool _readBinaryColumn(TFile &file, String<TValue> &column, unsigned n)
+	{
+		resize(column, n, Exact());
+		if (n > 0)
+			file.read(reinterpret_cast<char *>(begin(column, Standard())), n * sizeof(TValue));
+		return file.good();
+	}
+	
+	template <typename TFile>
+	inline bool _readBinaryString(TFile &file, CharString &str)
+	{
+		unsigned len = 0;
+		if (!_readBinaryValue(file, len))
+			return false;
+		return _readBinaryColumn(file, str, len);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// write file header and TFO name dictionary
+	template <typename TFile>
+	inline void writeBinaryHeader(TFile							&file,
+								  StringSet<CharString> const	&tfoNames
+								  ){
+		file.write(TRIPLEX_BINARY_MAGIC, sizeof(TRIPLEX_BINARY_MAGIC));
+		_writeBinaryValue(file, TRIPLEX_BINARY_VERSION);
+		
+		_writeBinaryValue(file, (char) BINARY_CHUNK_TFO_NAMES);
+		_writeBinaryValue(file, (unsigned) length(tfoNames));
+		for (unsigned i=0; i<length(tfoNames); ++i)
+			_writeBinaryString(file, tfoNames[i]);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// write all matches of a duplex
+	template <typename TFile>
+	inline void writeBinaryChunk(TFile						&file,
+								 TriplexBinaryChunk const	&chunk
+								 ){
+		_writeBinaryValue(file, (char) BINARY_CHUNK_DUPLEX);
+		_writeBinaryValue(file, chunk.duplexSeqNo);
+		_writeBinaryString(file, chunk.duplexName);
+		_writeBinaryValue(file, length(chunk));
+		_writeBinaryColumn(file, chunk.tfoSeqNo);
+		_writeBinaryColumn(file, chunk.oBegin);
+		_writeBinaryColumn(file, chunk.oEnd);
+		_writeBinaryColumn(file, chunk.dBegin);
+		_writeBinaryColumn(file, chunk.dEnd);
+		_writeBinaryColumn(file, chunk.mScore);
+		_writeBinaryColumn(file, chunk.guanines);
+		_writeBinaryColumn(file, chunk.motif);
+		_writeBinaryColumn(file, chunk.strand);
+		_writeBinaryColumn(file, chunk.orientation);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read file header, returns false if the file is not in binary triplex format
+	template <typename TFile>
+	inline bool readBinaryHeader(TFile					&file,
+								 StringSet<CharString>	&tfoNames
+								 ){
+		char magic[sizeof(TRIPLEX_BINARY_MAGIC)];
+		file.read(magic, sizeof(magic));
+		if (!file.good())
+			return false;
+		for (unsigned i=0; i<sizeof(magic); ++i)
+			if (magic[i] != TRIPLEX_BINARY_MAGIC[i])
+				return false;
+		
+		unsigned version = 0;
+		if (!_readBinaryValue(file, version) || version != TRIPLEX_BINARY_VERSION)
+			return false;
+		
+		char tag = 0;
+		unsigned n = 0;
+		if (!_readBinaryValue(file, tag) || tag != BINARY_CHUNK_TFO_NAMES || !_readBinaryValue(file, n))
+			return false;
+		
+		clear(tfoNames);
+		resize(tfoNames, n);
+		for (unsigned i=0; i<n; ++i)
+			if (!_readBinaryString(file, tfoNames[i]))
+				return false;
+		return true;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read the next duplex chunk, returns false at the end of the file
+	template <typename TFile>
+	inline bool readBinaryChunk(TFile				&file,
+								TriplexBinaryChunk	&chunk
+								){
+		char tag = 0;
+		unsigned n = 0;
+		clear(chunk);
+		if (!_readBinaryValue(file, tag) || tag != BINARY_CHUNK_DUPLEX)
+			return false;
+		if (!_readBinaryValue(file, chunk.duplexSeqNo) || !_readBinaryString(file, chunk.duplexName) || !_readBinaryValue(file, n))
+			return false;
+		
+		_readBinaryColumn(file, chunk.tfoSeqNo, n);
+		_readBinaryColumn(file, chunk.oBegin, n);
+		_readBinaryColumn(file, chunk.oEnd, n);
+		_readBinaryColumn(file, chunk.dBegin, n);
+		_readBinaryColumn(file, chunk.dEnd, n);
+		_readBinaryColumn(file, chunk.mScore, n);
+		_readBinaryColumn(file, chunk.guanines, n);
+		_readBinaryColumn(file, chunk.motif, n);
+		_readBinaryColumn(file, chunk.strand, n);
+		// a truncated chunk fails on the last column
+		return _readBinaryColumn(file, chunk.orientation, n);
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TRIPLEX_BINARY_H
@@ -0,0 +1,420 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+
+#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TRIPLEX_SERVER_H
+#define FBUSKE_APPS_TRIPLEXATOR_HEADER_TRIPLEX_SERVER_H
+
+#ifndef PLATFORM_WINDOWS
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "triplex.h"
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+
+// ============================================================================
+// Server mode
+// ============================================================================
+//
+// Keeps the duplex sequences and their putative TTSs in memory and answers 
+// triplex searches over a Unix domain socket. A client connects, sends the 
+// TFO sequences in FASTA format and closes its sending side. The matches are 
+// streamed back in the output format the server was started with, then the 
+// connection is closed. Jobs are processed one after another, each using all
+// threads to search the TTS catalog.
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// stream buffer writing to a file descriptor (e.g. a socket)
+	class FdStreamBuf : public ::std::streambuf
+	{
+	public:
+		static const int BUFFER_SIZE = 0x10000;
+		
+		FdStreamBuf(int fd):
+		_fd(fd), _failed(false)
+		{
+			setp(_buffer, _buffer + BUFFER_SIZE);
+		}
+		
+		~FdStreamBuf()
+		{
+			_flush();
+		}
+		
+	protected:
+		virtual int_type overflow(int_type c)
+		{
+			if (!_flush())
+				return traits_type::eof();
+			if (!traits_type::eq_int_type(c, traits_type::eof())){
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+		
+		virtual int sync()
+		{
+			return _flush() ? 0 : -1;
+		}
+		
+	private:
+		int		_fd;
+		bool	_failed;	// the peer went away, further output is discarded
+		char	_buffer[BUFFER_SIZE];
+		
+		FdStreamBuf(FdStreamBuf const &);
+		FdStreamBuf & operator=(FdStreamBuf const &);
+		
+		bool _flush()
+		{
+			char *data = pbase();
+			while (!_failed && data < pptr()){
+				ssize_t written = ::write(_fd, data, pptr() - data);
+				if (written < 0 && errno == EINTR)
+					continue;
+				if (written <= 0)
+					_failed = true;
+				else
+					data += written;
+			}
+			setp(_buffer, _buffer + BUFFER_SIZE);
+			return !_failed;
+		}
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// output stream writing to a file descriptor
+	class FdOutputStream : public ::std::ostream
+	{
+	public:
+		FdOutputStream(int fd):
+		::std::ostream(NULL), _buffer(fd)
+		{
+			rdbuf(&_buffer);
+		}
+		
+	private:
+		FdStreamBuf _buffer;
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// putative TTSs of one strand of a duplex sequence, the catalog is split 
+	// into blocks such that the threads of a job are kept busy
+	struct TtsCatalogBlock
+	{
+		unsigned	seqNo;			// duplex sequence the TTSs are located on
+		bool		plusstrand;
+		TTargetSet	ttsSet;
+	};
+	
+	struct TtsCatalog
+	{
+		static const unsigned BLOCK_SIZE = 1024;	// TTSs per block
+		
+		::std::vector<TDuplex>			duplexes;	// must not be resized once the blocks refer to them
+		StringSet<CharString>			names;
+		::std::vector<TtsCatalogBlock>	blocks;		// ordered by sequence, forward strand first
+		__int64							numTts;
+		
+		TtsCatalog():
+		numTts(0) {}
+	};
+	
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// read all duplex sequences, mask low complexity regions if requested and 
+	// collect their putative TTSs
+	inline int buildTtsCatalog(TtsCatalog	&catalog,
+							   Options		&options)
+	{
+		typedef Repeat<unsigned, unsigned>	TRepeat;
+		typedef String<TRepeat>				TRepeatString;
+		
+		SequenceInputStream input;
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
+			return TRIPLEX_READFILE_FAILED;
+		::std::istream &file = input;
+		
+		CharString duplexName;
+		while (!_streamEOF(file)){
+			readShortID(file, duplexName, Fasta());	// read Fasta id up to first whitespace
+			appendValue(catalog.names, duplexName, Generous());
+			catalog.duplexes.push_back(TDuplex());
+			read(file, catalog.duplexes.back(), Fasta());
+		}
+		input.close();
+		
+		int numSeqs = catalog.duplexes.size();
+		if (options.filterRepeats){
+			SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) if(options.runtimeMode != RUN_SERIAL))
+			for (int i=0; i<numSeqs; ++i){
+				TRepeatString data_repeats;
+				_filterLowComplexityRegions(catalog.duplexes[i], data_repeats, options);
+			}
+		}
+		
+		// both strands of all sequences are processed in parallel
+		String<TTargetSet> strandSets;
+		resize(strandSets, 2 * numSeqs, Exact());
+		bool reduceSet = true; // merge overlapping features
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) if(options.runtimeMode != RUN_SERIAL))
+		for (int i=0; i<2*numSeqs; ++i){
+			bool plusstrand = (i % 2 == 0);
+			if ((plusstrand && options.forward) || (!plusstrand && options.reverse))
+				processDuplex(strandSets[i], catalog.duplexes[i/2], (__int64) (i/2), plusstrand, reduceSet, options);
+		}
+		
+		unsigned numBlocks = 0;
+		for (unsigned i=0; i<length(strandSets); ++i)
+			numBlocks += (length(strandSets[i]) + TtsCatalog::BLOCK_SIZE - 1) / TtsCatalog::BLOCK_SIZE;
+		catalog.blocks.reserve(numBlocks);
+		
+		for (unsigned i=0; i<length(strandSets); ++i){
+			TTargetSet &strandSet = strandSets[i];
+			for (unsigned b=0; b<length(strandSet); b+=TtsCatalog::BLOCK_SIZE){
+				catalog.blocks.push_back(TtsCatalogBlock());
+				TtsCatalogBlock &block = catalog.blocks.back();
+				block.seqNo = i / 2;
+				block.plusstrand = (i % 2 == 0);
+				unsigned blockEnd = _min(b + TtsCatalog::BLOCK_SIZE, (unsigned) length(strandSet));
+				reserve(block.ttsSet, blockEnd - b, Exact());
+				for (unsigned k=b; k<blockEnd; ++k)
+					appendValue(block.ttsSet, strandSet[k]);
+			}
+			catalog.numTts += length(strandSet);
+		}
+		return TRIPLEX_NORMAL_PROGAM_EXIT;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// search all blocks of the catalog in parallel and output the matches in 
+	// catalog order, returns the number of matches
+	template <
+	typename TMotifSet,
+	typename TPattern,
+	typename TFile,
+	typename TSpec
+	>
+	inline __int64 _searchTtsCatalog(TtsCatalog					&catalog,
+									 TMotifSet					&tfoMotifSet,
+									 StringSet<CharString> const	&tfoNames,
+									 TPattern const				&pattern,
+									 TFile						&outputfile,
+									 Options					&options,
+									 TSpec
+									 ){
+		typedef ::std::list<TMatch>							TMatches;
+		typedef Pair<unsigned, unsigned>					TPotKey;
+		typedef TriplexPotential<TPotKey>					TPotPair;
+		typedef PotentialTable<TPotKey, TPotPair>			TPotentials;
+		
+		__int64 numMatches = 0;
+		int numBlocks = catalog.blocks.size();
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) ordered if(options.runtimeMode != RUN_SERIAL))
+		for (int b=0; b<numBlocks; ++b){
+			TtsCatalogBlock &block = catalog.blocks[b];
+			TMatches matches;
+			TPotentials potentials;
+			__int64 duplexId = block.seqNo;
+			_searchTtsBatch(matches, potentials, pattern, tfoMotifSet, block.ttsSet, duplexId, block.plusstrand, options, TSpec());
+			
+			SEQAN_PRAGMA_IF_PARALLEL(omp ordered)
+			{
+				numMatches += length(matches);
+				printTriplexEntry(matches, catalog.names[block.seqNo], catalog.duplexes[block.seqNo], tfoMotifSet, tfoNames, outputfile, options);
+			}
+		}
+		return numMatches;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// answer a job: search the catalog for the given TFO motifs
+	template <
+	typename TMotifSet,
+	typename TFile,
+	typename TShape,
+	typename TGardenerSpec
+	>
+	inline __int64 searchTtsCatalog(TtsCatalog					&catalog,
+									TMotifSet					&tfoMotifSet,
+									StringSet<CharString> const	&tfoNames,
+									TFile						&outputfile,
+									Options						&options,
+									TShape const				&shape,
+									Gardener<__int64, TGardenerSpec>
+									){
+		typedef Index<TMotifSet, IndexQGram<TShape, OpenAddressing> >					TQGramIndex;
+		typedef Pattern<TQGramIndex, QGramsLookup< TShape, Standard_QGramsLookup > >	TPattern;
+		
+		if (empty(tfoMotifSet))
+			return 0;
+		TQGramIndex index_qgram(tfoMotifSet);
+		resize(indexShape(index_qgram), weight(shape));
+		TPattern pattern(index_qgram, shape);
+		return _searchTtsCatalog(catalog, tfoMotifSet, tfoNames, pattern, outputfile, options, Gardener<__int64, TGardenerSpec>());
+	}
+	
+	template <
+	typename TMotifSet,
+	typename TFile,
+	typename TShape
+	>
+	inline __int64 searchTtsCatalog(TtsCatalog					&catalog,
+									TMotifSet					&tfoMotifSet,
+									StringSet<CharString> const	&tfoNames,
+									TFile						&outputfile,
+									Options						&options,
+									TShape const				&,
+									BruteForce
+									){
+		if (empty(tfoMotifSet))
+			return 0;
+		return _searchTtsCatalog(catalog, tfoMotifSet, tfoNames, tfoMotifSet, outputfile, options, BruteForce());
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// socket handling
+	
+	// set on SIGINT/SIGTERM, the server stops once the current job is answered
+	static volatile sig_atomic_t _serverStopRequested = 0;
+	
+	inline void _requestServerStop(int)
+	{
+		_serverStopRequested = 1;
+	}
+	
+	// a client that goes away must not kill the server, termination requests 
+	// interrupt waiting for the next job
+	inline void installServerSignalHandlers()
+	{
+		struct sigaction action;
+		::std::memset(&action, 0, sizeof(action));
+		action.sa_handler = _requestServerStop;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = 0;
+		::sigaction(SIGINT, &action, NULL);
+		::sigaction(SIGTERM, &action, NULL);
+		::signal(SIGPIPE, SIG_IGN);
+	}
+	
+	// indicates if the given path exists but is not a socket, such a file is never replaced by the server
+	inline bool isServerPathTaken(char const *path)
+	{
+		struct stat info;
+		return ::lstat(path, &info) == 0 && !S_ISSOCK(info.st_mode);
+	}
+	
+	// create a Unix domain socket listening on the given path, returns -1 on failure
+	inline int openServerSocket(char const *path)
+	{
+		sockaddr_un address;
+		if (::std::strlen(path) >= sizeof(address.sun_path) || isServerPathTaken(path))
+			return -1;
+		::std::memset(&address, 0, sizeof(address));
+		address.sun_family = AF_UNIX;
+		::std::strcpy(address.sun_path, path);
+		
+		int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0)
+			return -1;
+		// remove a socket left behind by a server that did not shut down cleanly
+		struct stat info;
+		if (::lstat(path, &info) == 0 && S_ISSOCK(info.st_mode))
+			::unlink(path);
+		if (::bind(fd, (sockaddr *) &address, sizeof(address)) < 0 || ::listen(fd, 16) < 0){
+			::close(fd);
+			return -1;
+		}
+		return fd;
+	}
+	
+	inline void closeServerSocket(int fd, char const *path)
+	{
+		::close(fd);
+		::unlink(path);
+	}
+	
+	// wait for the next client, returns -1 if the server should stop
+	inline int acceptServerJob(int fd)
+	{
+		while (!_serverStopRequested){
+			int connection = ::accept(fd, NULL, NULL);
+			if (connection >= 0)
+				return connection;
+			if (errno != EINTR && errno != ECONNABORTED)
+				return -1;
+		}
+		return -1;
+	}
+	
+	// read the job, i.e. everything the client sends until it closes its sending side
+	inline bool readServerJob(CharString	&text,
+							  int			connection)
+	{
+		char buffer[0x10000];
+		clear(text);
+		for (;;){
+			ssize_t bytes = ::read(connection, buffer, sizeof(buffer));
+			if (bytes == 0)
+				return true;
+			if (bytes < 0){
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+			unsigned oldLength = length(text);
+			resize(text, oldLength + bytes, Generous());
+			::std::memcpy(begin(text, Standard()) + oldLength, buffer, bytes);
+		}
+	}
+
+} //namespace SEQAN_NAMESPACE_MAIN
+
+#endif  // #ifndef PLATFORM_WINDOWS
+
+#endif //#ifndef FBUSKE_APPS_TRIPLEXATOR_HEADER_TRIPLEX_SERVER_H
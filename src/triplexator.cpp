@@ -56,6 +56,7 @@
 #include <seqan/file.h>
 #include "triplexator.h"
 #include "triplex.h"
+#include "triplex_server.h"
 
 #include <iostream>
 #include <sstream>
@@ -85,6 +86,10 @@ namespace SEQAN_NAMESPACE_MAIN
 		addHelpLine(parser, "");
 		addOption(parser, addArgumentText(CommandLineOption("ss",  "single-strand-file",    "File in FASTA format that is searched for TFOs (e.g. RNA or DNA)", OptionType::String), "<FILE>"));
 		addOption(parser, addArgumentText(CommandLineOption("ds", "duplex-file", 			"File in FASTA format that is searched for TTSs (e.g. DNA)", OptionType::String), "<FILE>"));
+		addOption(parser, addArgumentText(CommandLineOption("bed", "region-file", 			"File in BED format restricting the triplex search to these regions of the duplex", OptionType::String), "<FILE>"));
+#ifndef PLATFORM_WINDOWS
+		addOption(parser, addArgumentText(CommandLineOption("srv", "server", 				"Keep the duplex (-ds) in memory and search TFOs sent to this Unix domain socket", OptionType::String), "<SOCKET>"));
+#endif
 		addSection(parser, "Main Options:");
 		addOption(parser, CommandLineOption("l",  "lower-length-bound",						"minimum triplex feature length required", OptionType::Int| OptionType::Label, options.minLength));
 		addOption(parser, CommandLineOption("L",  "upper-length-bound",						"maximum triplex feature length permitted, -1 = unrestricted ", OptionType::Int | OptionType::Label, options.maxLength ));
@@ -110,6 +115,9 @@ namespace SEQAN_NAMESPACE_MAIN
 		addHelpLine(parser, "1 = permissive  detect duplicates in sequence space, e.g. AGGGAcGAGGA != AGGGAtGAGGA");	
 		addHelpLine(parser, "2 = strict      detect duplicates in target space, e.g. AGGGAcGAGGA == AGGGAtGAGGA == AGGGAnGAGGA");
 		addOption(parser, addArgumentText(CommandLineOption("ssd", "same-sequence-duplicates",	"whether to count a feature copy in the same sequence as duplicates or not.", OptionType::String | OptionType::Label, (options.sameSequenceDuplicates?"on":"off")), "[on|off]"));
+		addOption(parser, CommandLineOption("oc", "off-target-cap",							"off-target scan: stop searching a TFO sequence once it has this many triplexes, 0 = off", OptionType::Int | OptionType::Label, options.offTargetCap));
+		addHelpLine(parser, "Outputs the number of triplexes (off-targets) per TFO sequence instead of the triplexes.");
+		addOption(parser, CommandLineOption("tk", "top-k",									"report only the k best-scoring triplexes per TFO sequence, 0 = all", OptionType::Int | OptionType::Label, options.topK));
 		addOption(parser, CommandLineOption("v",  "verbose",			"verbose mode", OptionType::Boolean));
 		addOption(parser, CommandLineOption("vv", "vverbose",			"very verbose mode", OptionType::Boolean));
 		addSection(parser, "Filtration Options:");
@@ -118,13 +126,21 @@ namespace SEQAN_NAMESPACE_MAIN
 		addHelpLine(parser, "1 = q-gram filtering          filter hits using qgrams (benefical for features > 20 nt)");
 		addOption(parser, CommandLineOption("t", "qgram-threshold",		"number of q-grams (must be > 0)", OptionType::Int | OptionType::Label, options.qgramThreshold));
 		addHelpLine(parser, "A higher threshold means more stringent filtering therefore requiring fewer validations but also leads to shorter qgrams, which increases the number of lookups.");
+		addOption(parser, CommandLineOption("ch", "clip-hits",			"clip q-gram hits to their longest match within the error rate before verification", OptionType::Boolean));
+		addOption(parser, CommandLineOption("is", "index-shard-size",	"split the q-gram index of the TFOs into shards of at most this many nucleotides, built in parallel and all kept in memory, 0 = single index", OptionType::Int | OptionType::Label, options.indexShardSize));
+		addOption(parser, CommandLineOption("mw", "minimizer-window",	"look up only the rarest q-gram out of this many consecutive TTS q-grams, 1 = all q-grams", OptionType::Int | OptionType::Label, options.minimizerWindow));
+		addOption(parser, CommandLineOption("sw", "swift-filter",		"count q-gram hits in diagonal buckets (SWIFT) instead of collecting them per seed", OptionType::Boolean));
 		addOption(parser, addArgumentText(CommandLineOption("fr",  "filter-repeats",         "if enabled, disregards repeat and low-complex regions ", OptionType::String | OptionType::Label, (options.filterRepeats?"on":"off")), "[on|off]"));
 		addOption(parser, CommandLineOption("mrl",  "minimum-repeat-length","minimum length requirement for low-complex regions to be filtered", OptionType::Int | OptionType::Label, options.minRepeatLength));
 		addOption(parser, CommandLineOption("mrp",  "maximum-repeat-period","maximum repeat period for low-complex regions to be filtered", OptionType::Int | OptionType::Label, options.maxRepeatPeriod));
+		addOption(parser, CommandLineOption("rts",  "repeat-tile-size",		"search low-complex regions in tiles of this size in parallel (0 = whole sequence)", OptionType::Int | OptionType::Label, options.repeatTileSize));
 		addOption(parser, CommandLineOption("dc",   "duplicate-cutoff",		"disregard feature if it occurs more often than this cutoff, disable with -1.", OptionType::Int | OptionType::Label, options.duplicatesCutoff));
 		addSection(parser, "Output Options:");
 #ifdef BOOST
 		addOption(parser, CommandLineOption("z", "zip",					"compress output with gzip (requires gzip & boost)", OptionType::Boolean));
+#endif
+#if SEQAN_HAS_ZLIB
+		addOption(parser, CommandLineOption("bz", "bgzf",				"compress output in BGZF format (tabix-compatible) using this number of threads, written to standard out without -o. 0 = off, -1 = detect automatically.", OptionType::Int | OptionType::Label, options.bgzfThreads));
 #endif
 		addOption(parser, CommandLineOption("mf", "merge-features","merge overlapping features into a cluster and report the spanning region", OptionType::Boolean));
 		addHelpLine(parser, "Supported for TFO and TTS detection only. Merge is performed before duplicate detection.");
@@ -132,10 +148,16 @@ namespace SEQAN_NAMESPACE_MAIN
 		addHelpLine(parser, "Only works when duplicate cutoff is set to greater than 0.");
 		addOption(parser, addArgumentText(CommandLineOption("o", "output",	"output filename (default standard out)", OptionType::String), "FILE"));
 		addOption(parser, addArgumentText(CommandLineOption("od", "output-directory", 	"output will be written to this location", OptionType::String), "FILEDIR"));
+		addOption(parser, addArgumentText(CommandLineOption("inc", "incremental",	"search only TFO sequences that are new or changed since the previous run, per-TFO results are kept in this directory", OptionType::String), "<DIR>"));
+#ifndef PLATFORM_WINDOWS
+		addOption(parser, CommandLineOption("cp", "checkpoint",		"record finished duplex sequences in a journal next to the output file (triplex search only)", OptionType::Boolean));
+		addOption(parser, CommandLineOption("rs", "resume",			"continue an interrupted run from its journal, skipping finished duplex sequences (implies -cp)", OptionType::Boolean));
+#endif
 		addOption(parser, CommandLineOption("of", "output-format",     "set output format", OptionType::Int | OptionType::Label, options.outputFormat));
 		addHelpLine(parser, "0 = Tab-separated");
 		addHelpLine(parser, "1 = Triplexator format (contains sequence/alignment)");
 		addHelpLine(parser, "2 = Summary only");
+		addHelpLine(parser, "3 = Binary (triplex search only, convert with triplexator-view)");
 		addOption(parser, CommandLineOption("po", "pretty-output",		"indicate matching/mismatching characters with upper/lower case", OptionType::Boolean));
 		addOption(parser, CommandLineOption("er", "error-reference",	"reference to which the error should correspond", OptionType::Int | OptionType::Label, options.errorReference));
 		addHelpLine(parser, "0 = the Watson strand of the target");
@@ -148,9 +170,11 @@ namespace SEQAN_NAMESPACE_MAIN
 		addHelpLine(parser, "0 = Serial               process in serial (most memory efficient)");
 		addHelpLine(parser, "1 = Parallelize TTSs     process targets per duplex in parallel (for long duplex sequences)");	
 		addHelpLine(parser, "2 = Parallelize duplex   process duplexes in parallel (for short duplex sequences)");
+		addHelpLine(parser, "4 = Tasks                process duplexes, strands and batches of TTSs as tasks (for mixed duplex sequences)");
 		addHelpLine(parser, "Note: potential runtime speedup is at the cost of higher memory usage. ");
 		addHelpLine(parser, "Option 2 is prone to consume lots of memory especially with heaps of duplex sequence.");
 		addOption(parser, CommandLineOption("p", "processors",			"number of processors used in parallel mode. -1 = detect automatically.", OptionType::Int | OptionType::Label, options.processors));
+		addOption(parser, CommandLineOption("numa", "numa-replicas",	"pin threads to NUMA nodes and search a copy of the TFO index local to each node (runtime mode 2)", OptionType::Boolean));
 #endif
 		requiredArguments(parser, 0);
 	}
@@ -209,6 +233,9 @@ namespace SEQAN_NAMESPACE_MAIN
 		if (isSetLong(parser, "maximum-repeat-period")){
 			getOptionValueLong(parser, "maximum-repeat-period", options.maxRepeatPeriod);
 		}
+		if (isSetLong(parser, "repeat-tile-size")){
+			getOptionValueLong(parser, "repeat-tile-size", options.repeatTileSize);
+		}
 		
 		getOptionValueLong(parser, "output", options.output);
 		getOptionValueLong(parser, "output-directory", options.outputFolder);
@@ -238,6 +265,7 @@ namespace SEQAN_NAMESPACE_MAIN
 			options.processors = omp_get_max_threads();
 		}
 		getOptionValueLong(parser, "runtime-mode", options.runtimeMode);
+		if (isSetLong(parser, "numa-replicas")) options.numaReplicas = true;
 		if (options.processors == 1){
             options.runtimeMode = RUN_SERIAL;
         } else if(options.runtimeMode == RUN_SERIAL){
@@ -254,6 +282,10 @@ namespace SEQAN_NAMESPACE_MAIN
 		getOptionValueLong(parser, "filtering-mode", options.filterMode);
 		getOptionValueLong(parser, "error-reference", options.errorReference);
 		getOptionValueLong(parser, "qgram-threshold", options.qgramThreshold);
+		if (isSetLong(parser, "clip-hits")) options.clipHits = true;
+		getOptionValueLong(parser, "index-shard-size", options.indexShardSize);
+		getOptionValueLong(parser, "minimizer-window", options.minimizerWindow);
+		if (isSetLong(parser, "swift-filter")) options.swiftFilter = true;
 		
 		if (isSetLong(parser, "help") || isSetLong(parser, "version")) return 0;	// print help or version and exit
 		if (isSetLong(parser, "verbose")) options._debugLevel = max(options._debugLevel, 1);
@@ -272,6 +304,22 @@ namespace SEQAN_NAMESPACE_MAIN
 			options.ttsFileSupplied = true;
 		}
 		
+		getOptionValueLong(parser, "off-target-cap", options.offTargetCap);
+		getOptionValueLong(parser, "top-k", options.topK);
+		getOptionValueLong(parser, "region-file", tmpVal);
+		if (tmpVal.length()>0)
+			options.regionFileName = tmpVal;
+		getOptionValueLong(parser, "incremental", tmpVal);
+		if (tmpVal.length()>0)
+			options.partitionDir = tmpVal;
+#ifndef PLATFORM_WINDOWS
+		getOptionValueLong(parser, "server", tmpVal);
+		if (tmpVal.length()>0)
+			options.serverSocket = tmpVal;
+		if (isSetLong(parser, "resume")) options.resume = true;
+		if (isSetLong(parser, "checkpoint") || options.resume) options.checkpoint = true;
+#endif
+		
 		//	getOptionValueLong(parser, "duplex-file", tmpVal);
 		//	unsigned int beg = 0;
 		//	for(unsigned int i = 0; i<tmpVal.length(); ++i) {
@@ -294,9 +342,22 @@ namespace SEQAN_NAMESPACE_MAIN
 			options.runmode=TRIPLEX_TFO_SEARCH;
 		else
 			options.runmode = 0;
+		// the server receives the TFOs from its clients
+		if (!empty(options.serverSocket) && options.ttsFileSupplied && !options.tfoFileSupplied)
+			options.runmode=TRIPLEX_TRIPLEX_SEARCH;
 		
 #ifdef BOOST
 		getOptionValueLong(parser, "zip", options.compressOutput);
+#endif
+#if SEQAN_HAS_ZLIB
+		getOptionValueLong(parser, "bgzf", options.bgzfThreads);
+		if (options.bgzfThreads < 0){
+#if SEQAN_ENABLE_PARALLELISM
+			options.bgzfThreads = omp_get_max_threads();
+#else
+			options.bgzfThreads = 1;
+#endif
+		}
 #endif
 		if (isSetLong(parser, "duplicate-cutoff")){
 			getOptionValueLong(parser, "duplicate-cutoff", options.duplicatesCutoff);
@@ -390,9 +451,11 @@ namespace SEQAN_NAMESPACE_MAIN
 			::std::cerr << "Maximum triplex length needs to be smaller or equal than 1000. " << options.maxLength << ::std::endl;
 		if ((options.maxInterruptions > 3) && (stop = true))
 			::std::cerr << "Maximum consecutive interruptions needs to be smaller or equal than 3." << options.maxInterruptions << ::std::endl;
-		if ((options.outputFormat > 2) && (stop = true))
+		if ((options.outputFormat > 3) && (stop = true))
 			::std::cerr << "Invalid output format option." << ::std::endl;
-		if (! (options.runtimeMode==RUN_SERIAL || options.runtimeMode==RUN_PARALLEL_DUPLEX || options.runtimeMode==RUN_PARALLEL_TRIPLEX || options.runtimeMode==RUN_PARALLEL_STRANDS) && (stop = true))
+		if ((options.outputFormat == FORMAT_BINARY && options.runmode != TRIPLEX_TRIPLEX_SEARCH) && (stop = true))
+			::std::cerr << "Binary output format is only supported for triplex search." << ::std::endl;
+		if (! (options.runtimeMode==RUN_SERIAL || options.runtimeMode==RUN_PARALLEL_DUPLEX || options.runtimeMode==RUN_PARALLEL_TRIPLEX || options.runtimeMode==RUN_PARALLEL_STRANDS || options.runtimeMode==RUN_PARALLEL_TASKS) && (stop = true))
 			::std::cerr << "Runtime mode not known" << ::std::endl;
 		if (options.duplicatesCutoff >= 0 && options.detectDuplicates == DETECT_DUPLICATES_OFF && (stop = true))
 			::std::cerr << "Duplicate filtering with specified cutoff requires duplicate detection mode to be enabled" << ::std::endl;
@@ -406,6 +469,82 @@ namespace SEQAN_NAMESPACE_MAIN
 			::std::cerr << "Note: reference defaulted to Watson strand for TTS search" << ::std::endl;
 		if (options.qgramThreshold <= 0 && (stop = true))
 			::std::cerr << "qgram theshhold needs to be positive, otherwise filtering is void" << ::std::endl;
+		if (options.clipHits && (options.filterMode != FILTERING_GRAMS || options.runmode != TRIPLEX_TRIPLEX_SEARCH) && (stop = true))
+			::std::cerr << "Clipping hits requires a triplex search with q-gram filtering (-fm 1)" << ::std::endl;
+		if (options.indexShardSize > 0 && (options.filterMode != FILTERING_GRAMS || options.runmode != TRIPLEX_TRIPLEX_SEARCH) && (stop = true))
+			::std::cerr << "A sharded index requires a triplex search with q-gram filtering (-fm 1)" << ::std::endl;
+		if (options.minimizerWindow == 0 && (stop = true))
+			::std::cerr << "The minimizer window needs to be positive" << ::std::endl;
+		if (options.minimizerWindow > 1 && (options.filterMode != FILTERING_GRAMS || options.runmode != TRIPLEX_TRIPLEX_SEARCH) && (stop = true))
+			::std::cerr << "Sampling q-grams with a minimizer window requires a triplex search with q-gram filtering (-fm 1)" << ::std::endl;
+		if (options.swiftFilter && (options.filterMode != FILTERING_GRAMS || options.runmode != TRIPLEX_TRIPLEX_SEARCH) && (stop = true))
+			::std::cerr << "The SWIFT filter requires a triplex search with q-gram filtering (-fm 1)" << ::std::endl;
+		if (!empty(options.regionFileName) && options.runmode != TRIPLEX_TRIPLEX_SEARCH && (stop = true))
+			::std::cerr << "A region file can only be used for the triplex search (requires -ss and -ds)" << ::std::endl;
+		if (options.offTargetCap > 0 && options.runmode != TRIPLEX_TRIPLEX_SEARCH && (stop = true))
+			::std::cerr << "The off-target scan requires a triplex search (-ss and -ds)" << ::std::endl;
+		if (options.offTargetCap > 0 && !empty(options.regionFileName) && (stop = true))
+			::std::cerr << "The off-target scan can not be restricted to regions" << ::std::endl;
+		if (options.offTargetCap > 0 && options.indexShardSize > 0 && (stop = true))
+			::std::cerr << "The off-target scan maintains its own index, which can not be sharded" << ::std::endl;
+		if (options.offTargetCap > 0 && options.minimizerWindow > 1 && (stop = true))
+			::std::cerr << "The off-target scan looks up all q-grams, choose a minimizer window of 1" << ::std::endl;
+		if (options.offTargetCap > 0 && options.swiftFilter && (stop = true))
+			::std::cerr << "The off-target scan can not be combined with the SWIFT filter" << ::std::endl;
+		if (options.offTargetCap > 0 && options.outputFormat != FORMAT_BED && (stop = true))
+			::std::cerr << "The off-target scan writes a table of counts and requires output format 0" << ::std::endl;
+		if (options.topK > 0 && options.runmode != TRIPLEX_TRIPLEX_SEARCH && (stop = true))
+			::std::cerr << "Reporting the best triplexes requires a triplex search (-ss and -ds)" << ::std::endl;
+		if (options.topK > 0 && options.outputFormat > FORMAT_TRIPLEX && (stop = true))
+			::std::cerr << "Reporting the best triplexes requires output format 0 or 1" << ::std::endl;
+		if (options.topK > 0 && options.offTargetCap > 0 && (stop = true))
+			::std::cerr << "Reporting the best triplexes can not be combined with the off-target scan" << ::std::endl;
+		if (!empty(options.serverSocket) && (!options.ttsFileSupplied || options.tfoFileSupplied) && (stop = true))
+			::std::cerr << "The server requires a duplex file (-ds), the TFO sequences are sent by its clients" << ::std::endl;
+		if (!empty(options.serverSocket) && options.outputFormat > FORMAT_TRIPLEX && (stop = true))
+			::std::cerr << "The server supports output format 0 and 1" << ::std::endl;
+		if (!empty(options.serverSocket) && (!empty(options.regionFileName) || options.offTargetCap > 0) && (stop = true))
+			::std::cerr << "The server can not be combined with a region file or the off-target scan" << ::std::endl;
+		if (!empty(options.serverSocket) && options.swiftFilter && (stop = true))
+			::std::cerr << "The server searches its catalog of TTSs and can not be combined with the SWIFT filter" << ::std::endl;
+#ifndef PLATFORM_WINDOWS
+		if (!empty(options.serverSocket) && isServerPathTaken(toCString(options.serverSocket)) && (stop = true))
+			::std::cerr << "Socket path " << options.serverSocket << " exists and is not a socket, refusing to replace it" << ::std::endl;
+#endif
+		if (options.checkpoint && (options.runmode != TRIPLEX_TRIPLEX_SEARCH || empty(options.output) || options.outputFormat == FORMAT_SUMMARY) && (stop = true))
+			::std::cerr << "Checkpointing requires a triplex search (-ss and -ds) written to an output file (-o) in format 0, 1 or 3" << ::std::endl;
+		if (options.checkpoint && (!empty(options.regionFileName) || !empty(options.serverSocket) || options.offTargetCap > 0 || options.topK > 0) && (stop = true))
+			::std::cerr << "Checkpointing can not be combined with a region file, the server, the off-target scan or the best triplexes" << ::std::endl;
+		if (!empty(options.partitionDir) && (options.runmode != TRIPLEX_TRIPLEX_SEARCH || options.outputFormat > FORMAT_SUMMARY) && (stop = true))
+			::std::cerr << "The incremental search requires a triplex search (-ss and -ds) with output format 0, 1 or 2" << ::std::endl;
+		if (!empty(options.partitionDir) && (!empty(options.serverSocket) || options.offTargetCap > 0 || options.topK > 0 || options.checkpoint) && (stop = true))
+			::std::cerr << "The incremental search can not be combined with the server, the off-target scan, the best triplexes or checkpointing" << ::std::endl;
+		if (!empty(options.partitionDir) && options.detectDuplicates != DETECT_DUPLICATES_OFF && (stop = true))
+			::std::cerr << "The incremental search can not detect duplicates, duplicates are counted across all TFO sequences" << ::std::endl;
+#if SEQAN_HAS_ZLIB
+		if (options.checkpoint && options.bgzfThreads > 0 && (stop = true))
+			::std::cerr << "Checkpointing requires uncompressed output" << ::std::endl;
+		if (!empty(options.partitionDir) && options.bgzfThreads > 0 && (stop = true))
+			::std::cerr << "The incremental search requires uncompressed output" << ::std::endl;
+#endif
+#ifdef BOOST
+		if (options.checkpoint && options.compressOutput && (stop = true))
+			::std::cerr << "Checkpointing requires uncompressed output" << ::std::endl;
+		if (!empty(options.partitionDir) && options.compressOutput && (stop = true))
+			::std::cerr << "The incremental search requires uncompressed output" << ::std::endl;
+#if SEQAN_HAS_ZLIB
+		if (options.compressOutput && options.bgzfThreads > 0 && (stop = true))
+			::std::cerr << "Choose either gzip (-z) or BGZF (-bz) compression of the output" << ::std::endl;
+#endif
+#endif
+#if SEQAN_ENABLE_PARALLELISM
+		if (options.offTargetCap > 0 && options.runtimeMode == RUN_PARALLEL_DUPLEX && (stop = true))
+			::std::cerr << "The off-target scan processes duplex sequences one after another, choose runtime mode 0, 1 or 3" << ::std::endl;
+		if (options.numaReplicas && options.processors > 1 && options.runtimeMode != RUN_PARALLEL_DUPLEX && (stop = true))
+			::std::cerr << "NUMA replicas are supported for runtime mode 2 only" << ::std::endl;
+		if (options.numaReplicas && (options.runmode != TRIPLEX_TRIPLEX_SEARCH || !empty(options.regionFileName) || !empty(options.serverSocket)) && (stop = true))
+			::std::cerr << "NUMA replicas require a triplex search (-ss and -ds) without a region file or server" << ::std::endl;
+#endif
 		
 		options.errorRate = options.errorRate / 100.0;
 		options.minGuanineRate = options.minGuanineRate / 100.0;
@@ -433,11 +572,16 @@ namespace SEQAN_NAMESPACE_MAIN
 				::std::cerr << "Error-rate, minimum length and qgram-threshold settings do not allow for efficient filtering with q-grams of weight >= 5 (currently " << qgram << ")." << ::std::endl;
 				::std::cerr << "Consider disabling filtering-mode (brute-force approach)" << ::std::endl;
 			}
+			if (options.minimizerWindow > 1 && _sampledSeedsThreshold(options) < 1 && (stop = true))
+				::std::cerr << "Minimizer window " << options.minimizerWindow << " too large to guarantee a q-gram hit per triplex given minimum length, error-rate and q-gram weight " << qgram << ::std::endl;
 		}
 		if ((options.minBlockRun > options.minLength - 2*options.tolError) && (stop = true)) {
 			::std::cerr << "Block match too large given minimum length constraint and error rate." << ::std::endl;
 		} 
 		
+		// the summary output only requires the triplex potentials, not the individual matches
+		options.potentialOnly = ((options.outputFormat == FORMAT_SUMMARY || options.offTargetCap > 0) && options.runmode == TRIPLEX_TRIPLEX_SEARCH);
+		
 		if (stop)
 		{
 			::std::cerr << "Exiting ..." << ::std::endl;
@@ -468,6 +612,10 @@ namespace SEQAN_NAMESPACE_MAIN
 		options.logFileHandle << "*** INPUT:" << ::std::endl;
 		options.logFileHandle << "- single-stranded file supplied : " << (options.tfoFileSupplied?"Yes":"No") << ::std::endl;
 		options.logFileHandle << "- duplex file supplied : " << (options.ttsFileSupplied?"Yes":"No") << ::std::endl;
+		if (!empty(options.regionFileName))
+			options.logFileHandle << "- region file : " << options.regionFileName << ::std::endl;
+		if (!empty(options.serverSocket))
+			options.logFileHandle << "- server socket : " << options.serverSocket << ::std::endl;
 		options.logFileHandle << "-> ";
 		switch (options.runmode) {
 			case TRIPLEX_TTS_SEARCH:
@@ -497,14 +645,26 @@ namespace SEQAN_NAMESPACE_MAIN
 			case FORMAT_SUMMARY:
 				options.logFileHandle << FORMAT_SUMMARY << " = Summary (tsv)" << ::std::endl;
 				break;
+			case FORMAT_BINARY:
+				options.logFileHandle << FORMAT_BINARY << " = Binary" << ::std::endl;
+				break;
 			default:
 				break;
 		}
 		options.logFileHandle << "- merge features : " << (options.runmode == TRIPLEX_TRIPLEX_SEARCH || options.mergeFeatures?"Yes":"No") << ::std::endl;
 		options.logFileHandle << "- report duplicate locations : " << (options.reportDuplicateLocations?"Yes":"No") << ::std::endl;
+	#if SEQAN_HAS_ZLIB
+		options.logFileHandle << "- compress output (BGZF) : " << (options.bgzfThreads > 0?"Yes":"No") << ::std::endl;
+		if (options.bgzfThreads > 0)
+			options.logFileHandle << "- compression threads : " << options.bgzfThreads << ::std::endl;
+	#endif
 	#ifdef BOOST
 		options.logFileHandle << "- compress output : " << (options.compressOutput?"Yes":"No") << ::std::endl;
 	#endif	
+		if (!empty(options.partitionDir))
+			options.logFileHandle << "- incremental search, partitions : " << options.partitionDir << ::std::endl;
+		if (options.checkpoint)
+			options.logFileHandle << "- checkpoint journal : " << (options.resume?"resume previous run":"Yes") << ::std::endl;
 		options.logFileHandle << "- error reference : " ;
 		switch (options.errorReference) {
 			case WATSON_STAND:
@@ -558,6 +718,8 @@ namespace SEQAN_NAMESPACE_MAIN
 			options.logFileHandle << "- longest match only : yes" << ::std::endl;
 		else 
 			options.logFileHandle << "- longest match only : no ( report all matches )" << ::std::endl;
+		if (options.topK > 0)
+			options.logFileHandle << "- best triplexes per TFO sequence : " << options.topK << ::std::endl;
 		
 		options.logFileHandle << "- detect duplicates : ";
 		switch (options.detectDuplicates) {
@@ -583,6 +745,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		if (options.filterRepeats){
 			options.logFileHandle << "- minimum repeat length : " << options.minRepeatLength << ::std::endl;
 			options.logFileHandle << "- maximum repeat period : " << options.maxRepeatPeriod << ::std::endl;
+			if (options.repeatTileSize > 0)
+				options.logFileHandle << "- repeat tile size : " << options.repeatTileSize << ::std::endl;
 		}
 		options.logFileHandle << "- duplicate cutoff : " << options.duplicatesCutoff << ::std::endl;
 		if (options.runmode == TRIPLEX_TRIPLEX_SEARCH){
@@ -592,6 +756,16 @@ namespace SEQAN_NAMESPACE_MAIN
 				options.logFileHandle << "- min. threshold specified: " << options.qgramThreshold << ::std::endl;
 				int minSeedsThreshold = static_cast<int>(options.minLength+1-(min(static_cast<int>(ceil(options.errorRate*options.minLength)), options.maximalError)+1)*length(options.shape));
 				options.logFileHandle << "- min. threshold actual: " << minSeedsThreshold << ::std::endl;			
+				if (options.clipHits)
+					options.logFileHandle << "- clip hits : on" << ::std::endl;
+				if (options.indexShardSize > 0)
+					options.logFileHandle << "- index shard size : " << options.indexShardSize << " nucleotides" << ::std::endl;
+				if (options.minimizerWindow > 1){
+					options.logFileHandle << "- minimizer window : " << options.minimizerWindow << ::std::endl;
+					options.logFileHandle << "- min. threshold sampled: " << _sampledSeedsThreshold(options) << ::std::endl;
+				}
+				if (options.swiftFilter)
+					options.logFileHandle << "- SWIFT filter : on" << ::std::endl;
 			} else {
 				options.logFileHandle << "- filtering : none - brute force" << ::std::endl;
 			}
@@ -620,6 +794,11 @@ namespace SEQAN_NAMESPACE_MAIN
 				break;
 			case RUN_PARALLEL_DUPLEX:
 				options.logFileHandle << RUN_PARALLEL_DUPLEX << " = parallel (duplex sequences) - " << options.processors << " processors" << ::std::endl;
+				if (options.numaReplicas)
+					options.logFileHandle << "- NUMA replicas : Yes" << ::std::endl;
+				break;
+			case RUN_PARALLEL_TASKS:
+				options.logFileHandle << RUN_PARALLEL_TASKS << " = parallel (tasks) - " << options.processors << " processors" << ::std::endl;
 				break;
 	#endif
 			default:
@@ -629,6 +808,38 @@ namespace SEQAN_NAMESPACE_MAIN
 		options.logFileHandle << "*** Log messages:" << ::std::endl;
 	}
 
+	//////////////////////////////////////////////////////////////////////////////
+	// Search the duplex file with the given TFO pattern in the requested runtime mode
+	template <
+	typename TMotifSet,
+	typename TFile,
+	typename TPattern,
+	typename TId,
+	typename TTag>
+	int _startTriplexSearch(TMotifSet						&tfoMotifSet,
+							StringSet<CharString> const		&tfoNames,
+							TPattern const					&pattern,
+							TFile							&outputfile,
+							TId								duplexSeqNo,
+							TRegionMap const				&regions,
+							Options							&options,
+							TTag)
+	{
+		bool searchRegions = !empty(options.regionFileName);
+	#if SEQAN_ENABLE_PARALLELISM	
+		// run in parallel if requested, regions are processed in parallel by the region search itself
+		if ((options.runtimeMode==RUN_PARALLEL_DUPLEX || options.runtimeMode==RUN_PARALLEL_TASKS) && !searchRegions){
+			if (options.runtimeMode==RUN_PARALLEL_TASKS)
+				return startTriplexSearchTasks(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, TTag());
+			return startTriplexSearchParallelDuplex(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, TTag());
+		}
+	#endif
+		// otherwise go for serial processing
+		if (searchRegions)
+			return startTriplexSearchRegions(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, regions, options, TTag());
+		return startTriplexSearchSerial(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, TTag());
+	}
+	
 	//////////////////////////////////////////////////////////////////////////////
 	// Find triplexes in many duplex sequences (import from Fasta)
 	template <
@@ -643,9 +854,11 @@ namespace SEQAN_NAMESPACE_MAIN
 	{
 		typedef Index<TMotifSet, IndexQGram<TShape, OpenAddressing> >				TQGramIndex;
 		typedef Pattern<TQGramIndex, QGramsLookup< TShape, Standard_QGramsLookup > > TPattern;
+		typedef QGramShards<TMotifSet, TShape>										TShards;
 		
 		typedef __int64															TId;
-		typedef Gardener<TId, GardenerUngapped>									TGardener;
+		typedef Gardener<TId, GardenerUngappedSimd>								TGardener;
+		typedef Gardener<TId, GardenerSwift>									TSwiftGardener;
 		
 		unsigned errorCode = TRIPLEX_NORMAL_PROGAM_EXIT;
 		
@@ -653,55 +866,68 @@ namespace SEQAN_NAMESPACE_MAIN
 		options.logFileHandle << _getTimeStamp() << " * Started searching for triplexes" << ::std::endl;
 		
 		TId duplexSeqNo = 0;
+		
+		// restrict the search to the regions of a BED file if requested
+		bool searchRegions = !empty(options.regionFileName);
+		TRegionMap regions;
+		if (searchRegions){
+			if (!readBedRegions(regions, toCString(options.regionFileName))){
+				options.logFileHandle << _getTimeStamp() << " * Could not read region file " << options.regionFileName << ::std::endl;
+				return TRIPLEX_READFILE_FAILED;
+			}
+			options.logFileHandle << _getTimeStamp() << " * Restricting the search to regions on " << regions.size() << " sequences given in " << options.regionFileName << ::std::endl;
+		}
+		
 		// open duplex file
 		options.logFileHandle << _getTimeStamp() << " * Processing " << options.duplexFileNames[0] << ::std::endl;
-	#if SEQAN_ENABLE_PARALLELISM	
-		// run in parallel if requested
-		if (options.runtimeMode==RUN_PARALLEL_DUPLEX){
-			if (options.filterMode == FILTERING_GRAMS){
-				// create index
-				if (options._debugLevel >= 1)
-					options.logFileHandle << _getTimeStamp() <<  " - Started creating q-gram index for all TFOs" << ::std::endl;
-				TQGramIndex index_qgram(tfoMotifSet);
-				resize(indexShape(index_qgram), weight(shape));
-				// create pattern	
-				TPattern pattern(index_qgram,shape);
-				options.timeFindTriplexes = 0;
-				// create index
-				if (options._debugLevel >= 1)
-					options.logFileHandle << _getTimeStamp() <<  " - Finised creating q-gram index for all TFOs" << ::std::endl;
-				
-				errorCode = startTriplexSearchParallelDuplex(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, TGardener());
-			} else {
-                TQGramIndex pattern;
-				errorCode = startTriplexSearchParallelDuplex(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, BruteForce());
-			}
+		if (options.offTargetCap > 0){
+			// count off-targets per TFO sequence, maintains its own q-gram index of the TFOs not capped yet
+			options.logFileHandle << _getTimeStamp() << " * Scanning for off-targets, capped at " << options.offTargetCap << " per TFO sequence" << ::std::endl;
+			if (options.filterMode == FILTERING_GRAMS)
+				errorCode = startOffTargetScan(tfoMotifSet, tfoNames, outputfile, options, shape, TGardener());
+			else
+				errorCode = startOffTargetScan(tfoMotifSet, tfoNames, outputfile, options, shape, BruteForce());
+		} else if (options.filterMode == FILTERING_GRAMS && options.indexShardSize > 0){
+			// create one index per shard of the TFOs
+			if (options._debugLevel >= 1)
+				options.logFileHandle << _getTimeStamp() <<  " - Started creating sharded q-gram index for all TFOs" << ::std::endl;
+			TShards shards;
+			createQGramShards(shards, tfoMotifSet, shape, options.indexShardSize, options.processors);
+			setMinimizerWindow(shards, options.minimizerWindow);
+			options.timeFindTriplexes = 0;
+			if (options._debugLevel >= 1)
+				options.logFileHandle << _getTimeStamp() <<  " - Finished creating q-gram index for all TFOs in " << numShards(shards) << " shards" << ::std::endl;
+			
+			if (options.swiftFilter)
+				errorCode = _startTriplexSearch(tfoMotifSet, tfoNames, shards, outputfile, duplexSeqNo, regions, options, TSwiftGardener());
+			else
+				errorCode = _startTriplexSearch(tfoMotifSet, tfoNames, shards, outputfile, duplexSeqNo, regions, options, TGardener());
+		} else if (options.filterMode == FILTERING_GRAMS){
+			// create index
+			if (options._debugLevel >= 1)
+				options.logFileHandle << _getTimeStamp() <<  " - Started creating q-gram index for all TFOs" << ::std::endl;
+			TQGramIndex index_qgram(tfoMotifSet);
+			resize(indexShape(index_qgram), weight(shape));
+			// create pattern	
+			TPattern pattern(index_qgram, shape, options.minimizerWindow);
+			options.timeFindTriplexes = 0;
+			// create index
+			if (options._debugLevel >= 1)
+				options.logFileHandle << _getTimeStamp() <<  " - Finised creating q-gram index for all TFOs" << ::std::endl;
+			
+			if (options.swiftFilter)
+				errorCode = _startTriplexSearch(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, regions, options, TSwiftGardener());
+			else
+				errorCode = _startTriplexSearch(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, regions, options, TGardener());
 		} else {
-		// otherwise go for serial processing
-	#endif	
-			if (options.filterMode == FILTERING_GRAMS){
-				// create index
-				if (options._debugLevel >= 1)
-					options.logFileHandle << _getTimeStamp() <<  " - Started creating q-gram index for all TFOs" << ::std::endl;
-				TQGramIndex index_qgram(tfoMotifSet);
-				resize(indexShape(index_qgram), weight(shape));
-				// create pattern	
-				TPattern pattern(index_qgram,shape);
-				options.timeFindTriplexes = 0;
-				// create index
-				if (options._debugLevel >= 1)
-					options.logFileHandle << _getTimeStamp() <<  " - Finised creating q-gram index for all TFOs" << ::std::endl;
-				
-				errorCode = startTriplexSearchSerial(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, TGardener());
-			} else {
-                TQGramIndex pattern;
-				errorCode = startTriplexSearchSerial(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, options, BruteForce());
-			}	
-	#if SEQAN_ENABLE_PARALLELISM	
+			TQGramIndex pattern;
+			errorCode = _startTriplexSearch(tfoMotifSet, tfoNames, pattern, outputfile, duplexSeqNo, regions, options, BruteForce());
 		}
-	#endif
 		
 		if (errorCode == TRIPLEX_NORMAL_PROGAM_EXIT){
+			// the best triplexes per TFO sequence are known once all duplex sequences are processed
+			if (options.topK > 0)
+				printTopMatches(outputfile, options.topMatches);
 			options.logFileHandle << _getTimeStamp() << " * Finished processing " << options.duplexFileNames[0] << ::std::endl; 
 			options.timeFindTriplexes += SEQAN_PROTIMEDIFF(find_time);	
 			options.logFileHandle << _getTimeStamp() << " * Finished searching for triplexes  within " << ::std::setprecision(3) << options.timeFindTriplexes << " seconds (summed over all cpus)" << ::std::endl;
@@ -709,21 +935,179 @@ namespace SEQAN_NAMESPACE_MAIN
 		return errorCode;
 	}
 
+	//////////////////////////////////////////////////////////////////////////////
+	// detect the TFO motifs in all single-stranded sequences and handle duplicates
+	template <typename TMotifSet, typename TOligoSet>
+	void _detectTfoMotifs(TMotifSet	&tfoMotifSet,
+						  TOligoSet	&oligoSequences,
+						  Options	&options)
+	{
+		typedef Repeat<unsigned, unsigned>						TRepeat;
+		typedef String<TRepeat>									TRepeatString;
+		
+		bool reduceSet = true; // merge overlapping features
+		
+		// the oligo sequences are processed in parallel, each into its own motif set
+		::std::vector<TMotifSet> tmpTfoSets;
+		resize(tmpTfoSets, length(oligoSequences));
+		
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) num_threads(options.processors))
+		for (int oligoSeqNo=0; oligoSeqNo<(int)length(oligoSequences); ++oligoSeqNo){
+			
+			// find low complexity regions and mask sequences if requested
+			if (options.filterRepeats){
+				TRepeatString data_repeats;
+				_filterLowComplexityRegions(value(oligoSequences, oligoSeqNo), data_repeats, options);
+			}
+			
+			// process TC motif
+			if (options.motifTC) {
+				processTCMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, reduceSet, options);
+			}
+			// process GA motif
+			if (options.motifGA) {
+				processGAMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, reduceSet, options);
+			}
+			// process GT motif
+			if (options.motifGT_p && options.motifGT_a) {
+				processGTMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, TRIPLEX_ORIENTATION_BOTH, reduceSet, options);
+			} else if (options.motifGT_p){
+				processGTMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, TRIPLEX_ORIENTATION_PARALLEL, reduceSet, options);
+			} else if (options.motifGT_a){
+				processGTMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, TRIPLEX_ORIENTATION_ANTIPARALLEL, reduceSet, options);
+			}
+		}
+		
+		// accumulate the motifs in the order of the oligo sequences
+		_appendMotifSets(tfoMotifSet, tmpTfoSets);
+		
+		// any business with duplicates?
+		if (options.detectDuplicates != DETECT_DUPLICATES_OFF){
+
+			// detect duplicates if requested
+			if (options.detectDuplicates == DETECT_DUPLICATES_STRICT)
+				_countDuplicatesStrict(tfoMotifSet, options, TFO() );
+			else
+				_countDuplicatesPermissive(tfoMotifSet, options, TFO() );
+			
+			if (options.duplicatesCutoff >= 0){
+				unsigned removed = _filterDuplicatesWithCutoff(tfoMotifSet, options);
+				options.logFileHandle << _getTimeStamp() << " * Duplicate filtering removed " << ::std::setprecision(3)  << removed << " entries (" << length(tfoMotifSet) << " remain)" << ::std::endl;
+			}
+		}
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	// output the partitions of all TFO sequences in the order of the TFO file
+	template <typename TFile>
+	bool _printTfoPartitions(TFile									&outputfile,
+							 ::std::vector< ::std::string > const	&keys,
+							 Options								&options)
+	{
+		printTriplexHeader(outputfile, options);
+		for (unsigned i=0; i<keys.size(); ++i){
+			if (!copyTfoPartition(outputfile, options.partitions, keys[i], ".tpx") || 
+				!copyTfoPartition(options.summaryFileHandle, options.partitions, keys[i], ".summary")){
+				options.logFileHandle << "ERROR: Missing partition " << keys[i] << " in " << options.partitionDir << ::std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Incremental search: only TFO sequences without a partition of a previous
+	// run (new or changed ones) are searched, the output is assembled from the
+	// partitions of all TFO sequences
+	template <typename TMotifSet, typename TOligoSet>
+	int _mapTriplexesIncrementally(TOligoSet				&oligoSequences,
+								   StringSet<CharString>	&oligoNames,
+								   Options					&options)
+	{
+		typedef ::std::map< ::std::string, ::std::string >	TKeyMap;
+		
+		TfoPartitionTable &partitions = options.partitions;
+		setTfoPartitionDirectory(partitions, toCString(options.partitionDir));
+		::std::ostringstream fingerprint;
+		fingerprint << ::std::hex << _journalHash(_searchParameterText(options));
+		
+		TKeyMap previous;
+		if (!readTfoPartitionManifest(previous, partitions, fingerprint.str()))
+			options.logFileHandle << _getTimeStamp() << " * No partitions of a previous run with the same parameters in " << options.partitionDir << ", searching all TFO sequences" << ::std::endl;
+		
+		// collect the TFO sequences without partition, each one is searched once
+		::std::vector< ::std::string > keys;
+		::std::set< ::std::string > current;
+		TOligoSet changedSequences;
+		StringSet<CharString> changedNames;
+		::std::vector< ::std::string > changedKeys;
+		for (unsigned i=0; i<length(oligoSequences); ++i){
+			keys.push_back(tfoPartitionKey(oligoNames[i], oligoSequences[i]));
+			if (!current.insert(keys[i]).second || previous.find(keys[i]) != previous.end())
+				continue;
+			appendValue(changedSequences, oligoSequences[i]);
+			appendValue(changedNames, oligoNames[i]);
+			changedKeys.push_back(keys[i]);
+		}
+		options.logFileHandle << _getTimeStamp() << " * Incremental search: " << length(changedSequences) << " of " << length(oligoSequences) << " TFO sequences are new or changed" << ::std::endl;
+		
+		if (!empty(changedSequences)){
+			Shape<Triplex, SimpleShape > ungappedShape;
+			if (!stringToShape(ungappedShape, options.shape))
+				return TRIPLEX_SHAPE_FAILED;
+			
+			SEQAN_PROTIMESTART(find_time);
+			TMotifSet tfoMotifSet;
+			_detectTfoMotifs(tfoMotifSet, changedSequences, options);
+			options.timeFindTfos += SEQAN_PROTIMEDIFF(find_time);
+			options.logFileHandle << _getTimeStamp() << " * Finished detecting TFOs within " << ::std::setprecision(3)  << options.timeFindTfos << " seconds (" << length(tfoMotifSet) << " TFOs detected)" << ::std::endl;
+			
+			// the results are stored in the partitions, nothing is written to the output file
+			resetTfoPartitions(partitions, changedKeys);
+			::std::ofstream noOutput;
+			int errorCode = _findTriplex(tfoMotifSet, changedNames, noOutput, options, ungappedShape);
+			if (!flushTfoPartitions(partitions)){
+				options.logFileHandle << "ERROR: Failed to write partitions to " << options.partitionDir << ::std::endl;
+				return TRIPLEX_OUTPUTFILE_FAILED;
+			}
+			if (errorCode != TRIPLEX_NORMAL_PROGAM_EXIT)
+				return errorCode;
+		}
+		
+		if (!writeTfoPartitionManifest(partitions, keys, oligoNames, fingerprint.str())){
+			options.logFileHandle << "ERROR: Failed to write the partition manifest to " << options.partitionDir << ::std::endl;
+			return TRIPLEX_OUTPUTFILE_FAILED;
+		}
+		// drop the partitions of TFO sequences that are gone, only once the new
+		// manifest is in place, such that an interrupted run leaves a usable state
+		for (TKeyMap::const_iterator it = previous.begin(); it != previous.end(); ++it)
+			if (current.find(it->first) == current.end())
+				removeTfoPartition(partitions, it->first);
+		
+		// assemble the output
+		bool ok;
+		if (!empty(options.output) && options.outputFormat!=2){
+			::std::ofstream filehandle;
+			openOutputFile(filehandle, options);
+			ok = _printTfoPartitions(filehandle, keys, options);
+			closeOutputFile(filehandle, options);
+		} else {
+			ok = _printTfoPartitions(::std::cout, keys, options);
+		}
+		return ok ? TRIPLEX_NORMAL_PROGAM_EXIT : TRIPLEX_READFILE_FAILED;
+	}
+	
 	////////////////////////////////////////////////////////////////////////////////
 	//// Main triplex mapper function
 	template <typename TOligoSet, typename TMotifSet>
 	int mapTriplexes(Options &options)
 	{
-		typedef typename Iterator<TOligoSet, Standard>::Type 	TOligoIter;
 		typedef typename Iterator<TMotifSet, Standard>::Type 	TIterMotifSet;
 
 		TOligoSet				oligoSequences;
 		StringSet<CharString>	oligoNames;		// tfo names, taken from the Fasta file
 		StringSet<CharString> 	duplexNames;	// tts names, taken from the Fasta file
 		String< Pair<CharString, unsigned> >  ttsnoToFileMap;
-		typedef Repeat<unsigned, unsigned>						TRepeat;
-		typedef String<TRepeat>									TRepeatString;
-		typedef typename Iterator<TRepeatString, Rooted>::Type	TRepeatIterator;
 		
 		// circumvent numerical obstacles
 	//	options.errorRate += 0.0000001;
@@ -735,8 +1119,8 @@ namespace SEQAN_NAMESPACE_MAIN
 		int filecount = 0;
 		int numTTSFiles = 0;
 		while(filecount < numTTSFiles){
-			::std::ifstream file;
-			file.open(toCString(options.duplexFileNames[filecount]), ::std::ios_base::in | ::std::ios_base::binary);
+			SequenceInputStream file;
+			file.open(toCString(options.duplexFileNames[filecount]), options.processors);
 			if (!file.is_open())
 				return TRIPLEX_READFILE_FAILED;
 			file.close();
@@ -756,6 +1140,12 @@ namespace SEQAN_NAMESPACE_MAIN
 		}
 
 		options.logFileHandle << _getTimeStamp() << " * Finished reading single-stranded file (" << length(oligoSequences) << " sequences read)" << ::std::endl;
+		if (options.topK > 0)
+			resetTopMatches(options.topMatches, length(oligoNames), options.topK);
+		
+		// search only new or changed TFO sequences and reuse the results of a previous run
+		if (!empty(options.partitionDir))
+			return _mapTriplexesIncrementally<TMotifSet>(oligoSequences, oligoNames, options);
 		
 		//////////////////////////////////////////////////////////////////////////////
 		// Step 3:  pre-process all sequences with the requested TFO motifs
@@ -773,56 +1163,8 @@ namespace SEQAN_NAMESPACE_MAIN
 			return TRIPLEX_SHAPE_FAILED;
 		}
 
-		bool reduceSet = true; // merge overlapping features
-		
-		unsigned oligoSeqNo = 0;
 		TMotifSet tfoMotifSet;
-		for (TOligoIter it = begin(oligoSequences); it != end(oligoSequences); ++it){
-			
-			// find low complexity regions and mask sequences if requested
-			if (options.filterRepeats){
-				TRepeatString data_repeats;
-				findRepeats(data_repeats, *it, options.minRepeatLength, options.maxRepeatPeriod);
-				for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-					TRepeat repeat = *rbeg;
-					CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-					replace(*it, repeat.beginPosition, repeat.endPosition, replacement);
-				}
-			}
-			
-			// process TC motif
-			if (options.motifTC) {
-				processTCMotif(tfoMotifSet, *it, oligoSeqNo, reduceSet, options);
-			}
-			// process GA motif
-			if (options.motifGA) {
-				processGAMotif(tfoMotifSet, *it, oligoSeqNo, reduceSet, options);
-			}
-			// process GT motif
-			if (options.motifGT_p && options.motifGT_a) {
-				processGTMotif(tfoMotifSet, *it, oligoSeqNo, TRIPLEX_ORIENTATION_BOTH, reduceSet, options);
-			} else if (options.motifGT_p){
-				processGTMotif(tfoMotifSet, *it, oligoSeqNo, TRIPLEX_ORIENTATION_PARALLEL, reduceSet, options);
-			} else if (options.motifGT_a){
-				processGTMotif(tfoMotifSet, *it, oligoSeqNo, TRIPLEX_ORIENTATION_ANTIPARALLEL, reduceSet, options);
-			}
-			++oligoSeqNo;
-		}
-		
-		// any business with duplicates?
-		if (options.detectDuplicates != DETECT_DUPLICATES_OFF){
-
-			// detect duplicates if requested
-			if (options.detectDuplicates == DETECT_DUPLICATES_STRICT)
-				_countDuplicatesStrict(tfoMotifSet, options, TFO() );
-			else
-				_countDuplicatesPermissive(tfoMotifSet, options, TFO() );
-			
-			if (options.duplicatesCutoff >= 0){
-				unsigned removed = _filterDuplicatesWithCutoff(tfoMotifSet, options);
-				options.logFileHandle << _getTimeStamp() << " * Duplicate filtering removed " << ::std::setprecision(3)  << removed << " entries (" << length(tfoMotifSet) << " remain)" << ::std::endl;
-			}
-		}
+		_detectTfoMotifs(tfoMotifSet, oligoSequences, options);
 		
 		options.timeFindTfos += SEQAN_PROTIMEDIFF(find_time);	
 
@@ -843,6 +1185,16 @@ namespace SEQAN_NAMESPACE_MAIN
 		// 
 	
 		unsigned errorCode = TRIPLEX_NORMAL_PROGAM_EXIT;
+	#if SEQAN_HAS_ZLIB
+		if (options.bgzfThreads != 0){
+			BgzfOutputStream bgzfstream;
+			openOutputFile(bgzfstream, options);
+			printTriplexHeader(bgzfstream, options);
+			printBinaryHeader(bgzfstream, oligoNames, options);
+			errorCode = _findTriplex(tfoMotifSet, oligoNames, bgzfstream, options, ungappedShape);
+			closeOutputFile(bgzfstream, options);
+		} else {
+	#endif
 	#ifdef BOOST
 		if (options.compressOutput){
 			io::filtering_ostream filterstream;
@@ -854,26 +1206,120 @@ namespace SEQAN_NAMESPACE_MAIN
 				filterstream.push(::std::cout);	
 			}
 			printTriplexHeader(filterstream, options);
+			printBinaryHeader(filterstream, oligoNames, options);
 			errorCode = _findTriplex(tfoMotifSet, oligoNames, filterstream, options, ungappedShape);
 			closeOutputFile(filterstream, options);
 		} else {
 	#endif
 			::std::ofstream filehandle;
 			if (!empty(options.output) && options.outputFormat!=2){
+				// continue the files of an interrupted run if requested
+				if (options.checkpoint){
+					setCheckpointFingerprint(tfoMotifSet, options);
+					resumeCheckpoint(options);
+				}
 				openOutputFile(filehandle, options);
-				printTriplexHeader(filehandle, options);
+				if (!options.journal.resumed){
+					printTriplexHeader(filehandle, options);
+					printBinaryHeader(filehandle, oligoNames, options);
+				}
+				if (options.checkpoint && !startCheckpointJournal(filehandle, options)){
+					options.logFileHandle << "ERROR: Failed to write the checkpoint journal " << options.journal.fileName << ::std::endl;
+					return TRIPLEX_OUTPUTFILE_FAILED;
+				}
 				errorCode = _findTriplex(tfoMotifSet, oligoNames, filehandle, options, ungappedShape);
 				closeOutputFile(filehandle, options);
+				// the output is complete, a journal is no longer needed
+				if (options.checkpoint && errorCode == TRIPLEX_NORMAL_PROGAM_EXIT)
+					removeCheckpointJournal(options.journal);
 			} else {
 				printTriplexHeader(::std::cout, options);
+				printBinaryHeader(::std::cout, oligoNames, options);
 				errorCode = _findTriplex(tfoMotifSet, oligoNames, ::std::cout, options, ungappedShape);
 			}
 	#ifdef BOOST
 		}
+	#endif
+	#if SEQAN_HAS_ZLIB
+		}
 	#endif
 		return errorCode;
 	}
 
+#ifndef PLATFORM_WINDOWS
+	////////////////////////////////////////////////////////////////////////////////
+	//// Server mode: keep the putative TTSs in memory and search the TFOs sent by clients
+	template <typename TOligoSet, typename TMotifSet>
+	int serveTriplexes(Options &options)
+	{
+		Shape<Triplex, SimpleShape > ungappedShape;
+		if (!stringToShape(ungappedShape, options.shape)){
+			return TRIPLEX_SHAPE_FAILED;
+		}
+		// a job searches the blocks of the TTS catalog in parallel
+		if (options.runtimeMode != RUN_SERIAL)
+			options.runtimeMode = RUN_PARALLEL_DUPLEX;
+		
+		//////////////////////////////////////////////////////////////////////////////
+		// Step 1: read the duplex file and collect the putative TTSs
+		SEQAN_PROTIMESTART(catalog_time);
+		options.logFileHandle << _getTimeStamp() << " * Started reading duplex file " << options.duplexFileNames[0] << ::std::endl;
+		TtsCatalog catalog;
+		int errorCode = buildTtsCatalog(catalog, options);
+		if (errorCode != TRIPLEX_NORMAL_PROGAM_EXIT)
+			return errorCode;
+		options.logFileHandle << _getTimeStamp() << " * Finished collecting " << catalog.numTts << " putative TTSs in " << catalog.duplexes.size() << " duplex sequences within " << ::std::setprecision(3) << SEQAN_PROTIMEDIFF(catalog_time) << " seconds" << ::std::endl;
+		
+		//////////////////////////////////////////////////////////////////////////////
+		// Step 2: answer jobs until the server is terminated
+		installServerSignalHandlers();
+		int serverSocket = openServerSocket(toCString(options.serverSocket));
+		if (serverSocket < 0){
+			options.logFileHandle << "ERROR: Failed to listen on socket " << options.serverSocket << ::std::endl;
+			cerr << "Failed to listen on socket " << options.serverSocket << endl;
+			return TRIPLEX_OUTPUTFILE_FAILED;
+		}
+		options.logFileHandle << _getTimeStamp() << " * Listening on " << options.serverSocket << ::std::endl;
+		
+		CharString job;
+		for (unsigned jobNo = 1;; ++jobNo){
+			int connection = acceptServerJob(serverSocket);
+			if (connection < 0)
+				break;
+			
+			SEQAN_PROTIMESTART(job_time);
+			TOligoSet oligoSequences;
+			StringSet<CharString> oligoNames;
+			TMotifSet tfoMotifSet;
+			__int64 numMatches = 0;
+			{
+				FdOutputStream outputstream(connection);
+				if (readServerJob(job, connection) && _loadOligosFromText(oligoSequences, oligoNames, job, options)){
+					_detectTfoMotifs(tfoMotifSet, oligoSequences, options);
+					printTriplexMatchHeader(outputstream, options);
+					if (options.topK > 0)
+						resetTopMatches(options.topMatches, length(oligoNames), options.topK);
+					if (options.filterMode == FILTERING_GRAMS)
+						numMatches = searchTtsCatalog(catalog, tfoMotifSet, oligoNames, outputstream, options, ungappedShape, Gardener<__int64, GardenerUngappedSimd>());
+					else
+						numMatches = searchTtsCatalog(catalog, tfoMotifSet, oligoNames, outputstream, options, ungappedShape, BruteForce());
+					if (options.topK > 0)
+						printTopMatches(outputstream, options.topMatches);
+				} else {
+					outputstream << "# ERROR: no single-stranded sequences received" << ::std::endl;
+				}
+				outputstream.flush();
+			}
+			::close(connection);
+			options.logFileHandle << _getTimeStamp() << " * Job " << jobNo << ": " << length(oligoSequences) << " sequences, " << length(tfoMotifSet) << " TFOs, " << numMatches << " triplexes within " << ::std::setprecision(3) << SEQAN_PROTIMEDIFF(job_time) << " seconds" << ::std::endl;
+		}
+		
+		closeServerSocket(serverSocket, toCString(options.serverSocket));
+		options.logFileHandle << _getTimeStamp() << " * Server stopped" << ::std::endl;
+		return TRIPLEX_NORMAL_PROGAM_EXIT;
+	}
+#endif
+
 	template <
 	typename TDuplexName, 
 	typename TInput, 
@@ -892,7 +1338,6 @@ namespace SEQAN_NAMESPACE_MAIN
 	{
 		typedef Repeat<unsigned, unsigned>						TRepeat;
 		typedef String<TRepeat>									TRepeatString;
-		typedef typename Iterator<TRepeatString, Rooted>::Type	TRepeatIterator;
 		typedef ::std::vector<unsigned>							THitList;
 		typedef TriplexPotential<TId>							TPotential;
 		typedef typename ::std::list<TPotential>				TPotentials;
@@ -937,12 +1382,7 @@ namespace SEQAN_NAMESPACE_MAIN
 					options.logFileHandle << _getTimeStamp() << "   ... Started low complexity filtering of duplex sequence" << ::std::endl;
 
 				TRepeatString	data_repeats;
-				findRepeats(data_repeats, duplexString, options.minRepeatLength, options.maxRepeatPeriod);
-				for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-					TRepeat repeat = *rbeg;
-					CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-					replace(duplexString, repeat.beginPosition, repeat.endPosition, replacement);
-				}
+				_filterLowComplexityRegions(duplexString, data_repeats, options);
 				
 				if (options._debugLevel > 1 )
 					options.logFileHandle << _getTimeStamp() << "   ... Finished low complexity filtering of duplex sequence" << ::std::endl;
@@ -1001,7 +1441,6 @@ namespace SEQAN_NAMESPACE_MAIN
 
 		}
 		dumpSummary(potentials, duplexNames, options, TTS());
-		file.close();	
 	}
 	
 
@@ -1023,7 +1462,6 @@ namespace SEQAN_NAMESPACE_MAIN
 	{
 		typedef Repeat<unsigned, unsigned>						TRepeat;
 		typedef String<TRepeat>									TRepeatString;
-		typedef typename Iterator<TRepeatString, Rooted>::Type	TRepeatIterator;
 		typedef typename Iterator<TTriplexSet, Standard>::Type 	TIter;
 		typedef typename Iterator<TTargetSet, Standard>::Type 	TTIter;	
 		typedef TriplexPotential<TId>							TPotential;
@@ -1068,12 +1506,7 @@ namespace SEQAN_NAMESPACE_MAIN
 				// find low complexity regions and mask sequences if requested
 				if (options.filterRepeats){
 					TRepeatString	data_repeats;
-					findRepeats(data_repeats, value(duplexSet, duplexSeqNo), options.minRepeatLength, options.maxRepeatPeriod);
-					for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-						TRepeat repeat = *rbeg;
-						CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-						replace(value(duplexSet, duplexSeqNo), repeat.beginPosition, repeat.endPosition, replacement);
-					}
+					_filterLowComplexityRegions(value(duplexSet, duplexSeqNo), data_repeats, options);
 					if (options._debugLevel > 1 )
 						options.logFileHandle << _getTimeStamp() << "   ... Finished filtering sequence " << duplexSeqNo << " for low complexity regions" << ::std::endl;
 
@@ -1155,8 +1588,6 @@ namespace SEQAN_NAMESPACE_MAIN
 
 		dumpTtsMatches(outputhandle, ttsSet, duplexNames, options);	
 		dumpSummary(potentials, duplexNames, options, TTS());	
-		
-		file.close();	
 	}
 
 	template <
@@ -1202,11 +1633,12 @@ namespace SEQAN_NAMESPACE_MAIN
 		unsigned seqNo = 0;
 		
 		// open duplex file
-		::std::ifstream file;
+		SequenceInputStream input;
 		options.logFileHandle << _getTimeStamp() << " * Processing " << options.duplexFileNames[0] << ::std::endl;
-		file.open(toCString(options.duplexFileNames[0]), ::std::ios_base::in | ::std::ios_base::binary);
-		if (!file.is_open())
+		input.open(toCString(options.duplexFileNames[0]), options.processors);
+		if (!input.is_open())
 			return TRIPLEX_DUPLEXREAD_FAILED;
+		::std::istream &file = input;
 		
 		// remove the directory prefix of current duplex file
 		::std::string ttsFile(toCString(options.duplexFileNames[0]));
@@ -1219,6 +1651,15 @@ namespace SEQAN_NAMESPACE_MAIN
 		SEQAN_PROTIMESTART(find_time);
 		
 		// create output file
+	#if SEQAN_HAS_ZLIB
+		if (options.bgzfThreads != 0){
+			BgzfOutputStream bgzfstream;
+			openOutputFile(bgzfstream, options);
+			printTTSHeader(bgzfstream, options);
+			_investigateTTS(duplexFileName, file, seqNo, ttsnoToFileMap, duplexNames, bgzfstream, options);
+			closeOutputFile(bgzfstream, options);
+		} else {
+	#endif
 	#ifdef BOOST
 		if (options.compressOutput){
 			io::filtering_ostream filterstream;
@@ -1247,6 +1688,10 @@ namespace SEQAN_NAMESPACE_MAIN
 	#ifdef BOOST
 		}
 	#endif
+	#if SEQAN_HAS_ZLIB
+		}
+	#endif
+		input.close();
 				
 		CharString sfName;
 		_getShortFilename(sfName, options.duplexFileNames[0]);
@@ -1260,87 +1705,151 @@ namespace SEQAN_NAMESPACE_MAIN
 	}
 
 	//////////////////////////////////////////////////////////////////////////////
-	// Main TFO mapper function
-	template <typename TOligoSet, typename TMotifSet>
-	int investigateTFO(Options &options
-	){
-		typedef typename Iterator<TOligoSet, Standard>::Type 	TOligoIter;
-		typedef typename Iterator<TMotifSet, Standard>::Type	Titer;
+	// Find TFOs in a set of single-stranded sequences, the sequences are 
+	// processed in parallel and the motifs and potentials are appended in 
+	// the order of the sequences
+	template <typename TMotifSet, typename TPotentials, typename TOligoSet>
+	inline void _detectTfosAndPotentials(TMotifSet		&tfoMotifSet,
+										 TPotentials	&potentials,
+										 TOligoSet		&oligoSequences,
+										 Options		&options)
+	{
 		typedef Repeat<unsigned, unsigned>						TRepeat;
 		typedef String<TRepeat>									TRepeatString;
-		typedef typename Iterator<TRepeatString, Rooted>::Type	TRepeatIterator;
 		typedef TriplexPotential<TId>							TPotential;
-		typedef typename ::std::list<TPotential>				TPotentials;
-		
-		TOligoSet				oligoSequences;
-		StringSet<CharString>	oligoNames;				// tfs names, taken from the Fasta file
-		
-		// circumvent numerical obstacles
-	//	options.errorRate += 0.0000001;
-		
-		//////////////////////////////////////////////////////////////////////////////
-		// Step 1: read in TFO files
-		
-		options.logFileHandle << _getTimeStamp() << " * Started reading single-stranded file:" << options.tfoFileNames[0] << ::std::endl;
-		
-		if (!_loadOligos(oligoSequences, oligoNames, toCString(options.tfoFileNames[0]), options)) {
-			options.logFileHandle << "ERROR: Failed to load single-stranded sequence set" << ::std::endl;
-			cerr << "Failed to load single-stranded sequence set" << endl;
-			return TRIPLEX_TFOREAD_FAILED;
-		}
-		
-		options.logFileHandle << _getTimeStamp() << " * Finished reading single-stranded file (" << length(oligoSequences) << " sequences read)" << ::std::endl;
-		
-		
-		//////////////////////////////////////////////////////////////////////////////
-		// Step 2:  process all sequences with the requested TFO motifs
-		
-		SEQAN_PROTIMESTART(find_time);
-		options.logFileHandle << _getTimeStamp() << " * Started detecting triplex-forming oligonucleotides (TFOs) in single-stranded sequences" << ::std::endl;
-		
-		unsigned oligoSeqNo = 0;
-		TMotifSet tfoMotifSet;
 		
 		bool reduceSet = false || options.mergeFeatures; //merge overlapping features on request
-		TPotentials potentials;
 		
-		for (TOligoIter it = begin(oligoSequences, Standard()); it != end(oligoSequences, Standard()); ++ it){
+		// the oligo sequences are processed in parallel, each into its own motif set
+		::std::vector<TMotifSet> tmpTfoSets;
+		resize(tmpTfoSets, length(oligoSequences));
+		::std::vector<TPotential> tmpPotentials;
+		resize(tmpPotentials, length(oligoSequences));
+		
+		SEQAN_PRAGMA_IF_PARALLEL(omp parallel for schedule(dynamic) num_threads(options.processors))
+		for (int oligoSeqNo=0; oligoSeqNo<(int)length(oligoSequences); ++oligoSeqNo){
 			// find low complexity regions and mask sequences if requested
 			if (options.filterRepeats){
 				TRepeatString	data_repeats;
-				findRepeats(data_repeats, *it, options.minRepeatLength, options.maxRepeatPeriod);
-				for (TRepeatIterator rbeg = begin(data_repeats); rbeg != end(data_repeats); ++rbeg){
-					TRepeat repeat = *rbeg;
-					CharString replacement = string(repeat.endPosition-repeat.beginPosition, 'N' );
-					replace(*it, repeat.beginPosition, repeat.endPosition, replacement);
-				}
+				_filterLowComplexityRegions(value(oligoSequences, oligoSeqNo), data_repeats, options);
 			}
 			
 			TPotential potential(oligoSeqNo);
 			// process TC motif
 			if (options.motifTC) {
-				unsigned totalNumberOfMatches = processTCMotif(tfoMotifSet, *it, oligoSeqNo, reduceSet, options);
+				unsigned totalNumberOfMatches = processTCMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, reduceSet, options);
 				addCount(potential, totalNumberOfMatches, 'Y');
 			}
 			// process GA motif
 			if (options.motifGA) {
-				unsigned totalNumberOfMatches = processGAMotif(tfoMotifSet, *it, oligoSeqNo, reduceSet, options);
+				unsigned totalNumberOfMatches = processGAMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, reduceSet, options);
 				addCount(potential, totalNumberOfMatches, 'R');
 			}
 			// process GT motif
 			if (options.motifGT_p || options.motifGT_a) {
 				// for TFO search the parallel GT motifs need to be recorded only
-				unsigned totalNumberOfMatches = processGTMotif(tfoMotifSet, *it, oligoSeqNo, TRIPLEX_ORIENTATION_PARALLEL, reduceSet, options);
+				unsigned totalNumberOfMatches = processGTMotif(tmpTfoSets[oligoSeqNo], value(oligoSequences, oligoSeqNo), (unsigned) oligoSeqNo, TRIPLEX_ORIENTATION_PARALLEL, reduceSet, options);
 				addCount(potential, totalNumberOfMatches, 'M');
 			}
 			// get norm for sequence
-			setNorm(potential, length(*it), options);
-			// add potential to list
-			appendValue(potentials, potential);
-			// increase oligo id counter
-			++oligoSeqNo;
+			setNorm(potential, length(value(oligoSequences, oligoSeqNo)), options);
+			tmpPotentials[oligoSeqNo] = potential;
 		}
 		
+		// accumulate motifs and potentials in the order of the oligo sequences
+		_appendMotifSets(tfoMotifSet, tmpTfoSets);
+		for (unsigned oligoSeqNo=0; oligoSeqNo<tmpPotentials.size(); ++oligoSeqNo)
+			appendValue(potentials, tmpPotentials[oligoSeqNo]);
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Find TFOs (streaming mode)
+	//
+	// The single-stranded sequences are read in batches of bounded size. Each 
+	// batch is processed in parallel and its TFOs and summary entries are 
+	// written before the next batch is read, such that the memory requirement 
+	// does not depend on the size of the input. Sequences are numbered within 
+	// their batch, which only serves to look up their names for the output.
+	template <
+	typename TOligoSet, 
+	typename TMotifSet, 
+	typename TInput, 
+	typename TOutput
+	>
+	inline void _investigateTFOconsecutively(TInput &file, 
+											 TOutput &outputhandle, 
+											 Options &options)
+	{
+		typedef typename Value<TOligoSet>::Type					TOligo;
+		typedef TriplexPotential<TId>							TPotential;
+		typedef typename ::std::list<TPotential>				TPotentials;
+		
+		options.logFileHandle << _getTimeStamp() << " * Started detecting triplex-forming oligonucleotides (TFOs) in single-stranded sequences (streaming mode)" << ::std::endl;
+		
+		unsigned maxBatchSize = TFO_BATCH_SEQUENCES * options.processors;
+		unsigned counter = 1;
+		unsigned numSequences = 0;
+		unsigned numTfos = 0;
+		
+		while (!_streamEOF(file)){
+			TOligoSet				oligoSequences;
+			StringSet<CharString>	oligoNames;
+			TOligo					oligo;
+			CharString				id;
+			__int64					batchBases = 0;
+			
+			// the motifs refer to the sequences of the batch, hence the batch 
+			// is completely read before any motif is extracted
+			reserve(oligoSequences, maxBatchSize, Exact());
+			while (!_streamEOF(file) && length(oligoSequences) < maxBatchSize && batchBases < TFO_BATCH_BASES){
+				readShortID(file, id, Fasta());			// read Fasta id up to first whitespace
+				read(file, oligo, Fasta());				// read Fasta sequence
+				appendValue(oligoNames, id, Generous());
+				appendValue(oligoSequences, oligo);
+				batchBases += length(oligo);
+			}
+			numSequences += length(oligoSequences);
+			
+			if (options._debugLevel > 1 )
+				options.logFileHandle << _getTimeStamp() << "   ... Finished reading batch of " << length(oligoSequences) << " single-stranded sequences" << ::std::endl;
+			
+			SEQAN_PROTIMESTART(find_time);
+			TMotifSet	tfoMotifSet;
+			TPotentials	potentials;
+			_detectTfosAndPotentials(tfoMotifSet, potentials, oligoSequences, options);
+			options.timeFindTfos += SEQAN_PROTIMEDIFF(find_time);
+			numTfos += length(tfoMotifSet);
+			
+			dumpTfoMatches(outputhandle, tfoMotifSet, oligoNames, counter, options);
+			dumpSummary(potentials, oligoNames, options, TFO());
+		}
+		
+		options.logFileHandle << _getTimeStamp() << " * Finished detecting TFOs within " << ::std::setprecision(3)  << options.timeFindTfos << " seconds (" << numTfos << " TFOs detected in " << numSequences << " sequences)" << ::std::endl;
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Find TFOs (all sequences at once)
+	template <
+	typename TOligoSet, 
+	typename TMotifSet, 
+	typename TNames, 
+	typename TOutput
+	>
+	inline void _investigateTFOsimultaneous(TOligoSet &oligoSequences, 
+											TNames &oligoNames, 
+											TOutput &outputhandle, 
+											Options &options)
+	{
+		typedef TriplexPotential<TId>							TPotential;
+		typedef typename ::std::list<TPotential>				TPotentials;
+		
+		SEQAN_PROTIMESTART(find_time);
+		options.logFileHandle << _getTimeStamp() << " * Started detecting triplex-forming oligonucleotides (TFOs) in single-stranded sequences" << ::std::endl;
+		
+		TMotifSet tfoMotifSet;
+		TPotentials potentials;
+		_detectTfosAndPotentials(tfoMotifSet, potentials, oligoSequences, options);
+		
 		// any business with duplicates?
 		if (options.detectDuplicates != DETECT_DUPLICATES_OFF){
 			
@@ -1357,16 +1866,81 @@ namespace SEQAN_NAMESPACE_MAIN
 		}
 		
 		options.timeFindTfos += SEQAN_PROTIMEDIFF(find_time);	
-
+		
 		options.logFileHandle << _getTimeStamp() << " * Finished detecting TFOs within " << ::std::setprecision(3)  << options.timeFindTfos << " seconds (" << length(tfoMotifSet) << " TFOs detected)" << ::std::endl;
 		
+		options.logFileHandle << _getTimeStamp() << " * Started printing results " << ::std::endl;
+		dumpTfoMatches(outputhandle, tfoMotifSet, oligoNames, options);
+		dumpSummary(potentials, oligoNames, options, TFO());
+	}
+	
+	template <
+	typename TOligoSet, 
+	typename TMotifSet, 
+	typename TInput, 
+	typename TNames, 
+	typename TOutput
+	>
+	inline void _investigateTFO(TInput &file, 
+								bool streaming,
+								TOligoSet &oligoSequences, 
+								TNames &oligoNames, 
+								TOutput &outputhandle, 
+								Options &options)
+	{
+		if (streaming){
+			_investigateTFOconsecutively<TOligoSet, TMotifSet>(file, outputhandle, options);
+		} else {
+			_investigateTFOsimultaneous<TOligoSet, TMotifSet>(oligoSequences, oligoNames, outputhandle, options);
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// Main TFO mapper function
+	template <typename TOligoSet, typename TMotifSet>
+	int investigateTFO(Options &options
+	){
+		TOligoSet				oligoSequences;
+		StringSet<CharString>	oligoNames;				// tfs names, taken from the Fasta file
+		
+		// circumvent numerical obstacles
+	//	options.errorRate += 0.0000001;
+		
 		//////////////////////////////////////////////////////////////////////////////
-		// Step 4: output
+		// Step 1: read in TFO files
 		
-		options.logFileHandle << _getTimeStamp() << " * Started printing results " << ::std::endl;
-		// create output file
+		options.logFileHandle << _getTimeStamp() << " * Started reading single-stranded file:" << options.tfoFileNames[0] << ::std::endl;
 		
+		// the TFOs of a sequence only depend on other sequences when duplicates 
+		// are detected, otherwise Fasta input is streamed in batches
+		SequenceInputStream input;
+		input.open(toCString(options.tfoFileNames[0]), options.processors);
+		bool streaming = input.is_open() && options.detectDuplicates == DETECT_DUPLICATES_OFF && input.peek() == '>';
+		::std::istream &file = input;
+		
+		if (!streaming){
+			input.close();
+			if (!_loadOligos(oligoSequences, oligoNames, toCString(options.tfoFileNames[0]), options)) {
+				options.logFileHandle << "ERROR: Failed to load single-stranded sequence set" << ::std::endl;
+				cerr << "Failed to load single-stranded sequence set" << endl;
+				return TRIPLEX_TFOREAD_FAILED;
+			}
+			options.logFileHandle << _getTimeStamp() << " * Finished reading single-stranded file (" << length(oligoSequences) << " sequences read)" << ::std::endl;
+		}
 		
+		//////////////////////////////////////////////////////////////////////////////
+		// Step 2: process all sequences with the requested TFO motifs and output
+		
+		// create output file
+	#if SEQAN_HAS_ZLIB
+		if (options.bgzfThreads != 0){
+			BgzfOutputStream bgzfstream;
+			openOutputFile(bgzfstream, options);
+			printTFOHeader(bgzfstream, options);
+			_investigateTFO<TOligoSet, TMotifSet>(file, streaming, oligoSequences, oligoNames, bgzfstream, options);
+			closeOutputFile(bgzfstream, options);
+		} else {
+	#endif
 	#ifdef BOOST
 		if (options.compressOutput){
 			io::filtering_ostream filterstream;
@@ -1378,8 +1952,7 @@ namespace SEQAN_NAMESPACE_MAIN
 				filterstream.push(::std::cout);	
 			}
 			printTFOHeader(filterstream, options);
-			dumpTfoMatches(filterstream, tfoMotifSet, oligoNames, options);
-			dumpSummary(potentials, oligoNames, options, TFO());
+			_investigateTFO<TOligoSet, TMotifSet>(file, streaming, oligoSequences, oligoNames, filterstream, options);
 			closeOutputFile(filterstream, options);
 		} else {
 	#endif
@@ -1387,17 +1960,19 @@ namespace SEQAN_NAMESPACE_MAIN
 			if (!empty(options.output) && options.outputFormat!=2){
 				openOutputFile(filehandle, options);
 				printTFOHeader(filehandle, options);
-				dumpTfoMatches(filehandle, tfoMotifSet, oligoNames, options);
-				dumpSummary(potentials, oligoNames, options, TFO());
+				_investigateTFO<TOligoSet, TMotifSet>(file, streaming, oligoSequences, oligoNames, filehandle, options);
 				closeOutputFile(filehandle, options);
 			} else {
 				printTFOHeader(::std::cout, options);
-				dumpTfoMatches(::std::cout, tfoMotifSet, oligoNames, options);
-				dumpSummary(potentials, oligoNames, options, TFO());
+				_investigateTFO<TOligoSet, TMotifSet>(file, streaming, oligoSequences, oligoNames, ::std::cout, options);
 			}
 	#ifdef BOOST
 		}
 	#endif
+	#if SEQAN_HAS_ZLIB
+		}
+	#endif
+		input.close();
 		
 		options.logFileHandle << _getTimeStamp() << " * Finished outputing results " << ::std::endl;
 		return TRIPLEX_NORMAL_PROGAM_EXIT;
@@ -1419,6 +1994,11 @@ namespace SEQAN_NAMESPACE_MAIN
 		} else if (options.runmode == TRIPLEX_TFO_SEARCH){ // investigate TFO only
 			result = investigateTFO<TTriplexSet, TMotifSet>(options);
 		} else if (options.runmode == TRIPLEX_TRIPLEX_SEARCH){ // map TFO and TTSs
+#ifndef PLATFORM_WINDOWS
+			if (!empty(options.serverSocket))
+				result = serveTriplexes<TTriplexSet, TMotifSet>(options);
+			else
+#endif
 			result = mapTriplexes<TTriplexSet, TMotifSet>(options);
 		} else {
 			cerr << "Exiting ... invalid runmode" << endl;
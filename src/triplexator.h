@@ -51,6 +51,11 @@ namespace SEQAN_NAMESPACE_MAIN
 	// entry function to find TFO/TTS pairs
 	template <typename TOligoSet, typename TMotifSet> int mapTriplexes(Options &options);
 
+#ifndef PLATFORM_WINDOWS
+	// entry function to answer triplex searches sent to a socket
+	template <typename TOligoSet, typename TMotifSet> int serveTriplexes(Options &options);
+#endif
+
 	// entry function to find TTS 
 	template <typename TTargetSet> int investigateTTS(Options &options);
 
@@ -86,6 +91,34 @@ namespace SEQAN_NAMESPACE_MAIN
 					 TFile							&outputfile,
 					 Options						&options,
 					 TShape const					&shape);
+	
+	// search the duplex file with the given TFO pattern in the requested runtime mode
+	template <
+	typename TMotifSet,
+	typename TFile,
+	typename TPattern,
+	typename TId,
+	typename TTag>
+	int _startTriplexSearch(TMotifSet						&tfoMotifSet,
+							StringSet<CharString> const		&tfoNames,
+							TPattern const					&pattern,
+							TFile							&outputfile,
+							TId								duplexSeqNo,
+							TRegionMap const				&regions,
+							Options							&options,
+							TTag);
+	
+	// find TFO/TTS pairs for new or changed TFO sequences only
+	template <typename TMotifSet, typename TOligoSet>
+	int _mapTriplexesIncrementally(TOligoSet				&oligoSequences,
+								   StringSet<CharString>	&oligoNames,
+								   Options					&options);
+	
+	// output the per-TFO results of an incremental search
+	template <typename TFile>
+	bool _printTfoPartitions(TFile									&outputfile,
+							 ::std::vector< ::std::string > const	&keys,
+							 Options								&options);
 		
 	
 	// find TTSs (serial mode)
@@ -138,6 +171,29 @@ namespace SEQAN_NAMESPACE_MAIN
 								TOutput &outputhandle, 
 								Options &options);
 	
+	// find TFOs (streaming mode)
+	template <
+	typename TOligoSet, 
+	typename TMotifSet, 
+	typename TInput, 
+	typename TOutput
+	>
+	inline void _investigateTFOconsecutively(TInput &file, 
+											 TOutput &outputhandle, 
+											 Options &options);
+	
+	// find TFOs (all sequences at once)
+	template <
+	typename TOligoSet, 
+	typename TMotifSet, 
+	typename TNames, 
+	typename TOutput
+	>
+	inline void _investigateTFOsimultaneous(TOligoSet &oligoSequences, 
+											TNames &oligoNames, 
+											TOutput &outputhandle, 
+											Options &options);
+	
 	// main helper function
 	int _mainWithOptions(int argc, char const ** argv, Options &options);
 		
@@ -0,0 +1,137 @@
+// ==========================================================================
+//                                triplexator
+// ==========================================================================
+// Copyright (c) 2011,2012, Fabian Buske, UQ
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of Fabian Buske or the University of Queensland nor 
+//       the names of its contributors may be used to endorse or promote products 
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL KNUT REINERT OR THE FU BERLIN BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+// LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+// OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+//
+// ==========================================================================
+// Author: Fabian Buske <fbuske@uq.edu.au>
+// ==========================================================================
+
+// Converts the binary output of triplexator (-of 3) back into the 
+// tab-separated triplex format (-of 0). Error strings are not contained in 
+// the binary format and are reported as '-'.
+// ==========================================================================
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+#include <seqan/basic.h>
+#include <seqan/sequence.h>
+#include <seqan/misc/misc_cmdparser.h>
+
+#include "triplex_binary.h"
+
+using namespace std;
+using namespace seqan;
+
+namespace SEQAN_NAMESPACE_MAIN
+{
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// print all matches of a chunk in tab-separated triplex format
+	template <typename TFile>
+	void _printChunk(TFile							&filehandle,
+					 TriplexBinaryChunk const		&chunk,
+					 StringSet<CharString> const	&tfoNames
+					 ){
+		char _sep_ = '\t';
+		for (unsigned i=0; i<length(chunk); ++i){
+			double tsLength = (double) (chunk.dEnd[i] - chunk.dBegin[i]);
+			filehandle << tfoNames[chunk.tfoSeqNo[i]] << _sep_ << chunk.oBegin[i] << _sep_ << chunk.oEnd[i] << _sep_ ;
+			filehandle << chunk.duplexName << _sep_ << chunk.dBegin[i] << _sep_ << chunk.dEnd[i] << _sep_ ;
+			filehandle << chunk.mScore[i] << _sep_ << ::std::setprecision(2) << (1.0-chunk.mScore[i]/tsLength) << _sep_ ;
+			filehandle << '-' << _sep_ << chunk.motif[i] << _sep_ << chunk.strand[i] << _sep_ << chunk.orientation[i] << _sep_ << (chunk.guanines[i]/tsLength) << ::std::endl;
+		}
+	}
+	
+	//////////////////////////////////////////////////////////////////////////////
+	// convert binary file to tab-separated format
+	template <typename TFile>
+	int _convertBinaryFile(char const *fileName, TFile &filehandle)
+	{
+		::std::ifstream file;
+		file.open(fileName, ::std::ios_base::in | ::std::ios_base::binary);
+		if (!file.is_open()){
+			::std::cerr << "Failed to open input file: " << fileName << ::std::endl;
+			return 1;
+		}
+		
+		StringSet<CharString> tfoNames;
+		if (!readBinaryHeader(file, tfoNames)){
+			::std::cerr << "Not a binary triplex file: " << fileName << ::std::endl;
+			return 1;
+		}
+		
+		char _sep_ = '\t';
+		filehandle << "# Sequence-ID" << _sep_ << "TFO start" << _sep_ << "TFO end" << _sep_ << "Duplex-ID" << _sep_ << "TTS start" << _sep_ << "TTS end" << _sep_ << "Score" << _sep_ << "Error-rate" << _sep_ << "Errors" << _sep_ << "Motif" << _sep_ << "Strand" << _sep_ << "Orientation" << _sep_ << "Guanine-rate" << ::std::endl;
+		
+		TriplexBinaryChunk chunk;
+		while (readBinaryChunk(file, chunk))
+			_printChunk(filehandle, chunk, tfoNames);
+		
+		if (!file.eof()){
+			::std::cerr << "Truncated or corrupt binary triplex file: " << fileName << ::std::endl;
+			return 1;
+		}
+		return 0;
+	}
+	
+} // namespace SEQAN_NAMESPACE_MAIN 
+
+//////////////////////////////////////////////////////////////////////////////
+// Program entry point
+int main(int argc, char const ** argv)
+{
+	CommandLineParser parser;
+	addTitleLine(parser, "*** triplexator-view - convert binary triplexator output to tab-separated format ***");
+	addUsageLine(parser, "[OPTIONS] <BINARY FILE>");
+	addOption(parser, addArgumentText(CommandLineOption("o", "output",	"output filename (default standard out)", OptionType::String), "FILE"));
+	requiredArguments(parser, 1);
+	
+	if (!parse(parser, argc, argv))
+		return 1;
+	if (isSetLong(parser, "help"))
+		return 0;
+	
+	CharString output;
+	getOptionValueLong(parser, "output", output);
+	
+	if (empty(output))
+		return _convertBinaryFile(toCString(getArgumentValue(parser, 0)), ::std::cout);
+	
+	::std::ofstream filehandle;
+	filehandle.open(toCString(output), ::std::ios_base::out | ::std::ios_base::trunc);
+	if (!filehandle.is_open()){
+		::std::cerr << "Failed to open output file: " << output << ::std::endl;
+		return 1;
+	}
+	int ret = _convertBinaryFile(toCString(getArgumentValue(parser, 0)), filehandle);
+	filehandle.close();
+	return ret;
+}